@@ -32,7 +32,11 @@
 * limits memory fragmentation.
 *
 * This implementation is based on heap_4.c and add the function pvPortRealloc()
-* to the original implementation.
+* to the original implementation. When configUSE_HEAP_POOLS is set, small
+* allocations are first served by the size-class pools of heap_pools.c, whose
+* memory is taken from configTOTAL_HEAP_SIZE. When configUSE_HEAP_ARENA is set,
+* the allocations of the task that started an arena are served from it first
+* (see heap_arena.c).
 *
 * See heap_1.c, heap_2.c and heap_3.c for alternative implementations, and the
 * memory management pages of http://www.FreeRTOS.org for more information.
@@ -50,6 +54,22 @@ task.h is included from an application file. */
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+#if( configUSE_HEAP_POOLS == 1 )
+ #include "heap_pools.h"
+ #define heapSIZE	( configTOTAL_HEAP_SIZE - heapPOOLS_TOTAL_SIZE )
+#else
+ #define heapSIZE	configTOTAL_HEAP_SIZE
+#endif
+
+#if( configUSE_HEAP_ARENA == 1 )
+ #include "heap_arena.h"
+#endif
+
+#include "heap_stats.h"
+
+/* Number of tasks whose allocations are counted. */
+#define heapTASK_ALLOCATION_COUNTERS	10
+
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
  #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
@@ -64,9 +84,9 @@ task.h is included from an application file. */
 #if( configAPPLICATION_ALLOCATED_HEAP == 1 )
 /* The application writer has already defined the array used for the RTOS
 heap - probably so it can be placed in a special segment or address. */
-extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+extern uint8_t ucHeap[ heapSIZE ];
 #else
-static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+static uint8_t ucHeap[ heapSIZE ];
 #endif /* configAPPLICATION_ALLOCATED_HEAP */
 
 /* Define the linked list structure.  This is used to link free blocks in order
@@ -93,6 +113,22 @@ static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
 */
 static void prvHeapInit( void );
 
+/*
+* First-fit allocation in ucHeap.
+*/
+static void *prvHeapMalloc( size_t xWantedSize );
+static void prvHeapFree( void *pv );
+
+/*
+* Free bytes in ucHeap and in the pools.
+*/
+static size_t prvTotalFreeBytes( void );
+
+/*
+* Counts an allocation for the calling task.
+*/
+static void prvCountAllocation( void );
+
 /*-----------------------------------------------------------*/
 
 /* The size of the structure placed at the beginning of each allocated memory
@@ -107,6 +143,14 @@ fragmentation. */
 static size_t xFreeBytesRemaining = 0U;
 static size_t xMinimumEverFreeBytesRemaining = 0U;
 
+/* Allocations made by each task. */
+typedef struct
+{
+ TaskHandle_t xTask;
+ uint32_t ulAllocations;
+} TaskAllocations_t;
+static TaskAllocations_t xTaskAllocations[ heapTASK_ALLOCATION_COUNTERS ];
+
 /* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
 member of an BlockLink_t structure is set then the block belongs to the
 application.  When the bit is free the block is still part of the free heap
@@ -116,6 +160,86 @@ static size_t xBlockAllocatedBit = 0;
 /*-----------------------------------------------------------*/
 
 void *pvPortMalloc( size_t xWantedSize )
+{
+ void *pvReturn = NULL;
+
+#if( ( configUSE_HEAP_POOLS == 1 ) || ( configUSE_HEAP_ARENA == 1 ) )
+ vTaskSuspendAll();
+ {
+   if( pxEnd == NULL )
+   {
+     prvHeapInit();
+   }
+
+#if( configUSE_HEAP_ARENA == 1 )
+   pvReturn = pvHeapArenaMalloc( xWantedSize );
+#endif
+
+#if( configUSE_HEAP_POOLS == 1 )
+   if( pvReturn == NULL )
+   {
+     pvReturn = pvHeapPoolsMalloc( xWantedSize );
+     if( ( pvReturn != NULL ) && ( prvTotalFreeBytes() < xMinimumEverFreeBytesRemaining ) )
+     {
+       xMinimumEverFreeBytesRemaining = prvTotalFreeBytes();
+     }
+   }
+#endif
+ }
+ ( void ) xTaskResumeAll();
+#endif
+
+ if( pvReturn == NULL )
+ {
+   pvReturn = prvHeapMalloc( xWantedSize );
+ }
+
+ if( pvReturn != NULL )
+ {
+   prvCountAllocation();
+ }
+ return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+#if( ( configUSE_HEAP_POOLS == 1 ) || ( configUSE_HEAP_ARENA == 1 ) )
+ int xFreed = 0;
+ void *pvArenaBlock = NULL;
+
+ vTaskSuspendAll();
+ {
+#if( configUSE_HEAP_ARENA == 1 )
+   xFreed = xHeapArenaFree( pv, &pvArenaBlock );
+#endif
+
+#if( configUSE_HEAP_POOLS == 1 )
+   if( xFreed == 0 )
+   {
+     xFreed = xHeapPoolsFree( pv );
+   }
+#endif
+ }
+ ( void ) xTaskResumeAll();
+
+ if( pvArenaBlock != NULL )
+ {
+   /* That was the last allocation of an arena that has ended. */
+   vPortFree( pvArenaBlock );
+ }
+
+ if( xFreed != 0 )
+ {
+   return;
+ }
+#endif
+
+ prvHeapFree( pv );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvHeapMalloc( size_t xWantedSize )
 {
  BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
  void *pvReturn = NULL;
@@ -220,9 +344,9 @@ void *pvPortMalloc( size_t xWantedSize )
 
          xFreeBytesRemaining -= pxBlock->xBlockSize;
 
-         if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+         if( prvTotalFreeBytes() < xMinimumEverFreeBytesRemaining )
          {
-           xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+           xMinimumEverFreeBytesRemaining = prvTotalFreeBytes();
          }
          else
          {
@@ -272,7 +396,7 @@ void *pvPortMalloc( size_t xWantedSize )
 }
 /*-----------------------------------------------------------*/
 
-void vPortFree( void *pv )
+static void prvHeapFree( void *pv )
 {
  uint8_t *puc = ( uint8_t * ) pv;
  BlockLink_t *pxLink;
@@ -320,9 +444,19 @@ void vPortFree( void *pv )
 }
 /*-----------------------------------------------------------*/
 
-size_t xPortGetFreeHeapSize( void )
+static size_t prvTotalFreeBytes( void )
 {
+#if( configUSE_HEAP_POOLS == 1 )
+ return xFreeBytesRemaining + xHeapPoolsFreeBytes();
+#else
  return xFreeBytesRemaining;
+#endif
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+ return prvTotalFreeBytes();
 }
 /*-----------------------------------------------------------*/
 
@@ -332,6 +466,133 @@ size_t xPortGetMinimumEverFreeHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+static void prvCountAllocation( void )
+{
+ TaskHandle_t xTask = NULL;
+ size_t i;
+
+ if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+ {
+   xTask = xTaskGetCurrentTaskHandle();
+ }
+
+ vTaskSuspendAll();
+ {
+   for( i = 0; i < heapTASK_ALLOCATION_COUNTERS; i++ )
+   {
+     if( ( xTaskAllocations[ i ].xTask == xTask ) || ( xTaskAllocations[ i ].ulAllocations == 0 ) )
+     {
+       xTaskAllocations[ i ].xTask = xTask;
+       xTaskAllocations[ i ].ulAllocations++;
+       break;
+     }
+   }
+ }
+ ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetTaskAllocationCount( TaskHandle_t xTask )
+{
+ size_t i;
+
+ for( i = 0; i < heapTASK_ALLOCATION_COUNTERS; i++ )
+ {
+   if( ( xTaskAllocations[ i ].xTask == xTask ) && ( xTaskAllocations[ i ].ulAllocations != 0 ) )
+   {
+     return xTaskAllocations[ i ].ulAllocations;
+   }
+ }
+ return 0;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetLargestFreeBlockSize( void )
+{
+ BlockLink_t *pxBlock;
+ size_t xLargest = 0;
+
+ vTaskSuspendAll();
+ {
+   if( pxEnd != NULL )
+   {
+     for( pxBlock = xStart.pxNextFreeBlock; pxBlock != pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+     {
+       if( pxBlock->xBlockSize > xLargest )
+       {
+         xLargest = pxBlock->xBlockSize;
+       }
+     }
+   }
+ }
+ ( void ) xTaskResumeAll();
+
+ return xLargest;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetNumberOfFreeBlocks( void )
+{
+ BlockLink_t *pxBlock;
+ size_t xCount = 0;
+
+ vTaskSuspendAll();
+ {
+   if( pxEnd != NULL )
+   {
+     for( pxBlock = xStart.pxNextFreeBlock; pxBlock != pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+     {
+       xCount++;
+     }
+   }
+ }
+ ( void ) xTaskResumeAll();
+
+ return xCount;
+}
+/*-----------------------------------------------------------*/
+
+void vPortShrink( void *pv, size_t xWantedSize )
+{
+ BlockLink_t *pxLink, *pxNewBlockLink;
+ size_t xBlockSize;
+
+ /* Only blocks of the first-fit heap can be shrunk. */
+ if( ( ( uint8_t * ) pv < ucHeap ) || ( ( uint8_t * ) pv >= ucHeap + heapSIZE ) )
+ {
+   return;
+ }
+
+ xWantedSize += xHeapStructSize;
+ if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+ {
+   xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+ }
+
+ pxLink = ( void * ) ( ( ( uint8_t * ) pv ) - xHeapStructSize );
+ configASSERT( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 );
+
+ vTaskSuspendAll();
+ {
+   xBlockSize = pxLink->xBlockSize & ~xBlockAllocatedBit;
+
+   /* Give the end of the block back to the heap if it is big enough to be a
+   block on its own. */
+   if( ( xBlockSize > xWantedSize ) && ( ( xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE ) )
+   {
+     pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxLink ) + xWantedSize );
+     pxNewBlockLink->xBlockSize = xBlockSize - xWantedSize;
+     pxLink->xBlockSize = xWantedSize | xBlockAllocatedBit;
+
+     xFreeBytesRemaining += pxNewBlockLink->xBlockSize;
+     traceFREE( pxNewBlockLink, pxNewBlockLink->xBlockSize );
+     prvInsertBlockIntoFreeList( pxNewBlockLink );
+   }
+ }
+ ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
 void vPortInitialiseBlocks( void )
 {
  /* This just exists to keep the linker quiet. */
@@ -343,7 +604,7 @@ static void prvHeapInit( void )
  BlockLink_t *pxFirstFreeBlock;
  uint8_t *pucAlignedHeap;
  size_t uxAddress;
- size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+ size_t xTotalHeapSize = heapSIZE;
 
  /* Ensure the heap starts on a correctly aligned boundary. */
  uxAddress = ( size_t ) ucHeap;
@@ -378,8 +639,8 @@ static void prvHeapInit( void )
  pxFirstFreeBlock->pxNextFreeBlock = pxEnd;
 
  /* Only one block exists - and it covers the entire usable heap space. */
- xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
  xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+ xMinimumEverFreeBytesRemaining = prvTotalFreeBytes();
 
  /* Work out the position of the top bit in a size_t variable. */
  xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
@@ -465,6 +726,36 @@ void* pvPortRealloc(void* pv, size_t xWantedSize) {
    return pvPortMalloc(xWantedSize);
  }
 
+#if (configUSE_HEAP_ARENA == 1)
+ // The size of arena allocations is unknown, copy up to the end of the used part of the arena
+ block_size = xHeapArenaReadableSize(pv);
+ if (block_size != 0) {
+   pvReturn = pvPortMalloc(xWantedSize);
+   if (pvReturn != NULL) {
+     memcpy(pvReturn, pv, (block_size < xWantedSize) ? block_size : xWantedSize);
+     vPortFree(pv);
+   }
+   return pvReturn;
+ }
+#endif
+
+#if (configUSE_HEAP_POOLS == 1)
+ block_size = xHeapPoolsBlockSize(pv);
+ if (block_size != 0) {
+   if (xWantedSize <= block_size) {
+     // The block is already big enough
+     return pv;
+   }
+
+   pvReturn = pvPortMalloc(xWantedSize);
+   if (pvReturn != NULL) {
+     memcpy(pvReturn, pv, block_size);
+     vPortFree(pv);
+   }
+   return pvReturn;
+ }
+#endif
+
  // The memory being freed will have an BlockLink_t structure immediately before it.
  puc -= xHeapStructSize;
 
@@ -0,0 +1,188 @@
+#include "heap_arena.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Number of arenas that can exist at the same time: the current one, and the
+ * ones that ended while some of their allocations were still in use. */
+#define heapARENA_COUNT 3
+
+typedef struct {
+  uint8_t* pucStart;
+  uint8_t* pucEnd;
+  uint8_t* pucTop;
+  uint8_t* pucLast;
+  uint32_t ulLive;
+} Arena_t;
+
+/* Implemented in heap_4_infinitime.c */
+void vPortShrink(void* pv, size_t xWantedSize);
+
+static Arena_t xArenas[heapARENA_COUNT];
+static Arena_t* pxCurrent = NULL;
+static TaskHandle_t xArenaOwner = NULL;
+static UBaseType_t uxSuspended = 0;
+static HeapArenaStats_t xStats = {0};
+
+static size_t prvAlign(size_t xSize) {
+  return (xSize + portBYTE_ALIGNMENT_MASK) & ~((size_t) portBYTE_ALIGNMENT_MASK);
+}
+
+static Arena_t* prvFindArena(const void* pv) {
+  const uint8_t* puc = (const uint8_t*) pv;
+  for (size_t i = 0; i < heapARENA_COUNT; i++) {
+    if (puc >= xArenas[i].pucStart && puc < xArenas[i].pucTop) {
+      return &xArenas[i];
+    }
+  }
+  return NULL;
+}
+
+int xHeapArenaBegin(size_t xSize) {
+  Arena_t* pxArena = NULL;
+  for (size_t i = 0; i < heapARENA_COUNT && pxArena == NULL; i++) {
+    if (xArenas[i].pucStart == NULL) {
+      pxArena = &xArenas[i];
+    }
+  }
+  if (pxCurrent != NULL || pxArena == NULL) {
+    return 0;
+  }
+
+  // The arena itself is a block of the heap
+  xSize = prvAlign(xSize);
+  uint8_t* pucBlock = pvPortMalloc(xSize);
+  if (pucBlock == NULL) {
+    return 0;
+  }
+
+  vTaskSuspendAll();
+  {
+    pxArena->pucStart = pucBlock;
+    pxArena->pucEnd = pucBlock + xSize;
+    pxArena->pucTop = pucBlock;
+    pxArena->pucLast = NULL;
+    pxArena->ulLive = 0;
+    pxCurrent = pxArena;
+    xArenaOwner = xTaskGetCurrentTaskHandle();
+    uxSuspended = 0;
+    xStats.ulSize = xSize;
+    xStats.ulUsed = 0;
+    xStats.ulLive = 0;
+  }
+  (void) xTaskResumeAll();
+  return 1;
+}
+
+void vHeapArenaEnd(void) {
+  void* pvRelease = NULL;
+  Arena_t* pxPinned = NULL;
+
+  vTaskSuspendAll();
+  {
+    if (pxCurrent != NULL) {
+      if (pxCurrent->ulLive == 0) {
+        pvRelease = pxCurrent->pucStart;
+        *pxCurrent = (Arena_t) {0};
+        xStats.ulReleases++;
+      } else {
+        // No more allocations will be carved from it: the unused end can go back to the heap
+        pxCurrent->pucEnd = pxCurrent->pucTop;
+        pxPinned = pxCurrent;
+        xStats.ulPinned++;
+      }
+      pxCurrent = NULL;
+      xArenaOwner = NULL;
+      xStats.ulSize = 0;
+      xStats.ulUsed = 0;
+      xStats.ulLive = 0;
+    }
+  }
+  (void) xTaskResumeAll();
+
+  if (pvRelease != NULL) {
+    vPortFree(pvRelease);
+  }
+  if (pxPinned != NULL) {
+    vPortShrink(pxPinned->pucStart, (size_t) (pxPinned->pucEnd - pxPinned->pucStart));
+  }
+}
+
+void vHeapArenaSuspend(void) {
+  uxSuspended++;
+}
+
+void vHeapArenaResume(void) {
+  configASSERT(uxSuspended > 0);
+  uxSuspended--;
+}
+
+void vHeapArenaGetStats(HeapArenaStats_t* pxStats) {
+  vTaskSuspendAll();
+  {
+    *pxStats = xStats;
+  }
+  (void) xTaskResumeAll();
+}
+
+void* pvHeapArenaMalloc(size_t xWantedSize) {
+  if (pxCurrent == NULL || uxSuspended > 0 || xWantedSize == 0 || xTaskGetCurrentTaskHandle() != xArenaOwner) {
+    return NULL;
+  }
+
+  const size_t xSize = prvAlign(xWantedSize);
+  if (xSize > (size_t) (pxCurrent->pucEnd - pxCurrent->pucTop)) {
+    xStats.ulOverflows++;
+    return NULL;
+  }
+
+  pxCurrent->pucLast = pxCurrent->pucTop;
+  pxCurrent->pucTop += xSize;
+  pxCurrent->ulLive++;
+  xStats.ulLive = pxCurrent->ulLive;
+  xStats.ulUsed = (uint32_t) (pxCurrent->pucTop - pxCurrent->pucStart);
+  if (xStats.ulUsed > xStats.ulPeak) {
+    xStats.ulPeak = xStats.ulUsed;
+  }
+  return pxCurrent->pucLast;
+}
+
+int xHeapArenaFree(void* pv, void** ppvRelease) {
+  *ppvRelease = NULL;
+  Arena_t* pxArena = prvFindArena(pv);
+  if (pxArena == NULL) {
+    return 0;
+  }
+
+  configASSERT(pxArena->ulLive > 0);
+  pxArena->ulLive--;
+  if ((uint8_t*) pv == pxArena->pucLast) {
+    // Releasing the last allocation gives its memory back to the arena
+    pxArena->pucTop = pxArena->pucLast;
+    pxArena->pucLast = NULL;
+  }
+  if (pxArena->ulLive == 0) {
+    if (pxArena != pxCurrent) {
+      // The arena has ended while some of its allocations were still in use
+      *ppvRelease = pxArena->pucStart;
+      *pxArena = (Arena_t) {0};
+      xStats.ulReleases++;
+    } else {
+      pxArena->pucTop = pxArena->pucStart;
+      pxArena->pucLast = NULL;
+    }
+  }
+
+  if (pxArena == pxCurrent) {
+    xStats.ulLive = pxArena->ulLive;
+    xStats.ulUsed = (uint32_t) (pxArena->pucTop - pxArena->pucStart);
+  }
+  return 1;
+}
+
+size_t xHeapArenaReadableSize(const void* pv) {
+  const Arena_t* pxArena = prvFindArena(pv);
+  if (pxArena == NULL) {
+    return 0;
+  }
+  return (size_t) (pxArena->pucTop - (const uint8_t*) pv);
+}
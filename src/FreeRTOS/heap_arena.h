@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+ * Scoped bump arena placed in front of heap_4_infinitime.c.
+ *
+ * Between xHeapArenaBegin() and vHeapArenaEnd(), the allocations made by the
+ * task that started the arena are carved sequentially from a single block of
+ * the heap. Releasing one of these allocations only decrements a counter, and
+ * the whole block goes back to the heap in one operation once the arena has
+ * ended and all its allocations have been released. Allocations that do not
+ * fit anymore in the arena, and allocations made by other tasks, use the
+ * pools and the heap as usual.
+ *
+ * Allocations that must outlive the arena (objects shared between screens,
+ * caches...) have to be made between vHeapArenaSuspend() and
+ * vHeapArenaResume(): a single one of them would keep the whole arena from
+ * being released.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint32_t ulSize;         /* Size of the current arena, 0 if there is none */
+  uint32_t ulUsed;         /* Number of bytes carved from the current arena */
+  uint32_t ulLive;         /* Number of allocations of the current arena that are not released yet */
+  uint32_t ulPeak;         /* Maximum number of bytes ever used in an arena */
+  uint32_t ulReleases;     /* Number of arenas released at once */
+  uint32_t ulPinned;       /* Number of arenas that still had allocations when they ended */
+  uint32_t ulOverflows;    /* Number of allocations sent to the heap because the arena was full */
+} HeapArenaStats_t;
+
+/* Starts an arena of xSize bytes for the calling task. Returns 0 if an arena is
+ * still in use or if there is not enough memory for it. */
+int xHeapArenaBegin(size_t xSize);
+
+/* Stops carving allocations from the arena. The arena is released as soon as
+ * all its allocations are released. */
+void vHeapArenaEnd(void);
+
+/* Opt-out for long-lived allocations, can be nested */
+void vHeapArenaSuspend(void);
+void vHeapArenaResume(void);
+
+void vHeapArenaGetStats(HeapArenaStats_t* pxStats);
+
+/* Called by pvPortMalloc()/vPortFree()/pvPortRealloc() with the scheduler
+ * suspended, they must not be called directly. */
+void* pvHeapArenaMalloc(size_t xWantedSize);
+
+/* Returns 1 if pv belongs to the arena, 0 otherwise. *ppvRelease is set to the
+ * block of the arena when it must be returned to the heap. */
+int xHeapArenaFree(void* pv, void** ppvRelease);
+
+/* Returns the number of bytes that can be read from pv if it belongs to the arena, 0 otherwise */
+size_t xHeapArenaReadableSize(const void* pv);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,138 @@
+#include "heap_pools.h"
+#include "FreeRTOS.h"
+
+typedef struct A_POOL_BLOCK {
+  struct A_POOL_BLOCK* pxNextFreeBlock;
+} PoolBlock_t;
+
+typedef struct {
+  uint8_t* pucStart;
+  uint8_t* pucEnd;
+  PoolBlock_t* pxFreeList;
+  HeapPoolStats_t xStats;
+} Pool_t;
+
+typedef struct {
+  uint16_t usBlockSize;
+  uint16_t usBlockCount;
+} PoolConfig_t;
+
+static const PoolConfig_t xPoolConfigs[heapPOOLS_CLASS_COUNT] = heapPOOLS_CLASSES;
+
+static uint8_t ucPoolsMemory[heapPOOLS_TOTAL_SIZE] __attribute__((aligned(portBYTE_ALIGNMENT)));
+static Pool_t xPools[heapPOOLS_CLASS_COUNT];
+static size_t xFreeBytes = 0U;
+static int xInitialized = 0;
+
+static void prvPoolsInit(void) {
+  uint8_t* pucBlock = ucPoolsMemory;
+  for (size_t i = 0; i < heapPOOLS_CLASS_COUNT; i++) {
+    Pool_t* pxPool = &xPools[i];
+    const PoolConfig_t* pxConfig = &xPoolConfigs[i];
+    configASSERT((pxConfig->usBlockSize & portBYTE_ALIGNMENT_MASK) == 0);
+    configASSERT(i == 0 || pxConfig->usBlockSize > xPoolConfigs[i - 1].usBlockSize);
+
+    pxPool->pucStart = pucBlock;
+    pxPool->pxFreeList = NULL;
+    // Build the free list so that blocks are allocated from the lowest address
+    for (uint16_t j = pxConfig->usBlockCount; j > 0; j--) {
+      PoolBlock_t* pxBlock = (PoolBlock_t*) (pucBlock + (size_t) (j - 1) * pxConfig->usBlockSize);
+      pxBlock->pxNextFreeBlock = pxPool->pxFreeList;
+      pxPool->pxFreeList = pxBlock;
+    }
+    pucBlock += (size_t) pxConfig->usBlockCount * pxConfig->usBlockSize;
+    pxPool->pucEnd = pucBlock;
+
+    pxPool->xStats.usBlockSize = pxConfig->usBlockSize;
+    pxPool->xStats.usBlockCount = pxConfig->usBlockCount;
+    xFreeBytes += (size_t) pxConfig->usBlockCount * pxConfig->usBlockSize;
+  }
+  configASSERT(pucBlock == ucPoolsMemory + heapPOOLS_TOTAL_SIZE);
+  xInitialized = 1;
+}
+
+static Pool_t* prvFindPool(const void* pv) {
+  const uint8_t* puc = (const uint8_t*) pv;
+  if (puc < ucPoolsMemory || puc >= ucPoolsMemory + heapPOOLS_TOTAL_SIZE) {
+    return NULL;
+  }
+  for (size_t i = 0; i < heapPOOLS_CLASS_COUNT; i++) {
+    if (puc < xPools[i].pucEnd) {
+      return &xPools[i];
+    }
+  }
+  return NULL;
+}
+
+void* pvHeapPoolsMalloc(size_t xWantedSize) {
+  if (xWantedSize == 0) {
+    return NULL;
+  }
+  if (!xInitialized) {
+    prvPoolsInit();
+  }
+
+  for (size_t i = 0; i < heapPOOLS_CLASS_COUNT; i++) {
+    Pool_t* pxPool = &xPools[i];
+    if (xWantedSize > pxPool->xStats.usBlockSize) {
+      continue;
+    }
+
+    PoolBlock_t* pxBlock = pxPool->pxFreeList;
+    if (pxBlock == NULL) {
+      // Do not use a bigger class: it would starve the objects it is sized for
+      pxPool->xStats.ulOverflows++;
+      return NULL;
+    }
+    pxPool->pxFreeList = pxBlock->pxNextFreeBlock;
+    pxPool->xStats.usUsed++;
+    if (pxPool->xStats.usUsed > pxPool->xStats.usPeak) {
+      pxPool->xStats.usPeak = pxPool->xStats.usUsed;
+    }
+    pxPool->xStats.ulAllocations++;
+    xFreeBytes -= pxPool->xStats.usBlockSize;
+    return pxBlock;
+  }
+  return NULL;
+}
+
+size_t xHeapPoolsBlockSize(const void* pv) {
+  const Pool_t* pxPool = prvFindPool(pv);
+  if (pxPool == NULL) {
+    return 0;
+  }
+  return pxPool->xStats.usBlockSize;
+}
+
+int xHeapPoolsFree(void* pv) {
+  Pool_t* pxPool = prvFindPool(pv);
+  if (pxPool == NULL) {
+    return 0;
+  }
+  configASSERT(((size_t) ((uint8_t*) pv - pxPool->pucStart) % pxPool->xStats.usBlockSize) == 0);
+  configASSERT(pxPool->xStats.usUsed > 0);
+
+  PoolBlock_t* pxBlock = (PoolBlock_t*) pv;
+  pxBlock->pxNextFreeBlock = pxPool->pxFreeList;
+  pxPool->pxFreeList = pxBlock;
+  pxPool->xStats.usUsed--;
+  xFreeBytes += pxPool->xStats.usBlockSize;
+  return 1;
+}
+
+size_t xHeapPoolsFreeBytes(void) {
+  if (!xInitialized) {
+    return heapPOOLS_TOTAL_SIZE;
+  }
+  return xFreeBytes;
+}
+
+void vHeapPoolsGetStats(HeapPoolStats_t* pxStats) {
+  for (size_t i = 0; i < heapPOOLS_CLASS_COUNT; i++) {
+    if (xInitialized) {
+      pxStats[i] = xPools[i].xStats;
+    } else {
+      pxStats[i] = (HeapPoolStats_t) {xPoolConfigs[i].usBlockSize, xPoolConfigs[i].usBlockCount, 0, 0, 0, 0};
+    }
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+/*
+ * Size-class pools placed in front of heap_4_infinitime.c.
+ *
+ * Small allocations (LVGL objects, styles, tasks, small C++ objects) are
+ * served in O(1) from fixed size blocks grouped by size class. Allocations
+ * that are larger than the biggest class, or that do not fit anymore in their
+ * pool, fall back to the first-fit heap. This keeps the many short-lived small
+ * blocks allocated when apps are opened and closed from fragmenting the heap.
+ *
+ * These functions are called by pvPortMalloc()/vPortFree() with the scheduler
+ * suspended, they must not be called directly.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Block size and block count of each size class. LVGL adds a 4 bytes header to its allocations. */
+#define heapPOOLS_CLASSES     {{16, 48}, {32, 64}, {48, 32}, {64, 48}}
+#define heapPOOLS_CLASS_COUNT 4
+#define heapPOOLS_TOTAL_SIZE  (16 * 48 + 32 * 64 + 48 * 32 + 64 * 48)
+
+typedef struct {
+  uint16_t usBlockSize;   /* Size of the blocks of the pool, in bytes */
+  uint16_t usBlockCount;  /* Number of blocks in the pool */
+  uint16_t usUsed;        /* Number of blocks currently allocated */
+  uint16_t usPeak;        /* Maximum number of blocks allocated at the same time */
+  uint32_t ulAllocations; /* Number of allocations served by the pool */
+  uint32_t ulOverflows;   /* Number of allocations sent to the heap because the pool was full */
+} HeapPoolStats_t;
+
+void* pvHeapPoolsMalloc(size_t xWantedSize);
+
+/* Returns the usable size of the block if pv belongs to a pool, 0 otherwise */
+size_t xHeapPoolsBlockSize(const void* pv);
+
+/* Returns 1 and releases the block if pv belongs to a pool, returns 0 otherwise */
+int xHeapPoolsFree(void* pv);
+
+size_t xHeapPoolsFreeBytes(void);
+
+/* Copies the statistics of the size classes, ordered by block size */
+void vHeapPoolsGetStats(HeapPoolStats_t* pxStats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+/*
+ * Statistics of the heap implemented in heap_4_infinitime.c, in addition to
+ * xPortGetFreeHeapSize() and xPortGetMinimumEverFreeHeapSize().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fragmentation of the first-fit heap */
+size_t xPortGetLargestFreeBlockSize(void);
+size_t xPortGetNumberOfFreeBlocks(void);
+
+/* Number of allocations made by a task since boot. Allocations made before the
+ * scheduler is started are attributed to the NULL task. */
+uint32_t ulPortGetTaskAllocationCount(TaskHandle_t xTask);
+
+#ifdef __cplusplus
+}
+#endif
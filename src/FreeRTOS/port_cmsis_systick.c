@@ -109,6 +109,53 @@ void vPortSetupTimerInterrupt( void )
 #include "nrf_rtc.h"
 #include "nrf_drv_clock.h"
 
+#if configGENERATE_RUN_TIME_STATS == 1
+#include "runtime_stats.h"
+
+static uint32_t ulRunTimeCounterLast = 0;
+static uint32_t ulRunTimeCounterHigh = 0;
+static uint32_t ulSleepCounts[ portSLEEP_HISTOGRAM_BINS ];
+static uint32_t ulSleepTicks[ portSLEEP_HISTOGRAM_BINS ];
+
+uint32_t ulPortGetRunTimeCounterValue( void )
+{
+    /* Called at each context switch, much more often than the 24 bits counter
+     * wraps around. */
+    uint32_t isrstate = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t counter = nrf_rtc_counter_get(portNRF_RTC_REG);
+    if (counter < ulRunTimeCounterLast)
+    {
+        ulRunTimeCounterHigh += portNRF_RTC_MAXTICKS + 1U;
+    }
+    ulRunTimeCounterLast = counter;
+    uint32_t value = ulRunTimeCounterHigh + counter;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( isrstate );
+    return value;
+}
+
+static void prvRecordSleep( TickType_t ticks )
+{
+    uint32_t bin = 0;
+    while ((bin < portSLEEP_HISTOGRAM_BINS - 1) && (ticks >= (1U << (2 * (bin + 1)))))
+    {
+        bin++;
+    }
+    ulSleepCounts[bin]++;
+    ulSleepTicks[bin] += ticks;
+}
+
+void vPortGetSleepHistogram( uint32_t * pulCounts, uint32_t * pulTicks )
+{
+    uint32_t isrstate = portSET_INTERRUPT_MASK_FROM_ISR();
+    for (uint32_t i = 0; i < portSLEEP_HISTOGRAM_BINS; i++)
+    {
+        pulCounts[i] = ulSleepCounts[i];
+        pulTicks[i] = ulSleepTicks[i];
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( isrstate );
+}
+#endif
+
 /*-----------------------------------------------------------*/
 
 void xPortSysTickHandler( void )
@@ -295,6 +342,10 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
             {
                 vTaskStepTick(diff);
             }
+
+#if configGENERATE_RUN_TIME_STATS == 1
+            prvRecordSleep(diff);
+#endif
         }
     }
 #ifdef SOFTDEVICE_PRESENT
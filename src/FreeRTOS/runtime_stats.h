@@ -0,0 +1,29 @@
+#pragma once
+
+/*
+ * Run time statistics of the RTC port (port_cmsis_systick.c).
+ *
+ * The run time counter is the counter of the RTC that generates the tick,
+ * extended to 32 bits: it runs at configTICK_RATE_HZ, also while the MCU
+ * sleeps in tickless idle.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of bins of the sleep histogram. Bin i counts the sleeps shorter than
+ * 2^(2 * (i + 1)) ticks, the last bin counts all the longer ones. */
+#define portSLEEP_HISTOGRAM_BINS 7
+
+uint32_t ulPortGetRunTimeCounterValue(void);
+
+/* Copies the number of tickless idle sleeps, and the number of ticks spent
+ * sleeping, of each bin. */
+void vPortGetSleepHistogram(uint32_t* pulCounts, uint32_t* pulTicks);
+
+#ifdef __cplusplus
+}
+#endif
@@ -63,6 +63,8 @@
 #define configMAX_PRIORITIES                    (3)
 #define configMINIMAL_STACK_SIZE                (120)
 #define configTOTAL_HEAP_SIZE                   (1024 * 40)
+#define configUSE_HEAP_POOLS                    1 /* Size-class pools in front of the heap, see FreeRTOS/heap_pools.h */
+#define configUSE_HEAP_ARENA                    1 /* Scoped bump arena in front of the heap, see FreeRTOS/heap_arena.h */
 #define configMAX_TASK_NAME_LEN                 (4)
 #define configUSE_16_BIT_TICKS                  0
 #define configIDLE_SHOULD_YIELD                 1
@@ -83,7 +85,10 @@
 #define configUSE_MALLOC_FAILED_HOOK   1
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS        0
+#define configGENERATE_RUN_TIME_STATS        1
+/* The run time counter is the RTC that generates the tick, see FreeRTOS/runtime_stats.h */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() ulPortGetRunTimeCounterValue()
 #define configUSE_TRACE_FACILITY             1
 #define configUSE_STATS_FORMATTING_FUNCTIONS 0
 
@@ -180,6 +185,17 @@ standard names - or at least those used in the unmodified vector table. */
     #error "This port requires __NVIC_PRIO_BITS to be defined"
   #endif
 
+  #if (configGENERATE_RUN_TIME_STATS == 1)
+    #include <stdint.h>
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+uint32_t ulPortGetRunTimeCounterValue(void);
+    #ifdef __cplusplus
+}
+    #endif
+  #endif
+
   /* Access to current system core clock is required only if we are ticking the system by systimer */
   #if (configTICK_SOURCE == FREERTOS_USE_SYSTICK)
     #include <stdint.h>
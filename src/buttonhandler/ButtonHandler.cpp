@@ -2,13 +2,16 @@
 
 using namespace Pinetime::Controllers;
 
-void ButtonTimerCallback(TimerHandle_t xTimer) {
-  auto* sysTask = static_cast<Pinetime::System::SystemTask*>(pvTimerGetTimerID(xTimer));
-  sysTask->PushMessage(Pinetime::System::Messages::HandleButtonTimerEvent);
+ButtonHandler::ButtonHandler(TimerWheel& timerWheel) : timerWheel {timerWheel}, buttonTimer {OnButtonTimer, this, pdMS_TO_TICKS(15)} {
+}
+
+void ButtonHandler::OnButtonTimer(void* context) {
+  auto* buttonHandler = static_cast<ButtonHandler*>(context);
+  buttonHandler->systemTask->PushMessage(Pinetime::System::Messages::HandleButtonTimerEvent);
 }
 
 void ButtonHandler::Init(Pinetime::System::SystemTask* systemTask) {
-  buttonTimer = xTimerCreate("buttonTimer", pdMS_TO_TICKS(200), pdFALSE, systemTask, ButtonTimerCallback);
+  this->systemTask = systemTask;
 }
 
 ButtonActions ButtonHandler::HandleEvent(Events event) {
@@ -26,25 +29,22 @@ ButtonActions ButtonHandler::HandleEvent(Events event) {
   switch (state) {
     case States::Idle:
       if (event == Events::Press) {
-        xTimerChangePeriod(buttonTimer, doubleClickTime, 0);
-        xTimerStart(buttonTimer, 0);
+        timerWheel.Start(buttonTimer, doubleClickTime);
         state = States::Pressed;
       }
       break;
     case States::Pressed:
       if (event == Events::Press) {
         if (xTaskGetTickCount() - releaseTime < doubleClickTime) {
-          xTimerStop(buttonTimer, 0);
+          timerWheel.Stop(buttonTimer);
           state = States::Idle;
           return ButtonActions::DoubleClick;
         }
       } else if (event == Events::Release) {
-        xTimerChangePeriod(buttonTimer, doubleClickTime, 0);
-        xTimerStart(buttonTimer, 0);
+        timerWheel.Start(buttonTimer, doubleClickTime);
       } else if (event == Events::Timer) {
         if (buttonPressed) {
-          xTimerChangePeriod(buttonTimer, longPressTime - doubleClickTime, 0);
-          xTimerStart(buttonTimer, 0);
+          timerWheel.Start(buttonTimer, longPressTime - doubleClickTime);
           state = States::Holding;
         } else {
           state = States::Idle;
@@ -54,19 +54,18 @@ ButtonActions ButtonHandler::HandleEvent(Events event) {
       break;
     case States::Holding:
       if (event == Events::Release) {
-        xTimerStop(buttonTimer, 0);
+        timerWheel.Stop(buttonTimer);
         state = States::Idle;
         return ButtonActions::Click;
       } else if (event == Events::Timer) {
-        xTimerChangePeriod(buttonTimer, longerPressTime - longPressTime - doubleClickTime, 0);
-        xTimerStart(buttonTimer, 0);
+        timerWheel.Start(buttonTimer, longerPressTime - longPressTime - doubleClickTime);
         state = States::LongHeld;
         return ButtonActions::LongPress;
       }
       break;
     case States::LongHeld:
       if (event == Events::Release) {
-        xTimerStop(buttonTimer, 0);
+        timerWheel.Stop(buttonTimer);
         state = States::Idle;
       } else if (event == Events::Timer) {
         state = States::Idle;
@@ -2,21 +2,26 @@
 
 #include "buttonhandler/ButtonActions.h"
 #include "systemtask/SystemTask.h"
+#include "components/timer/TimerWheel.h"
 #include <FreeRTOS.h>
-#include <timers.h>
 
 namespace Pinetime {
   namespace Controllers {
     class ButtonHandler {
     public:
       enum class Events : uint8_t { Press, Release, Timer };
+      explicit ButtonHandler(TimerWheel& timerWheel);
       void Init(Pinetime::System::SystemTask* systemTask);
       ButtonActions HandleEvent(Events event);
 
     private:
       enum class States : uint8_t { Idle, Pressed, Holding, LongHeld };
+      static void OnButtonTimer(void* context);
+
+      TimerWheel& timerWheel;
+      Pinetime::System::SystemTask* systemTask = nullptr;
       TickType_t releaseTime = 0;
-      TimerHandle_t buttonTimer;
+      TimerWheel::Timer buttonTimer;
       bool buttonPressed = false;
       States state = States::Idle;
     };
@@ -23,19 +23,17 @@
 using namespace Pinetime::Controllers;
 using namespace std::chrono_literals;
 
-AlarmController::AlarmController(Controllers::DateTime& dateTimeController) : dateTimeController {dateTimeController} {
+AlarmController::AlarmController(Controllers::DateTime& dateTimeController, TimerWheel& timerWheel)
+  : dateTimeController {dateTimeController}, timerWheel {timerWheel}, alarmTimer {SetOffAlarm, this, pdMS_TO_TICKS(500)} {
 }
 
-namespace {
-  void SetOffAlarm(TimerHandle_t xTimer) {
-    auto* controller = static_cast<Pinetime::Controllers::AlarmController*>(pvTimerGetTimerID(xTimer));
-    controller->SetOffAlarmNow();
-  }
+void AlarmController::SetOffAlarm(void* context) {
+  auto* controller = static_cast<AlarmController*>(context);
+  controller->SetOffAlarmNow();
 }
 
 void AlarmController::Init(System::SystemTask* systemTask) {
   this->systemTask = systemTask;
-  alarmTimer = xTimerCreate("Alarm", 1, pdFALSE, this, SetOffAlarm);
 }
 
 void AlarmController::SetAlarmTime(uint8_t alarmHr, uint8_t alarmMin) {
@@ -45,7 +43,7 @@ void AlarmController::SetAlarmTime(uint8_t alarmHr, uint8_t alarmMin) {
 
 void AlarmController::ScheduleAlarm() {
   // Determine the next time the alarm needs to go off and set the timer
-  xTimerStop(alarmTimer, 0);
+  timerWheel.Stop(alarmTimer);
 
   auto now = dateTimeController.CurrentDateTime();
   alarmTime = now;
@@ -76,8 +74,7 @@ void AlarmController::ScheduleAlarm() {
   // now can convert back to a time_point
   alarmTime = std::chrono::system_clock::from_time_t(std::mktime(tmAlarmTime));
   auto secondsToAlarm = std::chrono::duration_cast<std::chrono::seconds>(alarmTime - now).count();
-  xTimerChangePeriod(alarmTimer, secondsToAlarm * configTICK_RATE_HZ, 0);
-  xTimerStart(alarmTimer, 0);
+  timerWheel.Start(alarmTimer, secondsToAlarm * configTICK_RATE_HZ);
 
   state = AlarmState::Set;
 }
@@ -87,7 +84,7 @@ uint32_t AlarmController::SecondsToAlarm() const {
 }
 
 void AlarmController::DisableAlarm() {
-  xTimerStop(alarmTimer, 0);
+  timerWheel.Stop(alarmTimer);
   state = AlarmState::Not_Set;
 }
 
@@ -17,10 +17,9 @@
 */
 #pragma once
 
-#include <FreeRTOS.h>
-#include <timers.h>
 #include <cstdint>
 #include "components/datetime/DateTimeController.h"
+#include "components/timer/TimerWheel.h"
 
 namespace Pinetime {
   namespace System {
@@ -30,7 +29,7 @@ namespace Pinetime {
   namespace Controllers {
     class AlarmController {
     public:
-      AlarmController(Controllers::DateTime& dateTimeController);
+      AlarmController(Controllers::DateTime& dateTimeController, TimerWheel& timerWheel);
 
       void Init(System::SystemTask* systemTask);
       void SetAlarmTime(uint8_t alarmHr, uint8_t alarmMin);
@@ -63,9 +62,12 @@ namespace Pinetime {
       }
 
     private:
+      static void SetOffAlarm(void* context);
+
       Controllers::DateTime& dateTimeController;
+      TimerWheel& timerWheel;
       System::SystemTask* systemTask = nullptr;
-      TimerHandle_t alarmTimer;
+      TimerWheel::Timer alarmTimer;
       uint8_t hours = 7;
       uint8_t minutes = 0;
       std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> alarmTime;
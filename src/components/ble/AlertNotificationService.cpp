@@ -86,39 +86,15 @@ int AlertNotificationService::OnAlert(struct ble_gatt_access_ctxt* ctxt) {
 
 void AlertNotificationService::AcceptIncomingCall() {
   auto response = IncomingCallResponses::Answer;
-  auto* om = ble_hs_mbuf_from_flat(&response, 1);
-
-  uint16_t connectionHandle = systemTask.nimble().connHandle();
-
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
-    return;
-  }
-
-  ble_gattc_notify_custom(connectionHandle, eventHandle, om);
+  systemTask.nimble().notifications().Notify(eventHandle, &response, sizeof(response), NotificationScheduler::Priority::Control);
 }
 
 void AlertNotificationService::RejectIncomingCall() {
   auto response = IncomingCallResponses::Reject;
-  auto* om = ble_hs_mbuf_from_flat(&response, 1);
-
-  uint16_t connectionHandle = systemTask.nimble().connHandle();
-
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
-    return;
-  }
-
-  ble_gattc_notify_custom(connectionHandle, eventHandle, om);
+  systemTask.nimble().notifications().Notify(eventHandle, &response, sizeof(response), NotificationScheduler::Priority::Control);
 }
 
 void AlertNotificationService::MuteIncomingCall() {
   auto response = IncomingCallResponses::Mute;
-  auto* om = ble_hs_mbuf_from_flat(&response, 1);
-
-  uint16_t connectionHandle = systemTask.nimble().connHandle();
-
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
-    return;
-  }
-
-  ble_gattc_notify_custom(connectionHandle, eventHandle, om);
+  systemTask.nimble().notifications().Notify(eventHandle, &response, sizeof(response), NotificationScheduler::Priority::Control);
 }
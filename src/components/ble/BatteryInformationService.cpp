@@ -1,6 +1,7 @@
 #include "components/ble/BatteryInformationService.h"
 #include <nrf_log.h>
 #include "components/battery/BatteryController.h"
+#include "components/ble/NotificationScheduler.h"
 
 using namespace Pinetime::Controllers;
 
@@ -48,7 +49,6 @@ int BatteryInformationService::OnBatteryServiceRequested(uint16_t attributeHandl
   return 0;
 }
 
-void BatteryInformationService::NotifyBatteryLevel(uint16_t connectionHandle, uint8_t level) {
-  auto* om = ble_hs_mbuf_from_flat(&level, 1);
-  ble_gattc_notify_custom(connectionHandle, batteryLevelHandle, om);
+void BatteryInformationService::NotifyBatteryLevel(NotificationScheduler& notificationScheduler, uint8_t level) {
+  notificationScheduler.Notify(batteryLevelHandle, &level, sizeof(level), NotificationScheduler::Priority::RealTime);
 }
@@ -0,0 +1,114 @@
+#include "components/ble/ConnectionPolicy.h"
+#include <nrf_log.h>
+#include <task.h>
+
+using namespace Pinetime::Controllers;
+
+ConnectionPolicy::ConnectionPolicy(TimerWheel& timerWheel) : timerWheel {timerWheel}, timer {OnTimer, this} {
+}
+
+void ConnectionPolicy::OnConnected(uint16_t handle, const ble_gap_conn_desc& desc) {
+  const TickType_t now = xTaskGetTickCount();
+  for (auto& activity : lastActivity) {
+    activity = now - holdTime;
+  }
+  connectedAt = now;
+  updating = false;
+  centralParameters = true;
+  interval = desc.conn_itvl;
+  latency = desc.conn_latency;
+  supervisionTimeout = desc.supervision_timeout;
+  connectionHandle = handle;
+  timerWheel.Start(timer, startDelay);
+}
+
+void ConnectionPolicy::OnUpdated(int status, const ble_gap_conn_desc& desc) {
+  NRF_LOG_INFO("[ConnectionPolicy] interval=%d latency=%d timeout=%d status=%d",
+               desc.conn_itvl,
+               desc.conn_latency,
+               desc.supervision_timeout,
+               status);
+  interval = desc.conn_itvl;
+  latency = desc.conn_latency;
+  supervisionTimeout = desc.supervision_timeout;
+  if (updating && status != 0) {
+    // The central refused the parameters, they are not requested again until the profile changes
+    failures++;
+  }
+  updating = false;
+  timerWheel.Start(timer, 1);
+}
+
+void ConnectionPolicy::OnDisconnected() {
+  connectionHandle = BLE_HS_CONN_HANDLE_NONE;
+  timerWheel.Start(timer, 1);
+}
+
+void ConnectionPolicy::Activity(Profiles profile) {
+  if (profile == Profiles::Idle || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    return;
+  }
+  lastActivity[static_cast<uint8_t>(profile)] = xTaskGetTickCount();
+  if (profile > requested) {
+    timerWheel.Start(timer, 1);
+  }
+}
+
+void ConnectionPolicy::OnTimer(void* context) {
+  static_cast<ConnectionPolicy*>(context)->Update();
+}
+
+void ConnectionPolicy::Update() {
+  const TickType_t now = xTaskGetTickCount();
+  if (connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    requested = Profiles::Idle;
+    residency.Enter(Profiles::Idle, now);
+    return;
+  }
+  if (now - connectedAt < startDelay) {
+    timerWheel.Start(timer, startDelay - (now - connectedAt));
+    return;
+  }
+
+  TickType_t remaining = 0;
+  const Profiles target = Target(now, remaining);
+  if (target != requested || centralParameters) {
+    if (updating) {
+      remaining = retryDelay;
+    } else {
+      const auto& profile = parameters[static_cast<uint8_t>(target)];
+      ble_gap_upd_params params {.itvl_min = profile.minInterval,
+                                 .itvl_max = profile.maxInterval,
+                                 .latency = profile.latency,
+                                 .supervision_timeout = profile.supervisionTimeout,
+                                 .min_ce_len = 0,
+                                 .max_ce_len = 0};
+      requests++;
+      if (ble_gap_update_params(connectionHandle, &params) == 0) {
+        updating = true;
+        centralParameters = false;
+        requested = target;
+        residency.Enter(target, now);
+      } else {
+        failures++;
+        remaining = retryDelay;
+      }
+    }
+  }
+
+  // Until the activity of the profile stops
+  if (remaining > 0) {
+    timerWheel.Start(timer, remaining);
+  }
+}
+
+ConnectionPolicy::Profiles ConnectionPolicy::Target(TickType_t now, TickType_t& remaining) const {
+  for (uint8_t i = nbProfiles - 1; i > 0; i--) {
+    const TickType_t elapsed = now - lastActivity[i];
+    if (elapsed < holdTime) {
+      remaining = holdTime - elapsed;
+      return static_cast<Profiles>(i);
+    }
+  }
+  return Profiles::Idle;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <FreeRTOS.h>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+#include "components/timer/TimerWheel.h"
+#include "utility/StateResidency.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /*
+     * Chooses the connection parameters according to the activity reported by the services.
+     *
+     * The connection stays in a profile for holdTime after the last activity of this profile, then falls back to the
+     * next slower one: short intervals without slave latency during file and firmware transfers (Transfer) and live
+     * data streams (Streaming), long intervals with slave latency otherwise (Idle). A faster profile is requested as
+     * soon as its activity starts. The parameters are requested to the central, which can refuse them or choose other
+     * values in the range. The values comply with the Apple accessory design guidelines.
+     */
+    class ConnectionPolicy {
+    public:
+      enum class Profiles : uint8_t { Idle, Streaming, Transfer };
+      static constexpr uint8_t nbProfiles = 3;
+
+      explicit ConnectionPolicy(TimerWheel& timerWheel);
+      ConnectionPolicy(const ConnectionPolicy&) = delete;
+      ConnectionPolicy& operator=(const ConnectionPolicy&) = delete;
+
+      void OnConnected(uint16_t connectionHandle, const ble_gap_conn_desc& desc);
+      // status is the status of the BLE_GAP_EVENT_CONN_UPDATE event
+      void OnUpdated(int status, const ble_gap_conn_desc& desc);
+      void OnDisconnected();
+
+      // Can be called from any task, as often as needed
+      void Activity(Profiles profile);
+
+      Profiles Requested() const {
+        return requested;
+      }
+
+      const Utility::StateResidency<Profiles, nbProfiles>& Residency() const {
+        return residency;
+      }
+
+      // Current parameters of the connection: interval in units of 1.25ms, supervision timeout in units of 10ms
+      uint16_t Interval() const {
+        return interval;
+      }
+
+      uint16_t Latency() const {
+        return latency;
+      }
+
+      uint16_t SupervisionTimeout() const {
+        return supervisionTimeout;
+      }
+
+      uint32_t Requests() const {
+        return requests;
+      }
+
+      // Requests that NimBLE could not start, or that the central refused
+      uint32_t Failures() const {
+        return failures;
+      }
+
+    private:
+      struct Parameters {
+        uint16_t minInterval;
+        uint16_t maxInterval;
+        uint16_t latency;
+        uint16_t supervisionTimeout;
+      };
+
+      static constexpr std::array<Parameters, nbProfiles> parameters {{
+        {240, 264, 2, 600}, // Idle: 300-330ms, the watch listens every ~1s
+        {24, 40, 0, 400},   // Streaming: 30-50ms
+        {12, 24, 0, 400},   // Transfer: 15-30ms
+      }};
+      static constexpr TickType_t holdTime = pdMS_TO_TICKS(3000);
+      // The central discovers the services and configures the connection first
+      static constexpr TickType_t startDelay = pdMS_TO_TICKS(5000);
+      static constexpr TickType_t retryDelay = pdMS_TO_TICKS(1000);
+
+      TimerWheel& timerWheel;
+      TimerWheel::Timer timer;
+      uint16_t connectionHandle = BLE_HS_CONN_HANDLE_NONE;
+      TickType_t connectedAt = 0;
+      std::array<std::atomic<TickType_t>, nbProfiles> lastActivity {};
+      std::atomic<Profiles> requested {Profiles::Idle};
+      bool updating = false;
+      // The parameters chosen by the central when it connected have not been changed yet
+      bool centralParameters = true;
+
+      uint16_t interval = 0;
+      uint16_t latency = 0;
+      uint16_t supervisionTimeout = 0;
+      uint32_t requests = 0;
+      uint32_t failures = 0;
+      Utility::StateResidency<Profiles, nbProfiles> residency {Profiles::Idle};
+
+      static void OnTimer(void* context);
+      void Update();
+      Profiles Target(TickType_t now, TickType_t& remaining) const;
+    };
+  }
+}
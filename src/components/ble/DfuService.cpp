@@ -1,6 +1,7 @@
 #include "components/ble/DfuService.h"
 #include <cstring>
 #include "components/ble/BleController.h"
+#include "components/ble/NotificationScheduler.h"
 #include "drivers/SpiNorFlash.h"
 #include "systemtask/SystemTask.h"
 #include <nrf_log.h>
@@ -17,22 +18,20 @@ int DfuServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_ga
   return dfuService->OnServiceData(conn_handle, attr_handle, ctxt);
 }
 
-void NotificationTimerCallback(TimerHandle_t xTimer) {
-  auto notificationManager = static_cast<DfuService::NotificationManager*>(pvTimerGetTimerID(xTimer));
-  notificationManager->OnNotificationTimer();
-}
-
-void TimeoutTimerCallback(TimerHandle_t xTimer) {
-  auto dfuService = static_cast<DfuService*>(pvTimerGetTimerID(xTimer));
+void TimeoutTimerCallback(void* context) {
+  auto dfuService = static_cast<DfuService*>(context);
   dfuService->OnTimeout();
 }
 
 DfuService::DfuService(Pinetime::System::SystemTask& systemTask,
                        Pinetime::Controllers::Ble& bleController,
-                       Pinetime::Drivers::SpiNorFlash& spiNorFlash)
+                       Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                       TimerWheel& timerWheel,
+                       NotificationScheduler& notificationScheduler)
   : systemTask {systemTask},
     bleController {bleController},
     dfuImage {spiNorFlash},
+    notificationManager {timerWheel, notificationScheduler},
     characteristicDefinition {{
                                 .uuid = &packetCharacteristicUuid.u,
                                 .access_cb = DfuServiceCallback,
@@ -64,8 +63,9 @@ DfuService::DfuService(Pinetime::System::SystemTask& systemTask,
        .uuid = &serviceUuid.u,
        .characteristics = characteristicDefinition},
       {0},
-    } {
-  timeoutTimer = xTimerCreate("notificationTimer", 10000, pdFALSE, this, TimeoutTimerCallback);
+    },
+    timerWheel {timerWheel},
+    timeoutTimer {TimeoutTimerCallback, this, pdMS_TO_TICKS(1000)} {
 }
 
 void DfuService::Init() {
@@ -79,8 +79,9 @@ void DfuService::Init() {
 
 int DfuService::OnServiceData(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
   if (bleController.IsFirmwareUpdating()) {
-    xTimerStart(timeoutTimer, 0);
+    timerWheel.Start(timeoutTimer, pdMS_TO_TICKS(10000));
   }
+  systemTask.nimble().connectionPolicy().Activity(ConnectionPolicy::Profiles::Transfer);
 
   ble_gatts_find_chr(&serviceUuid.u, &packetCharacteristicUuid.u, nullptr, &packetCharacteristicHandle);
   ble_gatts_find_chr(&serviceUuid.u, &controlPointCharacteristicUuid.u, nullptr, &controlPointCharacteristicHandle);
@@ -314,8 +315,13 @@ void DfuService::Reset() {
   systemTask.PushMessage(Pinetime::System::Messages::BleFirmwareUpdateFinished);
 }
 
-DfuService::NotificationManager::NotificationManager() {
-  timer = xTimerCreate("notificationTimer", 1000, pdFALSE, this, NotificationTimerCallback);
+DfuService::NotificationManager::NotificationManager(TimerWheel& timerWheel, NotificationScheduler& notificationScheduler)
+  : timerWheel {timerWheel}, notificationScheduler {notificationScheduler}, timer {OnTimer, this, pdMS_TO_TICKS(100)} {
+}
+
+void DfuService::NotificationManager::OnTimer(void* context) {
+  auto notificationManager = static_cast<DfuService::NotificationManager*>(context);
+  notificationManager->OnNotificationTimer();
 }
 
 bool DfuService::NotificationManager::AsyncSend(uint16_t connection, uint16_t charactHandle, uint8_t* data, size_t s) {
@@ -326,7 +332,7 @@ bool DfuService::NotificationManager::AsyncSend(uint16_t connection, uint16_t ch
   characteristicHandle = charactHandle;
   size = s;
   std::memcpy(buffer, data, size);
-  xTimerStart(timer, 0);
+  timerWheel.Start(timer, pdMS_TO_TICKS(1000));
   return true;
 }
 
@@ -337,17 +343,16 @@ void DfuService::NotificationManager::OnNotificationTimer() {
   }
 }
 
-void DfuService::NotificationManager::Send(uint16_t connection, uint16_t charactHandle, const uint8_t* data, const size_t s) {
-  auto* om = ble_hs_mbuf_from_flat(data, s);
-  auto ret = ble_gattc_notify_custom(connection, charactHandle, om);
-  ASSERT(ret == 0);
+void DfuService::NotificationManager::Send(uint16_t /*connection*/, uint16_t charactHandle, const uint8_t* data, const size_t s) {
+  // The transfer is stalled (and times out) instead of resetting the watch if the notification cannot be sent
+  notificationScheduler.Notify(charactHandle, data, s, NotificationScheduler::Priority::Control);
 }
 
 void DfuService::NotificationManager::Reset() {
   connectionHandle = 0;
   characteristicHandle = 0;
   size = 0;
-  xTimerStop(timer, 0);
+  timerWheel.Stop(timer);
 }
 
 void DfuService::DfuImage::Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc) {
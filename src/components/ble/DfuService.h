@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <array>
+#include "components/timer/TimerWheel.h"
 
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
@@ -20,12 +21,15 @@ namespace Pinetime {
 
   namespace Controllers {
     class Ble;
+    class NotificationScheduler;
 
     class DfuService {
     public:
       DfuService(Pinetime::System::SystemTask& systemTask,
                  Pinetime::Controllers::Ble& bleController,
-                 Pinetime::Drivers::SpiNorFlash& spiNorFlash);
+                 Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                 TimerWheel& timerWheel,
+                 NotificationScheduler& notificationScheduler);
       void Init();
       int OnServiceData(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void OnTimeout();
@@ -33,12 +37,16 @@ namespace Pinetime {
 
       class NotificationManager {
       public:
-        NotificationManager();
+        NotificationManager(TimerWheel& timerWheel, NotificationScheduler& notificationScheduler);
         bool AsyncSend(uint16_t connection, uint16_t charactHandle, uint8_t* data, size_t size);
         void Send(uint16_t connection, uint16_t characteristicHandle, const uint8_t* data, const size_t s);
 
       private:
-        TimerHandle_t timer;
+        static void OnTimer(void* context);
+
+        TimerWheel& timerWheel;
+        NotificationScheduler& notificationScheduler;
+        TimerWheel::Timer timer;
         uint16_t connectionHandle = 0;
         uint16_t characteristicHandle = 0;
         size_t size = 0;
@@ -156,7 +164,8 @@ namespace Pinetime {
       int WritePacketHandler(uint16_t connectionHandle, os_mbuf* om);
       int ControlPointHandler(uint16_t connectionHandle, os_mbuf* om);
 
-      TimerHandle_t timeoutTimer;
+      TimerWheel& timerWheel;
+      TimerWheel::Timer timeoutTimer;
     };
   }
 }
\ No newline at end of file
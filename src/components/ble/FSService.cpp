@@ -63,12 +63,16 @@ int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attribut
 int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
   auto command = static_cast<commands>(om->om_data[0]);
   NRF_LOG_INFO("[FS_S] -> FSCommandHandler Command %d", command);
+  systemTask.nimble().connectionPolicy().Activity(ConnectionPolicy::Profiles::Transfer);
   // Just always make sure we are awake...
   systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
   vTaskDelay(10);
   while (systemTask.IsSleeping()) {
     vTaskDelay(100); // 50ms
   }
+  // The entries of the listings are queued behind each other as Bulk notifications, the other responses are sent
+  // immediately
+  auto& notifications = systemTask.nimble().notifications();
   lfs_dir_t dir = {0};
   lfs_info info = {0};
   lfs_file f = {0};
@@ -105,7 +109,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
         fs.FileClose(&f);
       }
 
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
       break;
     }
     case commands::READ_PACING: {
@@ -137,7 +141,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
         om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
       }
       fs.FileClose(&f);
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
       break;
     }
     case commands::WRITE: {
@@ -162,7 +166,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       }
       resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
       break;
     }
     case commands::WRITE_DATA: {
@@ -181,10 +185,12 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       }
       if (res < 0) {
         resp.status = (int8_t) res;
+      } else if (header->offset + header->dataSize >= static_cast<uint32_t>(fileSize)) {
+        fs.ResourceUpdated(filepath);
       }
       resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
       break;
     }
     case commands::DELETE: {
@@ -197,9 +203,12 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       DelResponse resp {};
       resp.command = commands::DELETE_STATUS;
       int res = fs.FileDelete(path);
+      if (res == 0) {
+        fs.ResourceUpdated(path);
+      }
       resp.status = (res == 0) ? 0x01 : (int8_t) res;
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(DelResponse));
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
       break;
     }
     case commands::MKDIR: {
@@ -215,7 +224,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       int res = fs.DirCreate(path);
       resp.status = (res == 0) ? 0x01 : (int8_t) res;
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(MKDirResponse));
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
       break;
     }
     case commands::LISTDIR: {
@@ -237,7 +246,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       if (res != 0) {
         resp.status = (int8_t) res;
         auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ListDirResponse));
-        ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+        notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
         break;
       };
       while (fs.DirRead(&dir, &info)) {
@@ -266,12 +275,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
         resp.path_length = strlen(info.name);
         auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ListDirResponse));
         os_mbuf_append(om, info.name, resp.path_length);
-        ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
-        /*
-         * Todo Figure out how to know when the previous Notify was TX'd
-         * For now just delay 100ms to make sure that the data went out...
-         */
-        vTaskDelay(100); // Allow stuff to actually go out over the BLE conn
+        notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Bulk);
         resp.entry++;
       }
       assert(fs.DirClose(&dir) == 0);
@@ -279,7 +283,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       resp.path_length = 0;
       resp.flags = 0;
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ListDirResponse));
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Bulk);
       break;
     }
     case commands::MOVE: {
@@ -294,9 +298,49 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       MoveResponse resp {};
       resp.command = commands::MOVE_STATUS;
       int8_t res = (int8_t) fs.Rename(header->pathstr, path);
+      if (res == 0) {
+        fs.ResourceUpdated(header->pathstr);
+        fs.ResourceUpdated(path);
+      }
       resp.status = (res == 0) ? 1 : res;
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(MoveResponse));
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
+      break;
+    }
+    case commands::LIST_RESOURCES: {
+      NRF_LOG_INFO("[FS_S] -> ListResources");
+      const auto& resources = fs.Resources();
+      ListResourcesResponse resp {};
+      resp.command = commands::LIST_RESOURCES_ENTRIES;
+      resp.status = resources.IsLoaded() ? 0x01 : (int8_t) LFS_ERR_NOENT;
+      resp.totalentries = resources.NbEntries();
+
+      // As many entries as the MTU allows in each notification
+      const uint16_t payloadSize = ble_att_mtu(connectionHandle) - 3;
+      const uint8_t maxEntries =
+        std::max<int>(1, std::min<int>(UINT8_MAX, (payloadSize - (int) sizeof(ListResourcesResponse)) / (int) sizeof(ResourceEntry)));
+      do {
+        resp.nbentries = std::min<uint8_t>(maxEntries, resp.totalentries - resp.entry);
+        auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ListResourcesResponse));
+        for (uint8_t i = 0; i < resp.nbentries; i++) {
+          const auto& entry = resources.GetEntry(resp.entry + i);
+          ResourceEntry resourceEntry {entry.pathHash, entry.size, entry.crc, static_cast<uint8_t>(entry.valid ? 1 : 0)};
+          os_mbuf_append(om, &resourceEntry, sizeof(ResourceEntry));
+        }
+        notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Bulk);
+        resp.entry += resp.nbentries;
+      } while (resp.entry < resp.totalentries);
+      break;
+    }
+    case commands::COMMIT_RESOURCES: {
+      NRF_LOG_INFO("[FS_S] -> CommitResources");
+      CommitResourcesResponse resp {};
+      resp.command = commands::COMMIT_RESOURCES_STATUS;
+      int res = fs.CommitResources();
+      resp.status = (res == 0) ? 0x01 : (int8_t) res;
+      auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(CommitResourcesResponse));
+      notifications.Notify(transferCharacteristicHandle, om, NotificationScheduler::Priority::Control);
+      break;
     }
     default:
       break;
@@ -63,7 +63,11 @@ namespace Pinetime {
         LISTDIR = 0x50,
         LISTDIR_ENTRY = 0x51,
         MOVE = 0x60,
-        MOVE_STATUS = 0x61
+        MOVE_STATUS = 0x61,
+        LIST_RESOURCES = 0x70,
+        LIST_RESOURCES_ENTRIES = 0x71,
+        COMMIT_RESOURCES = 0x72,
+        COMMIT_RESOURCES_STATUS = 0x73
       };
       enum class FSState : uint8_t {
         IDLE = 0x00,
@@ -190,6 +194,27 @@ namespace Pinetime {
         uint8_t status;
       };
 
+      // Followed by nbentries ResourceEntry
+      using ListResourcesResponse = struct __attribute__((packed)) {
+        commands command;
+        uint8_t status;
+        uint8_t entry;
+        uint8_t nbentries;
+        uint8_t totalentries;
+      };
+
+      using ResourceEntry = struct __attribute__((packed)) {
+        uint32_t pathHash;
+        uint32_t size;
+        uint32_t crc;
+        uint8_t flags;
+      };
+
+      using CommitResourcesResponse = struct __attribute__((packed)) {
+        commands command;
+        uint8_t status;
+      };
+
       int FSCommandHandler(uint16_t connectionHandle, os_mbuf* om);
       void prepareReadDataResp(ReadHeader* header, ReadResponse* resp);
     };
@@ -2,11 +2,13 @@
 #include "components/heartrate/HeartRateController.h"
 #include "components/ble/NimbleController.h"
 #include <nrf_log.h>
+#include <algorithm>
 
 using namespace Pinetime::Controllers;
 
 constexpr ble_uuid16_t HeartRateService::heartRateServiceUuid;
 constexpr ble_uuid16_t HeartRateService::heartRateMeasurementUuid;
+constexpr ble_uuid128_t HeartRateService::historyUuid;
 
 namespace {
   int HeartRateServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
@@ -24,6 +26,11 @@ HeartRateService::HeartRateService(NimbleController& nimble, Controllers::HeartR
                                .arg = this,
                                .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
                                .val_handle = &heartRateMeasurementHandle},
+                              {.uuid = &historyUuid.u,
+                               .access_cb = HeartRateServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+                               .val_handle = &historyHandle},
                               {0}},
     serviceDefinition {
       {/* Device Information Service */
@@ -53,23 +60,63 @@ int HeartRateService::OnHeartRateRequested(uint16_t attributeHandle, ble_gatt_ac
     int res = os_mbuf_append(context->om, buffer, 2);
     return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
   }
+  if (attributeHandle == historyHandle) {
+    return OnHistoryRequested(context);
+  }
   return 0;
 }
 
-void HeartRateService::OnNewHeartRateValue(uint8_t heartRateValue) {
-  if (!heartRateMeasurementNotificationEnable)
-    return;
-
-  uint8_t buffer[2] = {0, heartRateValue}; // [0] = flags, [1] = hr value
-  auto* om = ble_hs_mbuf_from_flat(buffer, 2);
+int HeartRateService::OnHistoryRequested(ble_gatt_access_ctxt* context) {
+  auto& history = heartRateController.History();
+  if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+    // 2 bytes: index of the block to read, 4 bytes: time (seconds since the epoch) of the first sample to read
+    const uint16_t length = OS_MBUF_PKTLEN(context->om);
+    if (length == sizeof(uint16_t)) {
+      os_mbuf_copydata(context->om, 0, sizeof(uint16_t), &historyCursor);
+    } else if (length == sizeof(uint32_t)) {
+      uint32_t since;
+      os_mbuf_copydata(context->om, 0, sizeof(uint32_t), &since);
+      nimble.BeginFileAccess();
+      historyCursor = history.FindBlock(since);
+      nimble.EndFileAccess();
+    } else {
+      return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    return 0;
+  }
 
-  uint16_t connectionHandle = nimble.connHandle();
+  // The index of the block and the number of blocks, followed by the block. Reading the same block several times
+  // returns the same data: the value is longer than the MTU and is read in several requests.
+  const uint16_t nbBlocks = history.NbBlocks();
+  int res = os_mbuf_append(context->om, &historyCursor, sizeof(historyCursor));
+  res |= os_mbuf_append(context->om, &nbBlocks, sizeof(nbBlocks));
+  if (historyCursor < nbBlocks) {
+    uint8_t block[TimeSeries::blockSize];
+    nimble.BeginFileAccess();
+    const size_t size = history.ReadBlock(historyCursor, block);
+    nimble.EndFileAccess();
+    res |= os_mbuf_append(context->om, block, size);
+  }
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
 
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+void HeartRateService::OnNewHeartRateValue(uint8_t heartRateValue, const uint16_t* rrIntervals, uint8_t nbRrIntervals) {
+  if (!heartRateMeasurementNotificationEnable)
     return;
-  }
 
-  ble_gattc_notify_custom(connectionHandle, heartRateMeasurementHandle, om);
+  // [0] = flags, [1] = hr value, then the RR intervals (uint16, 1/1024s)
+  uint8_t buffer[2 + 2 * maxRrIntervals] = {0, heartRateValue};
+  uint8_t size = 2;
+  nbRrIntervals = std::min(nbRrIntervals, maxRrIntervals);
+  if (nbRrIntervals > 0) {
+    buffer[0] |= flagRrIntervals;
+  }
+  for (uint8_t i = 0; i < nbRrIntervals; i++) {
+    const uint16_t interval = static_cast<uint32_t>(rrIntervals[i]) * 1024 / 1000;
+    buffer[size++] = interval & 0xff;
+    buffer[size++] = interval >> 8;
+  }
+  nimble.notifications().Notify(heartRateMeasurementHandle, buffer, size, NotificationScheduler::Priority::RealTime);
 }
 
 void HeartRateService::SubscribeNotification(uint16_t attributeHandle) {
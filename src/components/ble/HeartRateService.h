@@ -16,7 +16,12 @@ namespace Pinetime {
       HeartRateService(NimbleController& nimble, Controllers::HeartRateController& heartRateController);
       void Init();
       int OnHeartRateRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
-      void OnNewHeartRateValue(uint8_t hearRateValue);
+      int OnHistoryRequested(ble_gatt_access_ctxt* context);
+      // rrIntervals: intervals between beats since the last value (ms), sent in the measurement if notifications are enabled
+      void OnNewHeartRateValue(uint8_t hearRateValue, const uint16_t* rrIntervals, uint8_t nbRrIntervals);
+
+      // RR intervals that fit in a notification with the default ATT MTU (flags, heart rate, 2 bytes per interval)
+      static constexpr uint8_t maxRrIntervals = 9;
 
       void SubscribeNotification(uint16_t attributeHandle);
       void UnsubscribeNotification(uint16_t attributeHandle);
@@ -26,15 +31,24 @@ namespace Pinetime {
       Controllers::HeartRateController& heartRateController;
       static constexpr uint16_t heartRateServiceId {0x180D};
       static constexpr uint16_t heartRateMeasurementId {0x2A37};
+      static constexpr uint8_t flagRrIntervals = 0x10;
 
       static constexpr ble_uuid16_t heartRateServiceUuid {.u {.type = BLE_UUID_TYPE_16}, .value = heartRateServiceId};
 
       static constexpr ble_uuid16_t heartRateMeasurementUuid {.u {.type = BLE_UUID_TYPE_16}, .value = heartRateMeasurementId};
 
-      struct ble_gatt_chr_def characteristicDefinition[2];
+      // 00070001-78fc-48fe-8e23-433b3a1942d0
+      static constexpr ble_uuid128_t historyUuid {
+        .u {.type = BLE_UUID_TYPE_128},
+        .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, 0x01, 0x00, 0x07, 0x00}};
+
+      struct ble_gatt_chr_def characteristicDefinition[3];
       struct ble_gatt_svc_def serviceDefinition[2];
 
       uint16_t heartRateMeasurementHandle;
+      uint16_t historyHandle;
+      // Block of the history returned by the next read
+      uint16_t historyCursor = 0;
       std::atomic_bool heartRateMeasurementNotificationEnable {false};
     };
   }
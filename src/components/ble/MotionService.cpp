@@ -2,6 +2,7 @@
 #include "components/motion/MotionController.h"
 #include "components/ble/NimbleController.h"
 #include <nrf_log.h>
+#include <algorithm>
 
 using namespace Pinetime::Controllers;
 
@@ -20,6 +21,9 @@ namespace {
   constexpr ble_uuid128_t motionServiceUuid {BaseUuid()};
   constexpr ble_uuid128_t stepCountCharUuid {CharUuid(0x01, 0x00)};
   constexpr ble_uuid128_t motionValuesCharUuid {CharUuid(0x02, 0x00)};
+  constexpr ble_uuid128_t motionStreamCharUuid {CharUuid(0x03, 0x00)};
+  constexpr ble_uuid128_t stepHistoryCharUuid {CharUuid(0x04, 0x00)};
+  constexpr ble_uuid128_t actigraphyCharUuid {CharUuid(0x05, 0x00)};
 
   int MotionServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     auto* motionService = static_cast<MotionService*>(arg);
@@ -41,6 +45,21 @@ MotionService::MotionService(NimbleController& nimble, Controllers::MotionContro
                                .arg = this,
                                .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
                                .val_handle = &motionValuesHandle},
+                              {.uuid = &motionStreamCharUuid.u,
+                               .access_cb = MotionServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_NOTIFY,
+                               .val_handle = &motionStreamHandle},
+                              {.uuid = &stepHistoryCharUuid.u,
+                               .access_cb = MotionServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+                               .val_handle = &stepHistoryHandle},
+                              {.uuid = &actigraphyCharUuid.u,
+                               .access_cb = MotionServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+                               .val_handle = &actigraphyHandle},
                               {0}},
     serviceDefinition {
       {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &motionServiceUuid.u, .characteristics = characteristicDefinition},
@@ -71,40 +90,156 @@ int MotionService::OnStepCountRequested(uint16_t attributeHandle, ble_gatt_acces
 
     int res = os_mbuf_append(context->om, buffer, 3 * sizeof(int16_t));
     return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  } else if (attributeHandle == stepHistoryHandle) {
+    return OnStepHistoryRequested(context);
+  } else if (attributeHandle == actigraphyHandle) {
+    return OnActigraphyRequested(context);
   }
   return 0;
 }
 
-void MotionService::OnNewStepCountValue(uint32_t stepCount) {
-  if (!stepCountNoficationEnabled)
-    return;
+int MotionService::OnStepHistoryRequested(ble_gatt_access_ctxt* context) {
+  auto& history = motionController.History();
+  if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+    // 2 bytes: index of the first record to read, 4 bytes: time (seconds since the epoch) of the first day to read
+    const uint16_t length = OS_MBUF_PKTLEN(context->om);
+    if (length == sizeof(uint16_t)) {
+      os_mbuf_copydata(context->om, 0, sizeof(uint16_t), &stepHistoryCursor);
+    } else if (length == sizeof(uint32_t)) {
+      uint32_t since;
+      os_mbuf_copydata(context->om, 0, sizeof(uint32_t), &since);
+      nimble.BeginFileAccess();
+      stepHistoryCursor = history.FindRecord(since / 86400);
+      nimble.EndFileAccess();
+    } else {
+      return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    return 0;
+  }
 
-  uint32_t buffer = stepCount;
-  auto* om = ble_hs_mbuf_from_flat(&buffer, 4);
+  // The index of the first record and the number of records, followed by up to historyRecords records. Reading
+  // several times returns the same records: the value is longer than the MTU and is read in several requests.
+  const uint16_t nbRecords = history.NbRecords();
+  int res = os_mbuf_append(context->om, &stepHistoryCursor, sizeof(stepHistoryCursor));
+  res |= os_mbuf_append(context->om, &nbRecords, sizeof(nbRecords));
+  StepHistory::DayRecord record;
+  nimble.BeginFileAccess();
+  for (uint16_t i = stepHistoryCursor; i < nbRecords && i < stepHistoryCursor + historyRecords && res == 0; i++) {
+    if (!history.ReadRecord(i, record)) {
+      break;
+    }
+    res |= os_mbuf_append(context->om, &record, sizeof(record));
+  }
+  nimble.EndFileAccess();
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
 
-  uint16_t connectionHandle = nimble.connHandle();
+int MotionService::OnActigraphyRequested(ble_gatt_access_ctxt* context) {
+  auto& history = motionController.GetActigraphy().History();
+  if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+    // 2 bytes: index of the block to read, 4 bytes: time (seconds since the epoch) of the first epoch to read
+    const uint16_t length = OS_MBUF_PKTLEN(context->om);
+    if (length == sizeof(uint16_t)) {
+      os_mbuf_copydata(context->om, 0, sizeof(uint16_t), &actigraphyCursor);
+    } else if (length == sizeof(uint32_t)) {
+      uint32_t since;
+      os_mbuf_copydata(context->om, 0, sizeof(uint32_t), &since);
+      nimble.BeginFileAccess();
+      actigraphyCursor = history.FindBlock(since);
+      nimble.EndFileAccess();
+    } else {
+      return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    return 0;
+  }
 
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
-    return;
+  // Same format as the heart rate history
+  const uint16_t nbBlocks = history.NbBlocks();
+  int res = os_mbuf_append(context->om, &actigraphyCursor, sizeof(actigraphyCursor));
+  res |= os_mbuf_append(context->om, &nbBlocks, sizeof(nbBlocks));
+  if (actigraphyCursor < nbBlocks) {
+    uint8_t block[TimeSeries::blockSize];
+    nimble.BeginFileAccess();
+    const size_t size = history.ReadBlock(actigraphyCursor, block);
+    nimble.EndFileAccess();
+    res |= os_mbuf_append(context->om, block, size);
   }
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
 
-  ble_gattc_notify_custom(connectionHandle, stepCountHandle, om);
+void MotionService::OnNewStepCountValue(uint32_t stepCount) {
+  if (!stepCountNoficationEnabled)
+    return;
+
+  uint32_t buffer = stepCount;
+  nimble.notifications().Notify(stepCountHandle, &buffer, sizeof(buffer), NotificationScheduler::Priority::RealTime);
 }
 
 void MotionService::OnNewMotionValues(int16_t x, int16_t y, int16_t z) {
   if (!motionValuesNoficationEnabled)
     return;
 
+  nimble.connectionPolicy().Activity(ConnectionPolicy::Profiles::Streaming);
   int16_t buffer[3] = {x, y, z};
-  auto* om = ble_hs_mbuf_from_flat(buffer, 3 * sizeof(int16_t));
-
-  uint16_t connectionHandle = nimble.connHandle();
+  nimble.notifications().Notify(motionValuesHandle, buffer, sizeof(buffer), NotificationScheduler::Priority::RealTime);
+}
 
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+void MotionService::OnNewMotionSamples(const Drivers::Bma421::Sample* samples, size_t nbSamples, bool overflow, TickType_t lastSampleTime) {
+  if (!motionStreamNotificationEnabled)
     return;
+
+  if (motionStreamRestart.exchange(false)) {
+    nbStreamSamples = 0;
+    streamSequence = 0;
+    streamSamplesLost = false;
+  } else if (overflow) {
+    // The time of the next samples cannot be deduced from the buffered ones
+    SendStream();
+    streamSamplesLost = true;
+  }
+
+  const size_t capacity = StreamCapacity();
+  for (size_t i = 0; i < nbSamples; i++) {
+    if (nbStreamSamples == 0) {
+      streamTime = lastSampleTime - (nbSamples - 1 - i) * configTICK_RATE_HZ / Drivers::Bma421::sampleRate;
+    }
+    streamSamples[nbStreamSamples++] = samples[i];
+    if (nbStreamSamples >= capacity) {
+      SendStream();
+    }
+  }
+  if (nbStreamSamples > 0 && xTaskGetTickCount() - streamTime >= maxStreamLatency) {
+    SendStream();
+  }
+}
+
+size_t MotionService::StreamCapacity() const {
+  const uint16_t mtu = ble_att_mtu(nimble.connHandle());
+  if (mtu < 3 + sizeof(StreamHeader) + sizeof(Drivers::Bma421::Sample)) {
+    return 1;
   }
+  return std::min(maxStreamSamples, (mtu - 3 - sizeof(StreamHeader)) / sizeof(Drivers::Bma421::Sample));
+}
+
+void MotionService::SendStream() {
+  if (nbStreamSamples == 0)
+    return;
 
-  ble_gattc_notify_custom(connectionHandle, motionValuesHandle, om);
+  nimble.connectionPolicy().Activity(ConnectionPolicy::Profiles::Streaming);
+  const StreamHeader header {streamSequence++,
+                             streamTime,
+                             Drivers::Bma421::sampleRate,
+                             static_cast<uint8_t>(nbStreamSamples),
+                             static_cast<uint8_t>(streamSamplesLost ? streamFlagSamplesLost : 0)};
+  auto* om = ble_hs_mbuf_from_flat(&header, sizeof(header));
+  if (om != nullptr && os_mbuf_append(om, streamSamples.data(), nbStreamSamples * sizeof(Drivers::Bma421::Sample)) != 0) {
+    os_mbuf_free_chain(om);
+    om = nullptr;
+  }
+  // A dropped notification is detected by the client with the sequence number
+  nimble.notifications().Notify(motionStreamHandle, om, NotificationScheduler::Priority::RealTime);
+  nbStreamSamples = 0;
+  streamSamplesLost = false;
 }
 
 void MotionService::SubscribeNotification(uint16_t attributeHandle) {
@@ -112,6 +247,10 @@ void MotionService::SubscribeNotification(uint16_t attributeHandle) {
     stepCountNoficationEnabled = true;
   else if (attributeHandle == motionValuesHandle)
     motionValuesNoficationEnabled = true;
+  else if (attributeHandle == motionStreamHandle) {
+    motionStreamRestart = true;
+    motionStreamNotificationEnabled = true;
+  }
 }
 
 void MotionService::UnsubscribeNotification(uint16_t attributeHandle) {
@@ -119,8 +258,14 @@ void MotionService::UnsubscribeNotification(uint16_t attributeHandle) {
     stepCountNoficationEnabled = false;
   else if (attributeHandle == motionValuesHandle)
     motionValuesNoficationEnabled = false;
+  else if (attributeHandle == motionStreamHandle)
+    motionStreamNotificationEnabled = false;
 }
 
 bool MotionService::IsMotionNotificationSubscribed() const {
   return motionValuesNoficationEnabled;
 }
+
+bool MotionService::IsMotionStreamSubscribed() const {
+  return motionStreamNotificationEnabled;
+}
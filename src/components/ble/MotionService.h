@@ -1,10 +1,13 @@
 #pragma once
+#include <array>
+#include <atomic>
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
-#include <atomic>
 #undef max
 #undef min
+#include <FreeRTOS.h>
+#include "drivers/Bma421.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -16,24 +19,64 @@ namespace Pinetime {
       MotionService(NimbleController& nimble, Controllers::MotionController& motionController);
       void Init();
       int OnStepCountRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
+      int OnStepHistoryRequested(ble_gatt_access_ctxt* context);
+      int OnActigraphyRequested(ble_gatt_access_ctxt* context);
       void OnNewStepCountValue(uint32_t stepCount);
       void OnNewMotionValues(int16_t x, int16_t y, int16_t z);
+      // Samples read from the FIFO of the accelerometer at time now, the oldest first. overflow is set if samples were
+      // lost before them.
+      // lastSampleTime is the time at which the last of the samples was taken
+      void OnNewMotionSamples(const Drivers::Bma421::Sample* samples, size_t nbSamples, bool overflow, TickType_t lastSampleTime);
 
       void SubscribeNotification(uint16_t attributeHandle);
       void UnsubscribeNotification(uint16_t attributeHandle);
       bool IsMotionNotificationSubscribed() const;
+      bool IsMotionStreamSubscribed() const;
 
     private:
+      // Header of the notifications of the motion stream, followed by count samples
+      struct __attribute__((packed)) StreamHeader {
+        uint16_t sequence;
+        uint32_t time; // Of the first sample, in ticks
+        uint16_t sampleRate;
+        uint8_t count;
+        uint8_t flags;
+      };
+
+      static constexpr uint8_t streamFlagSamplesLost = 0x01;
+      // With the largest MTU (256)
+      static constexpr size_t maxStreamSamples = (256 - 3 - sizeof(StreamHeader)) / sizeof(Drivers::Bma421::Sample);
+      // The samples are sent at least every maxStreamLatency, even if the notification is not full
+      static constexpr TickType_t maxStreamLatency = pdMS_TO_TICKS(250);
+      // Records of the step history in a read, within the 512 bytes of an attribute
+      static constexpr uint16_t historyRecords = 8;
+
       NimbleController& nimble;
       Controllers::MotionController& motionController;
 
-      struct ble_gatt_chr_def characteristicDefinition[3];
+      struct ble_gatt_chr_def characteristicDefinition[6];
       struct ble_gatt_svc_def serviceDefinition[2];
 
       uint16_t stepCountHandle;
       uint16_t motionValuesHandle;
+      uint16_t motionStreamHandle;
+      uint16_t stepHistoryHandle;
+      uint16_t stepHistoryCursor = 0;
+      uint16_t actigraphyHandle;
+      uint16_t actigraphyCursor = 0;
       std::atomic_bool stepCountNoficationEnabled {false};
       std::atomic_bool motionValuesNoficationEnabled {false};
+      std::atomic_bool motionStreamNotificationEnabled {false};
+      std::atomic_bool motionStreamRestart {false};
+
+      std::array<Drivers::Bma421::Sample, maxStreamSamples> streamSamples;
+      size_t nbStreamSamples = 0;
+      TickType_t streamTime = 0;
+      uint16_t streamSequence = 0;
+      bool streamSamplesLost = false;
+
+      size_t StreamCapacity() const;
+      void SendStream();
     };
   }
 }
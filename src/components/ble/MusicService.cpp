@@ -17,6 +17,7 @@
 */
 #include "components/ble/MusicService.h"
 #include "components/ble/NimbleController.h"
+#include <algorithm>
 #include <cstring>
 
 namespace {
@@ -46,7 +47,18 @@ namespace {
   constexpr ble_uuid128_t msRepeatCharUuid {CharUuid(0x0b, 0x00)};
   constexpr ble_uuid128_t msShuffleCharUuid {CharUuid(0x0c, 0x00)};
 
-  constexpr uint8_t MaxStringSize {40};
+  // Copies the string straight from the mbuf chain
+  void CopyText(os_mbuf* om, Pinetime::Controllers::MusicService::Text& text) {
+    const size_t size = OS_MBUF_PKTLEN(om);
+    const size_t length = std::min(size, text.Capacity());
+    os_mbuf_copydata(om, 0, length, text.Data());
+    if (size > length) {
+      text.Data()[length - 1] = '.';
+      text.Data()[length - 2] = '.';
+      text.Data()[length - 3] = '.';
+    }
+    text.Resize(length);
+  }
 
   int MusicCallback(uint16_t /*conn_handle*/, uint16_t /*attr_handle*/, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     return static_cast<Pinetime::Controllers::MusicService*>(arg)->OnCommand(ctxt);
@@ -124,30 +136,23 @@ void Pinetime::Controllers::MusicService::Init() {
 
 int Pinetime::Controllers::MusicService::OnCommand(struct ble_gatt_access_ctxt* ctxt) {
   if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
-    size_t notifSize = OS_MBUF_PKTLEN(ctxt->om);
-    size_t bufferSize = notifSize;
-    if (notifSize > MaxStringSize) {
-      bufferSize = MaxStringSize;
-    }
-
-    char data[bufferSize + 1];
-    os_mbuf_copydata(ctxt->om, 0, bufferSize, data);
-
-    if (notifSize > bufferSize) {
-      data[bufferSize - 1] = '.';
-      data[bufferSize - 2] = '.';
-      data[bufferSize - 3] = '.';
-    }
-    data[bufferSize] = '\0';
-
-    char* s = &data[0];
+    Text* text = nullptr;
     if (ble_uuid_cmp(ctxt->chr->uuid, &msArtistCharUuid.u) == 0) {
-      artistName = s;
+      text = &artistName;
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &msTrackCharUuid.u) == 0) {
-      trackName = s;
+      text = &trackName;
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &msAlbumCharUuid.u) == 0) {
-      albumName = s;
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msStatusCharUuid.u) == 0) {
+      text = &albumName;
+    }
+    if (text != nullptr) {
+      CopyText(ctxt->om, *text);
+      return 0;
+    }
+
+    // The other characteristics are flags and 32-bit integers
+    char s[4] = {};
+    os_mbuf_copydata(ctxt->om, 0, std::min<size_t>(OS_MBUF_PKTLEN(ctxt->om), sizeof(s)), s);
+    if (ble_uuid_cmp(ctxt->chr->uuid, &msStatusCharUuid.u) == 0) {
       playing = s[0];
       // These variables need to be updated, because the progress may not be updated immediately,
       // leading to getProgress() returning an incorrect position.
@@ -177,15 +182,15 @@ int Pinetime::Controllers::MusicService::OnCommand(struct ble_gatt_access_ctxt*
   return 0;
 }
 
-std::string Pinetime::Controllers::MusicService::getAlbum() const {
+const Pinetime::Controllers::MusicService::Text& Pinetime::Controllers::MusicService::getAlbum() const {
   return albumName;
 }
 
-std::string Pinetime::Controllers::MusicService::getArtist() const {
+const Pinetime::Controllers::MusicService::Text& Pinetime::Controllers::MusicService::getArtist() const {
   return artistName;
 }
 
-std::string Pinetime::Controllers::MusicService::getTrack() const {
+const Pinetime::Controllers::MusicService::Text& Pinetime::Controllers::MusicService::getTrack() const {
   return trackName;
 }
 
@@ -210,13 +215,5 @@ int Pinetime::Controllers::MusicService::getTrackLength() const {
 }
 
 void Pinetime::Controllers::MusicService::event(char event) {
-  auto* om = ble_hs_mbuf_from_flat(&event, 1);
-
-  uint16_t connectionHandle = nimble.connHandle();
-
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
-    return;
-  }
-
-  ble_gattc_notify_custom(connectionHandle, eventHandle, om);
+  nimble.notifications().Notify(eventHandle, &event, sizeof(event), NotificationScheduler::Priority::Control);
 }
@@ -18,13 +18,13 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
 #include <host/ble_uuid.h>
 #undef max
 #undef min
+#include "utility/StaticString.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -32,6 +32,10 @@ namespace Pinetime {
 
     class MusicService {
     public:
+      // Longer strings are truncated and end with "..."
+      static constexpr size_t maxStringSize = 40;
+      using Text = Utility::StaticString<maxStringSize>;
+
       explicit MusicService(NimbleController& nimble);
 
       void Init();
@@ -40,11 +44,11 @@ namespace Pinetime {
 
       void event(char event);
 
-      std::string getArtist() const;
+      const Text& getArtist() const;
 
-      std::string getTrack() const;
+      const Text& getTrack() const;
 
-      std::string getAlbum() const;
+      const Text& getAlbum() const;
 
       int getProgress() const;
 
@@ -70,9 +74,9 @@ namespace Pinetime {
 
       uint16_t eventHandle {};
 
-      std::string artistName {"Waiting for"};
-      std::string albumName {};
-      std::string trackName {"track information.."};
+      Text artistName {"Waiting for"};
+      Text albumName {};
+      Text trackName {"track information.."};
 
       bool playing {false};
 
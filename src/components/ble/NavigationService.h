@@ -18,30 +18,35 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
 #include <host/ble_uuid.h>
 #undef max
 #undef min
+#include "utility/StaticString.h"
 
 namespace Pinetime {
   namespace Controllers {
 
     class NavigationService {
     public:
+      // Longer strings are truncated
+      using Flag = Utility::StaticString<32>;
+      using Narrative = Utility::StaticString<96>;
+      using ManDist = Utility::StaticString<16>;
+
       NavigationService();
 
       void Init();
 
       int OnCommand(struct ble_gatt_access_ctxt* ctxt);
 
-      std::string getFlag();
+      const Flag& getFlag() const;
 
-      std::string getNarrative();
+      const Narrative& getNarrative() const;
 
-      std::string getManDist();
+      const ManDist& getManDist() const;
 
       int getProgress();
 
@@ -49,9 +54,9 @@ namespace Pinetime {
       struct ble_gatt_chr_def characteristicDefinition[5];
       struct ble_gatt_svc_def serviceDefinition[2];
 
-      std::string m_flag;
-      std::string m_narrative;
-      std::string m_manDist;
+      Flag m_flag;
+      Narrative m_narrative;
+      ManDist m_manDist;
       int m_progress;
     };
   }
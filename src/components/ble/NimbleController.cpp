@@ -30,13 +30,16 @@ NimbleController::NimbleController(Pinetime::System::SystemTask& systemTask,
                                    Pinetime::Drivers::SpiNorFlash& spiNorFlash,
                                    HeartRateController& heartRateController,
                                    MotionController& motionController,
-                                   FS& fs)
+                                   FS& fs,
+                                   TimerWheel& timerWheel)
   : systemTask {systemTask},
     bleController {bleController},
     dateTimeController {dateTimeController},
     spiNorFlash {spiNorFlash},
     fs {fs},
-    dfuService {systemTask, bleController, spiNorFlash},
+    notificationScheduler {timerWheel},
+    policy {timerWheel},
+    dfuService {systemTask, bleController, spiNorFlash, timerWheel, notificationScheduler},
 
     currentTimeClient {dateTimeController},
     anService {systemTask, notificationManager},
@@ -49,6 +52,7 @@ NimbleController::NimbleController(Pinetime::System::SystemTask& systemTask,
     heartRateService {*this, heartRateController},
     motionService {*this, motionController},
     fsService {systemTask, fs},
+    telemetryService {*this, systemTask.Monitor(), fs},
     serviceDiscovery({&currentTimeClient, &alertNotificationClient}) {
 }
 
@@ -85,6 +89,8 @@ void NimbleController::Init() {
   ble_svc_gap_init();
   ble_svc_gatt_init();
 
+  notificationScheduler.Init();
+
   deviceInformationService.Init();
   currentTimeClient.Init();
   currentTimeService.Init();
@@ -98,6 +104,7 @@ void NimbleController::Init() {
   heartRateService.Init();
   motionService.Init();
   fsService.Init();
+  telemetryService.Init();
 
   int rc;
   rc = ble_hs_util_ensure_addr(0);
@@ -203,6 +210,11 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
         StartAdvertising();
       } else {
         connectionHandle = event->connect.conn_handle;
+        struct ble_gap_conn_desc desc;
+        if (ble_gap_conn_find(connectionHandle, &desc) == 0) {
+          notificationScheduler.OnConnected(connectionHandle, desc.conn_itvl);
+          policy.OnConnected(connectionHandle, desc);
+        }
         bleController.Connect();
         systemTask.PushMessage(Pinetime::System::Messages::BleConnected);
         // Service discovery is deferred via systemtask
@@ -220,6 +232,8 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
 
       currentTimeClient.Reset();
       alertNotificationClient.Reset();
+      notificationScheduler.OnDisconnected();
+      policy.OnDisconnected();
       connectionHandle = BLE_HS_CONN_HANDLE_NONE;
       if (bleController.IsConnected()) {
         bleController.Disconnect();
@@ -228,11 +242,16 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
       }
       break;
 
-    case BLE_GAP_EVENT_CONN_UPDATE:
+    case BLE_GAP_EVENT_CONN_UPDATE: {
       /* The central has updated the connection parameters. */
       NRF_LOG_INFO("Update event : BLE_GAP_EVENT_CONN_UPDATE");
       NRF_LOG_INFO("update status=%0X ", event->conn_update.status);
-      break;
+      struct ble_gap_conn_desc desc;
+      if (ble_gap_conn_find(event->conn_update.conn_handle, &desc) == 0) {
+        notificationScheduler.OnConnectionUpdated(desc.conn_itvl);
+        policy.OnUpdated(event->conn_update.status, desc);
+      }
+    } break;
 
     case BLE_GAP_EVENT_CONN_UPDATE_REQ:
       /* The central has requested updated connection parameters */
@@ -396,7 +415,7 @@ uint16_t NimbleController::connHandle() {
 
 void NimbleController::NotifyBatteryLevel(uint8_t level) {
   if (connectionHandle != BLE_HS_CONN_HANDLE_NONE) {
-    batteryInformationService.NotifyBatteryLevel(connectionHandle, level);
+    batteryInformationService.NotifyBatteryLevel(notificationScheduler, level);
   }
 }
 
@@ -471,6 +490,19 @@ void NimbleController::PersistBond(struct ble_gap_conn_desc& desc) {
   }
 }
 
+void NimbleController::BeginFileAccess() {
+  // Wakes the system up and keeps it awake until EndFileAccess()
+  systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
+  vTaskDelay(10);
+  while (systemTask.IsSleeping()) {
+    vTaskDelay(100);
+  }
+}
+
+void NimbleController::EndFileAccess() {
+  systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+}
+
 void NimbleController::RestoreBond() {
   lfs_file_t file_p;
   union ble_store_value sec, cccd;
@@ -10,6 +10,7 @@
 #include "components/ble/AlertNotificationClient.h"
 #include "components/ble/AlertNotificationService.h"
 #include "components/ble/BatteryInformationService.h"
+#include "components/ble/ConnectionPolicy.h"
 #include "components/ble/CurrentTimeClient.h"
 #include "components/ble/CurrentTimeService.h"
 #include "components/ble/DeviceInformationService.h"
@@ -19,9 +20,11 @@
 #include "components/ble/ImmediateAlertService.h"
 #include "components/ble/MusicService.h"
 #include "components/ble/NavigationService.h"
+#include "components/ble/NotificationScheduler.h"
 #include "components/ble/ServiceDiscovery.h"
 #include "components/ble/MotionService.h"
 #include "components/ble/SimpleWeatherService.h"
+#include "components/ble/TelemetryService.h"
 #include "components/fs/FS.h"
 
 namespace Pinetime {
@@ -49,7 +52,8 @@ namespace Pinetime {
                        Pinetime::Drivers::SpiNorFlash& spiNorFlash,
                        HeartRateController& heartRateController,
                        MotionController& motionController,
-                       FS& fs);
+                       FS& fs,
+                       TimerWheel& timerWheel);
       void Init();
       void StartAdvertising();
       int OnGAPEvent(ble_gap_event* event);
@@ -71,6 +75,14 @@ namespace Pinetime {
         return weatherService;
       };
 
+      Pinetime::Controllers::NotificationScheduler& notifications() {
+        return notificationScheduler;
+      };
+
+      Pinetime::Controllers::ConnectionPolicy& connectionPolicy() {
+        return policy;
+      };
+
       uint16_t connHandle();
       void NotifyBatteryLevel(uint8_t level);
 
@@ -81,6 +93,10 @@ namespace Pinetime {
       void EnableRadio();
       void DisableRadio();
 
+      // The services call these around their accesses to the file system: the flash sleeps with the system task
+      void BeginFileAccess();
+      void EndFileAccess();
+
     private:
       void PersistBond(struct ble_gap_conn_desc& desc);
       void RestoreBond();
@@ -91,6 +107,8 @@ namespace Pinetime {
       DateTime& dateTimeController;
       Pinetime::Drivers::SpiNorFlash& spiNorFlash;
       FS& fs;
+      NotificationScheduler notificationScheduler;
+      ConnectionPolicy policy;
       DfuService dfuService;
 
       DeviceInformationService deviceInformationService;
@@ -106,6 +124,7 @@ namespace Pinetime {
       HeartRateService heartRateService;
       MotionService motionService;
       FSService fsService;
+      TelemetryService telemetryService;
       ServiceDiscovery serviceDiscovery;
 
       uint8_t addrType;
@@ -0,0 +1,174 @@
+#include "components/ble/NotificationScheduler.h"
+#include <algorithm>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gatt.h>
+#include <host/ble_hs_mbuf.h>
+#undef max
+#undef min
+
+using namespace Pinetime::Controllers;
+
+NotificationScheduler::NotificationScheduler(TimerWheel& timerWheel) : timerWheel {timerWheel}, flushTimer {OnFlushTimer, this} {
+}
+
+void NotificationScheduler::Init() {
+  mutex = xSemaphoreCreateMutex();
+}
+
+void NotificationScheduler::OnConnected(uint16_t handle, uint16_t connectionInterval) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  Clear();
+  connectionHandle = handle;
+  xSemaphoreGive(mutex);
+  OnConnectionUpdated(connectionInterval);
+}
+
+void NotificationScheduler::OnConnectionUpdated(uint16_t connectionInterval) {
+  // 1.25ms units
+  interval = std::max<TickType_t>(1, pdMS_TO_TICKS(connectionInterval * 5 / 4));
+}
+
+void NotificationScheduler::OnDisconnected() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  connectionHandle = BLE_HS_CONN_HANDLE_NONE;
+  Clear();
+  timerWheel.Stop(flushTimer);
+  xSemaphoreGive(mutex);
+}
+
+bool NotificationScheduler::Notify(uint16_t attributeHandle, const void* data, uint16_t size, Priority priority) {
+  if (connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    return false;
+  }
+  // The mbuf is allocated when there is room for it, so that it does not take the blocks of the reserve
+  if (!HasRoom(priority)) {
+    statistics[static_cast<uint8_t>(priority)].dropped++;
+    return false;
+  }
+  return Enqueue(attributeHandle, ble_hs_mbuf_from_flat(data, size), priority);
+}
+
+bool NotificationScheduler::Notify(uint16_t attributeHandle, os_mbuf* om, Priority priority) {
+  if (om == nullptr) {
+    statistics[static_cast<uint8_t>(priority)].dropped++;
+    return false;
+  }
+  if (connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    os_mbuf_free_chain(om);
+    return false;
+  }
+  if (!HasRoom(priority)) {
+    os_mbuf_free_chain(om);
+    statistics[static_cast<uint8_t>(priority)].dropped++;
+    return false;
+  }
+  return Enqueue(attributeHandle, om, priority);
+}
+
+bool NotificationScheduler::HasRoom(Priority priority) {
+  const auto index = static_cast<uint8_t>(priority);
+  // A full RealTime queue is not a problem, the oldest value is replaced
+  auto room = [this, index, priority]() {
+    return os_msys_num_free() >= reserve[index] && (priority == Priority::RealTime || queues[index].count < Queue::size);
+  };
+  if (room() || priority != Priority::Bulk) {
+    return room();
+  }
+
+  // Back-pressure: the caller waits for the notifications queued before to be sent
+  statistics[index].waited++;
+  const TickType_t start = xTaskGetTickCount();
+  while (!room()) {
+    if (connectionHandle == BLE_HS_CONN_HANDLE_NONE || xTaskGetTickCount() - start > bulkTimeout) {
+      return false;
+    }
+    vTaskDelay(interval);
+  }
+  return true;
+}
+
+bool NotificationScheduler::Enqueue(uint16_t attributeHandle, os_mbuf* om, Priority priority) {
+  const auto index = static_cast<uint8_t>(priority);
+  if (om == nullptr) {
+    statistics[index].dropped++;
+    return false;
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  auto& queue = queues[index];
+  if (connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    xSemaphoreGive(mutex);
+    os_mbuf_free_chain(om);
+    return false;
+  }
+  if (queue.count == Queue::size) {
+    if (priority != Priority::RealTime) {
+      xSemaphoreGive(mutex);
+      os_mbuf_free_chain(om);
+      statistics[index].dropped++;
+      return false;
+    }
+    // The oldest value is replaced by the new one
+    os_mbuf_free_chain(queue.items[queue.first].om);
+    queue.first = (queue.first + 1) % Queue::size;
+    queue.count--;
+    statistics[index].dropped++;
+  }
+  queue.items[(queue.first + queue.count) % Queue::size] = {om, attributeHandle, xTaskGetTickCount()};
+  queue.count++;
+
+  if (priority == Priority::Control) {
+    Send(priority, Queue::size);
+  } else if (!timerWheel.IsActive(flushTimer)) {
+    timerWheel.Start(flushTimer, interval);
+  }
+  xSemaphoreGive(mutex);
+  return true;
+}
+
+uint8_t NotificationScheduler::Send(Priority priority, uint8_t maxCount) {
+  auto& queue = queues[static_cast<uint8_t>(priority)];
+  auto& stats = statistics[static_cast<uint8_t>(priority)];
+  uint8_t count = 0;
+  while (queue.count > 0 && count < maxCount) {
+    const Pending pending = queue.items[queue.first];
+    queue.first = (queue.first + 1) % Queue::size;
+    queue.count--;
+    count++;
+
+    // The mbuf is freed by NimBLE, even on error
+    if (ble_gattc_notify_custom(connectionHandle, pending.attributeHandle, pending.om) == 0) {
+      stats.sent++;
+      stats.maxLatency = std::max(stats.maxLatency, xTaskGetTickCount() - pending.time);
+    } else {
+      stats.dropped++;
+    }
+  }
+  return count;
+}
+
+void NotificationScheduler::OnFlushTimer(void* context) {
+  static_cast<NotificationScheduler*>(context)->Flush();
+}
+
+void NotificationScheduler::Flush() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  // The RealTime notifications go first, but the Bulk ones get at least one slot per interval
+  const uint8_t sent = Send(Priority::RealTime, maxPerInterval - 1);
+  Send(Priority::Bulk, maxPerInterval - sent);
+  if (queues[static_cast<uint8_t>(Priority::RealTime)].count > 0 || queues[static_cast<uint8_t>(Priority::Bulk)].count > 0) {
+    timerWheel.Start(flushTimer, interval);
+  }
+  xSemaphoreGive(mutex);
+}
+
+void NotificationScheduler::Clear() {
+  for (auto& queue : queues) {
+    while (queue.count > 0) {
+      os_mbuf_free_chain(queue.items[queue.first].om);
+      queue.first = (queue.first + 1) % Queue::size;
+      queue.count--;
+    }
+  }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <task.h>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+#include "components/timer/TimerWheel.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /*
+     * Sends the GATT notifications of all the services.
+     *
+     * The notifications are copied in mbufs of the shared NimBLE pool (MSYS) when they are queued. A notification is
+     * only queued if the pool keeps enough free blocks for the reception and for the notifications of higher
+     * priority, and if its queue is not full. When it is not the case:
+     *  - Control notifications (responses, events) are dropped,
+     *  - RealTime notifications (sensor values) replace the oldest queued one: the latest values are sent,
+     *  - Bulk notifications (listings) wait until there is room, for at most bulkTimeout.
+     *
+     * Control notifications are sent immediately. The other ones are sent together once per connection interval,
+     * at most maxPerInterval of them, so that a stream does not wake up the host for each value. Notify() can be
+     * called from any task.
+     */
+    class NotificationScheduler {
+    public:
+      enum class Priority : uint8_t { Control, RealTime, Bulk };
+      static constexpr uint8_t nbPriorities = 3;
+
+      struct Statistics {
+        uint32_t sent;
+        uint32_t dropped;
+        uint32_t waited;      // Notifications that were delayed by the back-pressure (Bulk)
+        TickType_t maxLatency; // Between Notify() and the transmission to the host
+      };
+
+      explicit NotificationScheduler(TimerWheel& timerWheel);
+      NotificationScheduler(const NotificationScheduler&) = delete;
+      NotificationScheduler& operator=(const NotificationScheduler&) = delete;
+
+      void Init();
+
+      // connectionInterval in units of 1.25ms, as reported by NimBLE
+      void OnConnected(uint16_t connectionHandle, uint16_t connectionInterval);
+      void OnConnectionUpdated(uint16_t connectionInterval);
+      void OnDisconnected();
+
+      // Returns false if the notification is dropped (or if there is no connection)
+      bool Notify(uint16_t attributeHandle, const void* data, uint16_t size, Priority priority);
+      // Takes the ownership of om, which is freed if the notification is dropped
+      bool Notify(uint16_t attributeHandle, os_mbuf* om, Priority priority);
+
+      const Statistics& GetStatistics(Priority priority) const {
+        return statistics[static_cast<uint8_t>(priority)];
+      }
+
+    private:
+      struct Pending {
+        os_mbuf* om;
+        uint16_t attributeHandle;
+        TickType_t time;
+      };
+
+      struct Queue {
+        static constexpr uint8_t size = 4;
+        std::array<Pending, size> items;
+        uint8_t first = 0;
+        uint8_t count = 0;
+      };
+
+      // Free blocks of the pool that a notification of each priority must leave
+      static constexpr std::array<uint8_t, nbPriorities> reserve = {2, 4, 6};
+      static constexpr uint8_t maxPerInterval = 4;
+      static constexpr TickType_t bulkTimeout = pdMS_TO_TICKS(2000);
+
+      TimerWheel& timerWheel;
+      TimerWheel::Timer flushTimer;
+      SemaphoreHandle_t mutex = nullptr;
+      uint16_t connectionHandle = BLE_HS_CONN_HANDLE_NONE;
+      TickType_t interval = 1;
+
+      std::array<Queue, nbPriorities> queues;
+      std::array<Statistics, nbPriorities> statistics {};
+
+      static void OnFlushTimer(void* context);
+      bool HasRoom(Priority priority);
+      bool Enqueue(uint16_t attributeHandle, os_mbuf* om, Priority priority);
+      // Returns the number of notifications taken from the queue
+      uint8_t Send(Priority priority, uint8_t maxCount);
+      void Flush();
+      void Clear();
+    };
+  }
+}
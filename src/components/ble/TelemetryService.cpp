@@ -0,0 +1,269 @@
+#include "components/ble/TelemetryService.h"
+#include "components/ble/NimbleController.h"
+#include "components/fs/FS.h"
+#include "logging/Trace.h"
+#include "systemtask/SystemMonitor.h"
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // 0006yyxx-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t CharUuid(uint8_t x, uint8_t y) {
+    return ble_uuid128_t {.u = {.type = BLE_UUID_TYPE_128},
+                          .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, x, y, 0x06, 0x00}};
+  }
+
+  // 00060000-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t BaseUuid() {
+    return CharUuid(0x00, 0x00);
+  }
+
+  constexpr ble_uuid128_t telemetryServiceUuid {BaseUuid()};
+  constexpr ble_uuid128_t memoryCharUuid {CharUuid(0x01, 0x00)};
+  constexpr ble_uuid128_t previousRunCharUuid {CharUuid(0x02, 0x00)};
+  constexpr ble_uuid128_t cpuCharUuid {CharUuid(0x03, 0x00)};
+  constexpr ble_uuid128_t traceCharUuid {CharUuid(0x04, 0x00)};
+  constexpr ble_uuid128_t notificationsCharUuid {CharUuid(0x05, 0x00)};
+  constexpr ble_uuid128_t connectionCharUuid {CharUuid(0x06, 0x00)};
+  constexpr ble_uuid128_t fileSystemCharUuid {CharUuid(0x07, 0x00)};
+
+  int TelemetryServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    auto* telemetryService = static_cast<TelemetryService*>(arg);
+    return telemetryService->OnTelemetryRequested(attr_handle, ctxt);
+  }
+
+  int AppendSummary(os_mbuf* om, const Pinetime::System::SystemMonitor::Summary& summary) {
+    int res = os_mbuf_append(om, &summary.minFreeHeap, sizeof(summary.minFreeHeap));
+    res |= os_mbuf_append(om, &summary.minLargestFreeBlock, sizeof(summary.minLargestFreeBlock));
+    res |= os_mbuf_append(om, &summary.mallocFailures, sizeof(summary.mallocFailures));
+    res |= os_mbuf_append(om, &summary.stackOverflows, sizeof(summary.stackOverflows));
+    res |= os_mbuf_append(om, &summary.minFreeStack, sizeof(summary.minFreeStack));
+    res |= os_mbuf_append(om, summary.minFreeStackTask, sizeof(summary.minFreeStackTask));
+    return res;
+  }
+
+#ifdef INFINITIME_TRACE
+  // Header of the trace file, followed by the records from the oldest to the newest
+  struct TraceFileHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t recordSize;
+    uint16_t count;
+    uint32_t total;
+    uint32_t cycleFrequency;
+    uint32_t tickFrequency;
+  };
+#endif
+}
+
+TelemetryService::TelemetryService(NimbleController& nimble, const System::SystemMonitor& systemMonitor, FS& fs)
+  : nimble {nimble},
+    systemMonitor {systemMonitor},
+    fs {fs},
+    characteristicDefinition {{.uuid = &memoryCharUuid.u,
+                               .access_cb = TelemetryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &memoryHandle},
+                              {.uuid = &previousRunCharUuid.u,
+                               .access_cb = TelemetryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &previousRunHandle},
+                              {.uuid = &cpuCharUuid.u,
+                               .access_cb = TelemetryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &cpuHandle},
+                              {.uuid = &traceCharUuid.u,
+                               .access_cb = TelemetryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+                               .val_handle = &traceHandle},
+                              {.uuid = &notificationsCharUuid.u,
+                               .access_cb = TelemetryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &notificationsHandle},
+                              {.uuid = &connectionCharUuid.u,
+                               .access_cb = TelemetryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &connectionHandle},
+                              {.uuid = &fileSystemCharUuid.u,
+                               .access_cb = TelemetryServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+                               .val_handle = &fileSystemHandle},
+                              {0}},
+    serviceDefinition {
+      {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &telemetryServiceUuid.u, .characteristics = characteristicDefinition},
+      {0},
+    } {
+}
+
+void TelemetryService::Init() {
+  int res = 0;
+  res = ble_gatts_count_cfg(serviceDefinition);
+  ASSERT(res == 0);
+
+  res = ble_gatts_add_svcs(serviceDefinition);
+  ASSERT(res == 0);
+}
+
+int TelemetryService::OnTelemetryRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+  if (attributeHandle == traceHandle) {
+    return OnTraceRequested(context);
+  }
+  if (attributeHandle == fileSystemHandle) {
+    return OnFileSystemRequested(context);
+  }
+
+  int res = 0;
+  if (attributeHandle == memoryHandle) {
+    uint32_t heap[2] = {systemMonitor.FreeHeap(), systemMonitor.LargestFreeBlock()};
+    res = os_mbuf_append(context->om, heap, sizeof(heap));
+    res |= AppendSummary(context->om, systemMonitor.CurrentRun());
+
+    uint8_t nbTasks = systemMonitor.NbTasks();
+    res |= os_mbuf_append(context->om, &nbTasks, sizeof(nbTasks));
+    for (size_t i = 0; i < nbTasks; i++) {
+      const auto& task = systemMonitor.Tasks()[i];
+      res |= os_mbuf_append(context->om, task.name, sizeof(task.name));
+      res |= os_mbuf_append(context->om, &task.freeStack, sizeof(task.freeStack));
+      res |= os_mbuf_append(context->om, &task.allocations, sizeof(task.allocations));
+    }
+  } else if (attributeHandle == previousRunHandle) {
+    res = AppendSummary(context->om, systemMonitor.PreviousRun());
+  } else if (attributeHandle == cpuHandle) {
+    uint32_t loadPeriod = systemMonitor.LoadPeriod();
+    res = os_mbuf_append(context->om, &loadPeriod, sizeof(loadPeriod));
+
+    uint8_t nbTasks = systemMonitor.NbTasks();
+    res |= os_mbuf_append(context->om, &nbTasks, sizeof(nbTasks));
+    for (size_t i = 0; i < nbTasks; i++) {
+      const auto& task = systemMonitor.Tasks()[i];
+      res |= os_mbuf_append(context->om, task.name, sizeof(task.name));
+      res |= os_mbuf_append(context->om, &task.cpuLoad, sizeof(task.cpuLoad));
+    }
+
+    const auto& sleeps = systemMonitor.Sleeps();
+    uint8_t nbBins = portSLEEP_HISTOGRAM_BINS;
+    res |= os_mbuf_append(context->om, &nbBins, sizeof(nbBins));
+    res |= os_mbuf_append(context->om, sleeps.counts, sizeof(sleeps.counts));
+    res |= os_mbuf_append(context->om, sleeps.ticks, sizeof(sleeps.ticks));
+  } else if (attributeHandle == notificationsHandle) {
+    for (uint8_t i = 0; i < NotificationScheduler::nbPriorities; i++) {
+      const auto& statistics = nimble.notifications().GetStatistics(static_cast<NotificationScheduler::Priority>(i));
+      uint32_t values[4] = {statistics.sent, statistics.dropped, statistics.waited, statistics.maxLatency};
+      res |= os_mbuf_append(context->om, values, sizeof(values));
+    }
+  } else if (attributeHandle == connectionHandle) {
+    const auto& connectionPolicy = nimble.connectionPolicy();
+    uint16_t parameters[3] = {connectionPolicy.Interval(), connectionPolicy.Latency(), connectionPolicy.SupervisionTimeout()};
+    res = os_mbuf_append(context->om, parameters, sizeof(parameters));
+    uint32_t requests[2] = {connectionPolicy.Requests(), connectionPolicy.Failures()};
+    res |= os_mbuf_append(context->om, requests, sizeof(requests));
+    uint8_t profile = static_cast<uint8_t>(connectionPolicy.Requested());
+    res |= os_mbuf_append(context->om, &profile, sizeof(profile));
+
+    const auto& residency = connectionPolicy.Residency();
+    const TickType_t now = xTaskGetTickCount();
+    for (uint8_t i = 0; i < ConnectionPolicy::nbProfiles; i++) {
+      const auto state = static_cast<ConnectionPolicy::Profiles>(i);
+      uint32_t values[2] = {residency.TimeIn(state, now), residency.Entries(state)};
+      res |= os_mbuf_append(context->om, values, sizeof(values));
+    }
+  }
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
+int TelemetryService::OnTraceRequested(ble_gatt_access_ctxt* context) {
+  if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+    uint8_t command = 0;
+    if (OS_MBUF_PKTLEN(context->om) != 1 || os_mbuf_copydata(context->om, 0, 1, &command) != 0) {
+      return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    if (command != traceCommandDump) {
+      return BLE_ATT_ERR_UNLIKELY;
+    }
+    return DumpTrace();
+  }
+
+#ifdef INFINITIME_TRACE
+  uint16_t capacity = Logging::Trace::capacity;
+  uint16_t count = Logging::Trace::Count();
+  uint32_t total = Logging::Trace::Total();
+#else
+  uint16_t capacity = 0;
+  uint16_t count = 0;
+  uint32_t total = 0;
+#endif
+  int res = os_mbuf_append(context->om, &capacity, sizeof(capacity));
+  res |= os_mbuf_append(context->om, &count, sizeof(count));
+  res |= os_mbuf_append(context->om, &total, sizeof(total));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
+int TelemetryService::OnFileSystemRequested(ble_gatt_access_ctxt* context) {
+  if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+    uint8_t command = 0;
+    if (OS_MBUF_PKTLEN(context->om) != 1 || os_mbuf_copydata(context->om, 0, 1, &command) != 0) {
+      return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    if (command != fileSystemCommandReset) {
+      return BLE_ATT_ERR_UNLIKELY;
+    }
+    fs.ResetStatistics();
+    return 0;
+  }
+
+  // The file system is not accessed: the flash may be asleep, and it is used by the other tasks
+  uint16_t configuration[4] = {FS::lookaheadSize, FS::progSize, FS::cacheSize, FS::nbLatencyBins};
+  int res = os_mbuf_append(context->om, configuration, sizeof(configuration));
+  const auto& statistics = fs.GetStatistics();
+  uint32_t counters[3] = {statistics.programs, statistics.erases, statistics.writes};
+  res |= os_mbuf_append(context->om, counters, sizeof(counters));
+  res |= os_mbuf_append(context->om, statistics.writeLatency.data(), sizeof(statistics.writeLatency));
+  uint32_t maintenance[4] = {statistics.maxWriteLatency,
+                             statistics.maintenances,
+                             statistics.lastMaintenanceDuration,
+                             static_cast<uint32_t>(statistics.lastMaintenanceResult)};
+  res |= os_mbuf_append(context->om, maintenance, sizeof(maintenance));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
+int TelemetryService::DumpTrace() {
+#ifdef INFINITIME_TRACE
+  nimble.BeginFileAccess();
+  lfs_file_t file;
+  if (fs.FileOpen(&file, traceFileName, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) != LFS_ERR_OK) {
+    nimble.EndFileAccess();
+    return BLE_ATT_ERR_UNLIKELY;
+  }
+
+  // The events that occur while the file is written are not recorded
+  Logging::Trace::Pause();
+  const TraceFileHeader header {.magic = {'I', 'T', 'R', 'C'},
+                                .version = 1,
+                                .recordSize = sizeof(Logging::Trace::Record),
+                                .count = static_cast<uint16_t>(Logging::Trace::Count()),
+                                .total = Logging::Trace::Total(),
+                                .cycleFrequency = SystemCoreClock,
+                                .tickFrequency = configTICK_RATE_HZ};
+  int res = fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  for (size_t i = 0; i < header.count && res >= 0; i++) {
+    res = fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&Logging::Trace::Get(i)), sizeof(Logging::Trace::Record));
+  }
+  Logging::Trace::Resume();
+
+  const bool closed = fs.FileClose(&file) == LFS_ERR_OK;
+  nimble.EndFileAccess();
+  if (!closed || res < 0) {
+    return BLE_ATT_ERR_UNLIKELY;
+  }
+  return 0;
+#else
+  return BLE_ATT_ERR_REQ_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+
+namespace Pinetime {
+  namespace System {
+    class SystemMonitor;
+  }
+
+  namespace Controllers {
+    class FS;
+    class NimbleController;
+
+    class TelemetryService {
+    public:
+      TelemetryService(NimbleController& nimble, const System::SystemMonitor& systemMonitor, FS& fs);
+      void Init();
+
+      int OnTelemetryRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
+
+    private:
+      NimbleController& nimble;
+      const System::SystemMonitor& systemMonitor;
+      FS& fs;
+
+      struct ble_gatt_chr_def characteristicDefinition[8];
+      struct ble_gatt_svc_def serviceDefinition[2];
+
+      uint16_t memoryHandle;
+      uint16_t previousRunHandle;
+      uint16_t cpuHandle;
+      uint16_t traceHandle;
+      uint16_t notificationsHandle;
+      uint16_t connectionHandle;
+      uint16_t fileSystemHandle;
+
+      static constexpr uint8_t traceCommandDump = 0x01;
+      static constexpr const char* traceFileName = "/trace.bin";
+      static constexpr uint8_t fileSystemCommandReset = 0x01;
+
+      int OnTraceRequested(ble_gatt_access_ctxt* context);
+      int DumpTrace();
+      int OnFileSystemRequested(ble_gatt_access_ctxt* context);
+    };
+  }
+}
@@ -125,7 +125,7 @@ void DateTime::Register(Pinetime::System::SystemTask* systemTask) {
 
 using ClockType = Pinetime::Controllers::Settings::ClockType;
 
-std::string DateTime::FormattedTime() {
+Pinetime::Utility::StaticString<8> DateTime::FormattedTime() {
   auto hour = Hours();
   auto minute = Minutes();
   // Return time as a string in 12- or 24-hour format
@@ -144,5 +144,5 @@ std::string DateTime::FormattedTime() {
   } else {
     snprintf(buff, sizeof(buff), "%02i:%02i", hour, minute);
   }
-  return std::string(buff);
+  return Utility::StaticString<8>(buff);
 }
@@ -3,8 +3,8 @@
 #include <cstdint>
 #include <chrono>
 #include <ctime>
-#include <string>
 #include "components/settings/Settings.h"
+#include "utility/StaticString.h"
 
 namespace Pinetime {
   namespace System {
@@ -138,7 +138,7 @@ namespace Pinetime {
 
       void Register(System::SystemTask* systemTask);
       void SetCurrentTime(std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> t);
-      std::string FormattedTime();
+      Utility::StaticString<8> FormattedTime();
 
     private:
       std::tm localTime;
@@ -1,10 +1,30 @@
 #include "components/fs/FS.h"
 #include <cstring>
+#include <algorithm>
 #include <littlefs/lfs.h>
-#include <lvgl/lvgl.h>
+#include <task.h>
 
 using namespace Pinetime::Controllers;
 
+namespace {
+  class Lock {
+  public:
+    explicit Lock(SemaphoreHandle_t mutex) : mutex {mutex} {
+      xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    }
+
+    ~Lock() {
+      xSemaphoreGiveRecursive(mutex);
+    }
+
+    Lock(const Lock&) = delete;
+    Lock& operator=(const Lock&) = delete;
+
+  private:
+    SemaphoreHandle_t mutex;
+  };
+}
+
 FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
   : flashDriver {driver},
     lfsConfig {
@@ -14,21 +34,27 @@ FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
       .erase = SectorErase,
       .sync = SectorSync,
 
-      .read_size = 16,
-      .prog_size = 8,
+      .read_size = readSize,
+      .prog_size = progSize,
       .block_size = blockSize,
       .block_count = size / blockSize,
       .block_cycles = 1000u,
 
-      .cache_size = 16,
-      .lookahead_size = 16,
+      .cache_size = cacheSize,
+      // With the default size, the lookahead window covers the whole file system: the allocator scans the metadata
+      // once to find the free blocks, instead of once per 128 blocks with a buffer of 16 bytes
+      .lookahead_size = lookaheadSize,
 
       .name_max = 50,
-      .attr_max = 50,
+      .attr_max = maxAttributeSize,
     } {
+  static_assert(lookaheadSize > 0 && lookaheadSize % 8 == 0, "The lookahead size must be a multiple of 8");
+  static_assert(cacheSize % progSize == 0 && blockSize % cacheSize == 0, "The prog size must divide the block size");
 }
 
 void FS::Init() {
+  mutex = xSemaphoreCreateRecursiveMutex();
+  Lock lock {mutex};
 
   // try mount
   int err = lfs_mount(&lfs, &lfsConfig);
@@ -49,66 +75,183 @@ void FS::Init() {
 }
 
 void FS::VerifyResource() {
+  Lock lock {mutex};
   // validate the resource metadata
-  resourcesValid = true;
+  resources.Load();
+  resourcesValid = resources.AllValid();
+}
+
+bool FS::IsResourceAvailable(const char* path) {
+  Lock lock {mutex};
+  switch (resources.GetStatus(path)) {
+    case ResourceIndex::Status::Valid:
+      return true;
+    case ResourceIndex::Status::Invalid:
+      return false;
+    default:
+      break;
+  }
+  // Resource package without manifest, or resource installed separately
+  lfs_info info;
+  return Stat(path, &info) == LFS_ERR_OK && info.type == LFS_TYPE_REG;
+}
+
+void FS::ResourceUpdated(const char* path) {
+  Lock lock {mutex};
+  resources.Update(path);
+  resourcesValid = resources.AllValid();
+}
+
+int FS::CommitResources() {
+  Lock lock {mutex};
+  const int res = resources.Commit();
+  resourcesValid = resources.AllValid();
+  return res;
 }
 
 int FS::FileOpen(lfs_file_t* file_p, const char* fileName, const int flags) {
+  Lock lock {mutex};
   return lfs_file_open(&lfs, file_p, fileName, flags);
 }
 
 int FS::FileClose(lfs_file_t* file_p) {
-  return lfs_file_close(&lfs, file_p);
+  Lock lock {mutex};
+  // The data written to a file is committed when it is closed
+  if ((file_p->flags & LFS_O_WRONLY) == 0) {
+    return lfs_file_close(&lfs, file_p);
+  }
+  const TickType_t start = xTaskGetTickCount();
+  const int res = lfs_file_close(&lfs, file_p);
+  RecordWrite(start);
+  return res;
 }
 
 int FS::FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size) {
+  Lock lock {mutex};
   return lfs_file_read(&lfs, file_p, buff, size);
 }
 
 int FS::FileWrite(lfs_file_t* file_p, const uint8_t* buff, uint32_t size) {
-  return lfs_file_write(&lfs, file_p, buff, size);
+  Lock lock {mutex};
+  const TickType_t start = xTaskGetTickCount();
+  const int res = lfs_file_write(&lfs, file_p, buff, size);
+  RecordWrite(start);
+  return res;
 }
 
 int FS::FileSeek(lfs_file_t* file_p, uint32_t pos) {
+  Lock lock {mutex};
   return lfs_file_seek(&lfs, file_p, pos, LFS_SEEK_SET);
 }
 
 int FS::FileDelete(const char* fileName) {
-  return lfs_remove(&lfs, fileName);
+  Lock lock {mutex};
+  const TickType_t start = xTaskGetTickCount();
+  const int res = lfs_remove(&lfs, fileName);
+  RecordWrite(start);
+  return res;
 }
 
 int FS::DirOpen(const char* path, lfs_dir_t* lfs_dir) {
+  Lock lock {mutex};
   return lfs_dir_open(&lfs, lfs_dir, path);
 }
 
 int FS::DirClose(lfs_dir_t* lfs_dir) {
+  Lock lock {mutex};
   return lfs_dir_close(&lfs, lfs_dir);
 }
 
 int FS::DirRead(lfs_dir_t* dir, lfs_info* info) {
+  Lock lock {mutex};
   return lfs_dir_read(&lfs, dir, info);
 }
 
 int FS::DirRewind(lfs_dir_t* dir) {
+  Lock lock {mutex};
   return lfs_dir_rewind(&lfs, dir);
 }
 
 int FS::DirCreate(const char* path) {
-  return lfs_mkdir(&lfs, path);
+  Lock lock {mutex};
+  const TickType_t start = xTaskGetTickCount();
+  const int res = lfs_mkdir(&lfs, path);
+  RecordWrite(start);
+  return res;
 }
 
 int FS::Rename(const char* oldPath, const char* newPath) {
-  return lfs_rename(&lfs, oldPath, newPath);
+  Lock lock {mutex};
+  const TickType_t start = xTaskGetTickCount();
+  const int res = lfs_rename(&lfs, oldPath, newPath);
+  RecordWrite(start);
+  return res;
 }
 
 int FS::Stat(const char* path, lfs_info* info) {
+  Lock lock {mutex};
   return lfs_stat(&lfs, path, info);
 }
 
+lfs_ssize_t FS::GetAttribute(const char* path, uint8_t type, void* buffer, lfs_size_t size) {
+  Lock lock {mutex};
+  return lfs_getattr(&lfs, path, type, buffer, size);
+}
+
+int FS::SetAttribute(const char* path, uint8_t type, const void* buffer, lfs_size_t size) {
+  Lock lock {mutex};
+  const TickType_t start = xTaskGetTickCount();
+  const int res = lfs_setattr(&lfs, path, type, buffer, size);
+  RecordWrite(start);
+  return res;
+}
+
 lfs_ssize_t FS::GetFSSize() {
+  Lock lock {mutex};
   return lfs_fs_size(&lfs);
 }
 
+bool FS::MaintenanceDue() const {
+  return statistics.programs != programsAtMaintenance &&
+         (statistics.maintenances == 0 || xTaskGetTickCount() - maintenanceTime >= maintenanceInterval);
+}
+
+void FS::Maintain() {
+  Lock lock {mutex};
+  const TickType_t start = xTaskGetTickCount();
+  int res = LFS_ERR_OK;
+#if LFS_VERSION >= 0x00020006
+  res = lfs_fs_mkconsistent(&lfs);
+#endif
+#if LFS_VERSION >= 0x00020008
+  if (res == LFS_ERR_OK) {
+    res = lfs_fs_gc(&lfs);
+  }
+#endif
+  maintenanceTime = xTaskGetTickCount();
+  programsAtMaintenance = statistics.programs;
+  statistics.maintenances++;
+  statistics.lastMaintenanceDuration = (maintenanceTime - start) * 1000 / configTICK_RATE_HZ;
+  statistics.lastMaintenanceResult = res;
+}
+
+void FS::ResetStatistics() {
+  Lock lock {mutex};
+  statistics = {};
+  programsAtMaintenance = 0;
+}
+
+void FS::RecordWrite(TickType_t start) {
+  const uint32_t latency = (xTaskGetTickCount() - start) * 1000 / configTICK_RATE_HZ;
+  uint8_t bin = 0;
+  while (bin < nbLatencyBins - 1 && latency >= (1u << bin)) {
+    bin++;
+  }
+  statistics.writes++;
+  statistics.writeLatency[bin]++;
+  statistics.maxWriteLatency = std::max(statistics.maxWriteLatency, latency);
+}
+
 /*
 
     ----------- Interface between littlefs and SpiNorFlash -----------
@@ -121,6 +264,7 @@ int FS::SectorSync(const struct lfs_config* /*c*/) {
 int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize);
+  lfs.statistics.erases++;
   lfs.flashDriver.SectorErase(address);
   return lfs.flashDriver.EraseFailed() ? -1 : 0;
 }
@@ -128,6 +272,7 @@ int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
 int FS::SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize) + off;
+  lfs.statistics.programs++;
   lfs.flashDriver.Write(address, (uint8_t*) buffer, size);
   return lfs.flashDriver.ProgramFailed() ? -1 : 0;
 }
@@ -1,13 +1,46 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include "drivers/SpiNorFlash.h"
+#include "components/fs/ResourceIndex.h"
 #include <littlefs/lfs.h>
 
+// Size of the lookahead buffer of the allocator, in bytes (8 blocks per byte). Set with -DFS_LOOKAHEAD_SIZE.
+#ifndef INFINITIME_FS_LOOKAHEAD_SIZE
+  #define INFINITIME_FS_LOOKAHEAD_SIZE 112
+#endif
+// Minimum size of a program operation, in bytes. Set with -DFS_PROG_SIZE.
+#ifndef INFINITIME_FS_PROG_SIZE
+  #define INFINITIME_FS_PROG_SIZE 8
+#endif
+
 namespace Pinetime {
   namespace Controllers {
+    /*
+     * littlefs is not reentrant: the functions below are called from several tasks (system, display, BLE, heart
+     * rate), they are serialized by a recursive mutex. A file or directory must only be used by one task at a time.
+     */
     class FS {
     public:
+      static constexpr uint8_t nbLatencyBins = 12;
+
+      struct Statistics {
+        uint32_t programs;
+        uint32_t erases;
+        // Operations that write (write, close, attribute, rename, delete, mkdir)
+        uint32_t writes;
+        // Duration of the writes: bin 0 counts the writes below 1ms, bin i the writes from 2^(i-1) to 2^i ms, the last
+        // bin the longer ones
+        std::array<uint32_t, nbLatencyBins> writeLatency;
+        uint32_t maxWriteLatency; // ms
+        uint32_t maintenances;
+        uint32_t lastMaintenanceDuration; // ms
+        int32_t lastMaintenanceResult;
+      };
+
       FS(Pinetime::Drivers::SpiNorFlash&);
 
       void Init();
@@ -26,11 +59,50 @@ namespace Pinetime {
       int DirRewind(lfs_dir_t* dir);
       int DirCreate(const char* path);
 
+      // Number of blocks in use
       lfs_ssize_t GetFSSize();
       int Rename(const char* oldPath, const char* newPath);
       int Stat(const char* path, lfs_info* info);
+      // Custom attributes (type 0-255) of a file, stored in the metadata log of its directory. Setting an attribute
+      // appends a small commit to this log, the content of the file is not rewritten.
+      lfs_ssize_t GetAttribute(const char* path, uint8_t type, void* buffer, lfs_size_t size);
+      int SetAttribute(const char* path, uint8_t type, const void* buffer, lfs_size_t size);
       void VerifyResource();
 
+      // Returns true if the resource (font, image) at path is installed and intact. The resources listed in the
+      // manifest of the resource package are checked in RAM, the others in the file system.
+      bool IsResourceAvailable(const char* path);
+      // Must be called when a file is written, deleted or renamed from outside of the firmware (BLE FS API)
+      void ResourceUpdated(const char* path);
+      // Installs the resource package staged by the companion app (see ResourceIndex), returns a littlefs error code
+      int CommitResources();
+
+      const ResourceIndex& Resources() const {
+        return resources;
+      }
+
+      /*
+       * Maintenance of the file system, run while the watch is idle so that the writes of the applications do not
+       * have to do it: completes the operations interrupted by a power loss, fills the lookahead buffer of the
+       * allocator (littlefs >= 2.8) and compacts the metadata logs that are almost full (littlefs >= 2.9). The flash
+       * must be awake. The maintenance is due if the file system was written since the last one, at most every
+       * maintenanceInterval.
+       */
+      bool MaintenanceDue() const;
+      void Maintain();
+
+      const Statistics& GetStatistics() const {
+        return statistics;
+      }
+
+      void ResetStatistics();
+
+      static constexpr size_t lookaheadSize = INFINITIME_FS_LOOKAHEAD_SIZE;
+      // Changing it may make the existing file systems unreadable
+      static constexpr size_t progSize = INFINITIME_FS_PROG_SIZE;
+      static constexpr size_t readSize = 16;
+      static constexpr size_t cacheSize = (progSize > readSize) ? progSize : readSize;
+
       static size_t getSize() {
         return size;
       }
@@ -39,6 +111,8 @@ namespace Pinetime {
         return blockSize;
       }
 
+      static constexpr size_t maxAttributeSize = 50;
+
     private:
       Pinetime::Drivers::SpiNorFlash& flashDriver;
 
@@ -67,11 +141,20 @@ namespace Pinetime {
       static constexpr size_t startAddress = 0x0B4000;
       static constexpr size_t size = 0x34C000;
       static constexpr size_t blockSize = 4096;
+      static constexpr TickType_t maintenanceInterval = pdMS_TO_TICKS(10 * 60 * 1000);
 
       bool resourcesValid = false;
+      ResourceIndex resources {*this};
       const struct lfs_config lfsConfig;
 
       lfs_t lfs;
+      SemaphoreHandle_t mutex = nullptr;
+
+      Statistics statistics {};
+      uint32_t programsAtMaintenance = 0;
+      TickType_t maintenanceTime = 0;
+
+      void RecordWrite(TickType_t start);
 
       static int SectorSync(const struct lfs_config* c);
       static int SectorErase(const struct lfs_config* c, lfs_block_t block);
@@ -0,0 +1,219 @@
+#include "components/fs/ResourceIndex.h"
+#include "components/fs/FS.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // CRC-32 of a nibble (reflected polynomial 0xEDB88320)
+  constexpr std::array<uint32_t, 16> crcTable = {0x00000000,
+                                                 0x1DB71064,
+                                                 0x3B6E20C8,
+                                                 0x26D930AC,
+                                                 0x76DC4190,
+                                                 0x6B6B51F4,
+                                                 0x4DB26158,
+                                                 0x5005713C,
+                                                 0xEDB88320,
+                                                 0xF00F9344,
+                                                 0xD6D6A3E8,
+                                                 0xCB61B38C,
+                                                 0x9B64C2B0,
+                                                 0x86D3D2D4,
+                                                 0xA00AE278,
+                                                 0xBDBDF21C};
+}
+
+ResourceIndex::ResourceIndex(FS& fs) : fs {fs} {
+}
+
+template <typename Callback>
+bool ResourceIndex::ForEachRecord(const char* manifest, Callback&& callback) {
+  lfs_file_t file;
+  if (fs.FileOpen(&file, manifest, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+
+  ManifestHeader header;
+  const bool valid = fs.FileRead(&file, reinterpret_cast<uint8_t*>(&header), sizeof(header)) == static_cast<int>(sizeof(header)) &&
+                     header.magic == manifestMagic && header.version == manifestVersion;
+  for (uint16_t i = 0; valid && i < header.count; i++) {
+    ManifestRecord record;
+    char path[maxPathLength + 1];
+    if (fs.FileRead(&file, reinterpret_cast<uint8_t*>(&record), sizeof(record)) != static_cast<int>(sizeof(record)) ||
+        record.pathLength > maxPathLength || fs.FileRead(&file, reinterpret_cast<uint8_t*>(path), record.pathLength) != record.pathLength) {
+      break;
+    }
+    path[record.pathLength] = '\0';
+    if (!callback(record, path)) {
+      break;
+    }
+  }
+  fs.FileClose(&file);
+  return valid;
+}
+
+bool ResourceIndex::Contains(const char* manifest, uint32_t pathHash) {
+  bool found = false;
+  ForEachRecord(manifest, [pathHash, &found](const ManifestRecord& record, const char* /*path*/) {
+    found = (record.pathHash == pathHash);
+    return !found;
+  });
+  return found;
+}
+
+void ResourceIndex::Load() {
+  nbEntries = 0;
+  loaded = false;
+
+  lfs_info info;
+  if (fs.Stat(commitPath, &info) == LFS_ERR_OK) {
+    // The installation of a package was interrupted
+    Apply();
+  }
+
+  loaded = ForEachRecord(manifestPath, [this](const ManifestRecord& record, const char* path) {
+    if (nbEntries == maxResources) {
+      // The resources that do not fit in the index are Unknown: their availability is checked in the file system
+      return false;
+    }
+    entries[nbEntries++] = {record.pathHash, record.size, record.crc, Verify(record.size, record.crc, path)};
+    return true;
+  });
+
+  std::sort(entries.begin(), entries.begin() + nbEntries, [](const Entry& a, const Entry& b) {
+    return a.pathHash < b.pathHash;
+  });
+}
+
+ResourceIndex::Status ResourceIndex::GetStatus(const char* path) const {
+  const int index = Find(Hash(path));
+  if (index < 0) {
+    return Status::Unknown;
+  }
+  return entries[index].valid ? Status::Valid : Status::Invalid;
+}
+
+void ResourceIndex::Update(const char* path) {
+  if (std::strcmp(path, manifestPath) == 0) {
+    Load();
+    return;
+  }
+  const int index = Find(Hash(path));
+  if (index >= 0) {
+    entries[index].valid = Verify(entries[index].size, entries[index].crc, path);
+  }
+}
+
+int ResourceIndex::Commit() {
+  lfs_info info;
+  if (fs.Stat(stagedManifestPath, &info) != LFS_ERR_OK) {
+    return LFS_ERR_NOENT;
+  }
+
+  bool complete = true;
+  const bool valid = ForEachRecord(stagedManifestPath, [this, &complete](const ManifestRecord& record, const char* path) {
+    char stagedPath[maxPathLength + sizeof(stagedSuffix)];
+    snprintf(stagedPath, sizeof(stagedPath), "%s%s", path, stagedSuffix);
+    lfs_info stagedInfo;
+    if (fs.Stat(stagedPath, &stagedInfo) == LFS_ERR_OK) {
+      complete = Verify(record.size, record.crc, stagedPath);
+    } else {
+      // The resource did not change, the installed one is kept
+      const int index = Find(record.pathHash);
+      if (index >= 0) {
+        complete = entries[index].valid && entries[index].size == record.size && entries[index].crc == record.crc;
+      } else {
+        complete = Verify(record.size, record.crc, path);
+      }
+    }
+    return complete;
+  });
+  if (!valid || !complete) {
+    return LFS_ERR_CORRUPT;
+  }
+
+  // From now on, the commit is completed at the next boot if it is interrupted
+  const int res = fs.Rename(stagedManifestPath, commitPath);
+  if (res != LFS_ERR_OK) {
+    return res;
+  }
+  Load();
+  return loaded ? LFS_ERR_OK : LFS_ERR_CORRUPT;
+}
+
+void ResourceIndex::Apply() {
+  // All the steps can be repeated if the commit is interrupted: the installed manifest is replaced last
+  ForEachRecord(manifestPath, [this](const ManifestRecord& record, const char* path) {
+    if (!Contains(commitPath, record.pathHash)) {
+      fs.FileDelete(path);
+    }
+    return true;
+  });
+  ForEachRecord(commitPath, [this](const ManifestRecord& /*record*/, const char* path) {
+    char stagedPath[maxPathLength + sizeof(stagedSuffix)];
+    snprintf(stagedPath, sizeof(stagedPath), "%s%s", path, stagedSuffix);
+    lfs_info info;
+    if (fs.Stat(stagedPath, &info) == LFS_ERR_OK) {
+      fs.Rename(stagedPath, path);
+    }
+    return true;
+  });
+  fs.Rename(commitPath, manifestPath);
+}
+
+bool ResourceIndex::AllValid() const {
+  return loaded && std::all_of(entries.begin(), entries.begin() + nbEntries, [](const Entry& entry) {
+           return entry.valid;
+         });
+}
+
+int ResourceIndex::Find(uint32_t pathHash) const {
+  if (!loaded) {
+    return -1;
+  }
+  const Entry* end = entries.data() + nbEntries;
+  const Entry* entry = std::lower_bound(entries.data(), end, pathHash, [](const Entry& e, uint32_t hash) {
+    return e.pathHash < hash;
+  });
+  if (entry == end || entry->pathHash != pathHash) {
+    return -1;
+  }
+  return entry - entries.data();
+}
+
+bool ResourceIndex::Verify(uint32_t size, uint32_t crc, const char* path) {
+  lfs_info info;
+  if (fs.Stat(path, &info) != LFS_ERR_OK || info.type != LFS_TYPE_REG || info.size != size) {
+    return false;
+  }
+
+  lfs_file_t file;
+  if (fs.FileOpen(&file, path, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+  uint8_t buffer[64];
+  uint32_t fileCrc = 0;
+  uint32_t remaining = size;
+  while (remaining > 0) {
+    const uint32_t chunkSize = std::min<uint32_t>(remaining, sizeof(buffer));
+    if (fs.FileRead(&file, buffer, chunkSize) != static_cast<int>(chunkSize)) {
+      break;
+    }
+    fileCrc = Crc32(fileCrc, buffer, chunkSize);
+    remaining -= chunkSize;
+  }
+  fs.FileClose(&file);
+  return remaining == 0 && fileCrc == crc;
+}
+
+uint32_t ResourceIndex::Crc32(uint32_t crc, const uint8_t* data, size_t size) {
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc = crcTable[(crc ^ data[i]) & 0x0f] ^ (crc >> 4);
+    crc = crcTable[(crc ^ (data[i] >> 4)) & 0x0f] ^ (crc >> 4);
+  }
+  return ~crc;
+}
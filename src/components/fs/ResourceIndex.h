@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+
+    /*
+     * Index of the external resources (fonts and images) installed in the file system.
+     *
+     * The resource package contains a manifest (manifestPath, generated by resources/generate-package.py) that lists
+     * the path, the size and the CRC32 of every resource. When the file system is mounted, each resource of the
+     * manifest is verified once and the index keeps the hash of its path, its size, its CRC and whether it is intact:
+     * the availability of a resource is then known without accessing the file system. The index is updated when a file
+     * is written, deleted or renamed over BLE.
+     *
+     * A new package can be installed as a delta: the companion app compares the index with the new manifest, uploads
+     * the resources that changed next to the installed ones (path + stagedSuffix), then the new manifest
+     * (stagedManifestPath), and calls Commit(). The staged resources replace the installed ones and the resources that
+     * are not in the new manifest are deleted. Once the commit started, it is completed at the next boot if it is
+     * interrupted.
+     */
+    class ResourceIndex {
+    public:
+      enum class Status : uint8_t {
+        Unknown, // No manifest is installed, or the resource is not listed in it
+        Valid,
+        Invalid // Missing, or its content does not match the manifest
+      };
+
+      struct Entry {
+        uint32_t pathHash;
+        uint32_t size;
+        uint32_t crc;
+        bool valid;
+      };
+
+      static constexpr const char* manifestPath = "/resources.idx";
+      static constexpr const char* stagedManifestPath = "/resources.idx.new";
+      static constexpr char stagedSuffix[] = ".new";
+      static constexpr size_t maxResources = 32;
+
+      explicit ResourceIndex(FS& fs);
+      ResourceIndex(const ResourceIndex&) = delete;
+      ResourceIndex& operator=(const ResourceIndex&) = delete;
+
+      // Loads the manifest and verifies all the resources
+      void Load();
+      Status GetStatus(const char* path) const;
+      // Must be called when the file at path was modified, deleted or created
+      void Update(const char* path);
+
+      // True if a manifest is installed and all its resources are intact
+      bool AllValid() const;
+
+      bool IsLoaded() const {
+        return loaded;
+      }
+
+      // The entries are sorted by pathHash
+      uint8_t NbEntries() const {
+        return loaded ? nbEntries : 0;
+      }
+
+      const Entry& GetEntry(uint8_t index) const {
+        return entries[index];
+      }
+
+      // Installs the staged package, returns a littlefs error code. Nothing is modified if a resource of the new
+      // manifest is neither staged nor installed, or does not match the manifest.
+      int Commit();
+
+      // FNV-1a, must match generate-package.py
+      static constexpr uint32_t Hash(const char* path) {
+        uint32_t hash = 2166136261u;
+        for (; *path != '\0'; path++) {
+          hash = (hash ^ static_cast<uint8_t>(*path)) * 16777619u;
+        }
+        return hash;
+      }
+
+      // CRC-32 (IEEE 802.3, same as zlib.crc32()), crc is the CRC of the previous data
+      static uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size);
+
+    private:
+      static constexpr uint32_t manifestMagic = 0x58444952; // "RIDX"
+      static constexpr uint16_t manifestVersion = 1;
+      static constexpr size_t maxPathLength = 64;
+      // The staged manifest is renamed to this path when the commit starts, and to manifestPath when it is done
+      static constexpr const char* commitPath = "/resources.idx.commit";
+
+      struct __attribute__((packed)) ManifestHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t count;
+      };
+
+      // Each record of the manifest is followed by pathLength characters (not null terminated)
+      struct __attribute__((packed)) ManifestRecord {
+        uint32_t pathHash;
+        uint32_t size;
+        uint32_t crc;
+        uint8_t pathLength;
+      };
+
+      FS& fs;
+      std::array<Entry, maxResources> entries;
+      uint8_t nbEntries = 0;
+      bool loaded = false;
+
+      // Calls callback(record, path) for each record of the manifest while it returns true. Returns false if the
+      // manifest cannot be read.
+      template <typename Callback>
+      bool ForEachRecord(const char* manifest, Callback&& callback);
+      bool Contains(const char* manifest, uint32_t pathHash);
+      void Apply();
+      bool Verify(uint32_t size, uint32_t crc, const char* path);
+      // Index of the entry, -1 if the path is not in the manifest
+      int Find(uint32_t pathHash) const;
+    };
+  }
+}
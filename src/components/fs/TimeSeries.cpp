@@ -0,0 +1,179 @@
+#include "components/fs/TimeSeries.h"
+#include "components/fs/FS.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+TimeSeries::TimeSeries(FS& fs, const char* directory, uint16_t maxBlocks) : fs {fs}, directory {directory}, maxBlocks {maxBlocks} {
+  snprintf(currentPath, sizeof(currentPath), "%s/current", directory);
+  snprintf(previousPath, sizeof(previousPath), "%s/previous", directory);
+}
+
+void TimeSeries::Init() {
+  mutex = xSemaphoreCreateMutex();
+
+  lfs_info info;
+  if (fs.Stat(directory, &info) != LFS_ERR_OK) {
+    fs.DirCreate(directory);
+  }
+  previousBlocks = BlocksInFile(previousPath);
+  currentBlocks = BlocksInFile(currentPath);
+  Header().count = 0;
+}
+
+void TimeSeries::Append(uint32_t time, int32_t value) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  auto& header = Header();
+  if (header.count > 0) {
+    uint8_t sample[10];
+    // Zigzag encoding: small negative differences are small integers too
+    const int32_t delta = value - lastValue;
+    const uint32_t deltaValue = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+    size_t size = 0;
+    if (time >= lastTime) {
+      size = EncodeVarint(time - lastTime, sample);
+      size += EncodeVarint(deltaValue, sample + size);
+    }
+
+    if (size > 0 && header.size + size <= blockSize) {
+      std::memcpy(block + header.size, sample, size);
+      header.size += size;
+      header.count++;
+      lastTime = time;
+      lastValue = value;
+      xSemaphoreGive(mutex);
+      return;
+    }
+    // Block full, or the time went backward: the sample starts a new block
+    Seal();
+  }
+
+  header.startTime = time;
+  header.firstValue = value;
+  header.count = 1;
+  header.size = sizeof(BlockHeader);
+  lastTime = time;
+  lastValue = value;
+  xSemaphoreGive(mutex);
+}
+
+void TimeSeries::Flush() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (Header().count > 0) {
+    Seal();
+  }
+  xSemaphoreGive(mutex);
+}
+
+uint16_t TimeSeries::NbBlocks() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const uint16_t nbBlocks = previousBlocks + currentBlocks + ((Header().count > 0) ? 1 : 0);
+  xSemaphoreGive(mutex);
+  return nbBlocks;
+}
+
+uint16_t TimeSeries::FindBlock(uint32_t time) {
+  // The last block whose first sample is before time may contain samples taken after it: binary search for the
+  // first block that starts after time, and step back by one.
+  const uint16_t nbBlocks = NbBlocks();
+  uint16_t low = 0;
+  uint16_t high = nbBlocks;
+  while (low < high) {
+    const uint16_t middle = low + (high - low) / 2;
+    BlockHeader header;
+    if (!Read(middle, reinterpret_cast<uint8_t*>(&header), sizeof(header))) {
+      return nbBlocks;
+    }
+    if (header.startTime <= time) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return (low > 0) ? low - 1 : 0;
+}
+
+size_t TimeSeries::ReadBlock(uint16_t index, uint8_t* buffer) {
+  if (!Read(index, buffer, blockSize)) {
+    return 0;
+  }
+  const auto size = reinterpret_cast<const BlockHeader*>(buffer)->size;
+  return (size >= sizeof(BlockHeader) && size <= blockSize) ? size : 0;
+}
+
+bool TimeSeries::Read(uint16_t index, uint8_t* buffer, size_t size) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  bool valid = false;
+  if (index < previousBlocks) {
+    valid = ReadFile(previousPath, index, buffer, size);
+  } else if (index < previousBlocks + currentBlocks) {
+    valid = ReadFile(currentPath, index - previousBlocks, buffer, size);
+  } else if (index == previousBlocks + currentBlocks && Header().count > 0) {
+    std::memcpy(buffer, block, size);
+    valid = true;
+  }
+  xSemaphoreGive(mutex);
+  return valid;
+}
+
+uint16_t TimeSeries::BlocksInFile(const char* path) {
+  lfs_info info;
+  if (fs.Stat(path, &info) != LFS_ERR_OK) {
+    return 0;
+  }
+  // An incomplete block (power loss while it was written) is ignored, and overwritten by the next one
+  return info.size / blockSize;
+}
+
+bool TimeSeries::ReadFile(const char* path, uint16_t index, uint8_t* buffer, size_t size) {
+  lfs_file_t file;
+  if (fs.FileOpen(&file, path, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+  const bool valid =
+    fs.FileSeek(&file, index * blockSize) >= 0 && fs.FileRead(&file, buffer, size) == static_cast<int>(size);
+  fs.FileClose(&file);
+  return valid;
+}
+
+void TimeSeries::Seal() {
+  if (currentBlocks >= maxBlocks) {
+    fs.FileDelete(previousPath);
+    fs.Rename(currentPath, previousPath);
+    previousBlocks = currentBlocks;
+    currentBlocks = 0;
+  }
+
+  std::memset(block + Header().size, 0, blockSize - Header().size);
+  lfs_file_t file;
+  if (fs.FileOpen(&file, currentPath, LFS_O_WRONLY | LFS_O_CREAT) == LFS_ERR_OK) {
+    if (fs.FileSeek(&file, currentBlocks * blockSize) >= 0 && fs.FileWrite(&file, block, blockSize) == static_cast<int>(blockSize)) {
+      currentBlocks++;
+    }
+    fs.FileClose(&file);
+  }
+  // The samples are lost if the block cannot be written, the series must not block the caller
+  Header().count = 0;
+}
+
+size_t TimeSeries::EncodeVarint(uint32_t value, uint8_t* buffer) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    buffer[size++] = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  buffer[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+size_t TimeSeries::DecodeVarint(const uint8_t* buffer, size_t size, uint32_t& value) {
+  value = 0;
+  for (size_t i = 0; i < size && i < 5; i++) {
+    value |= static_cast<uint32_t>(buffer[i] & 0x7f) << (7 * i);
+    if ((buffer[i] & 0x80) == 0) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
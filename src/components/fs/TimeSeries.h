@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+
+    /*
+     * Compact time series stored in the file system.
+     *
+     * The samples (time in seconds, value) are appended to a block in RAM. Each sample is stored as the difference
+     * with the previous one (time and value), encoded as a variable length integer: a sample taken at a regular
+     * interval whose value changes slowly takes 2 bytes. Full blocks are appended to the file of the series in a
+     * single write: appending a sample does not write to the flash, sealing a block writes one page.
+     *
+     * The blocks have a fixed size and start with the time of their first sample: block n is at offset n * blockSize
+     * and the blocks are sorted by time, the headers are the index of the series. The series keeps 2 files of
+     * maxBlocks blocks: when the current file is full, it replaces the previous one, which is deleted.
+     *
+     * Append() is called by one task, the blocks can be read from another one.
+     */
+    class TimeSeries {
+    public:
+      // One page of the SPI flash
+      static constexpr size_t blockSize = 256;
+
+      struct BlockHeader {
+        uint32_t startTime;
+        int32_t firstValue;
+        uint16_t count; // Number of samples
+        uint16_t size;  // Bytes used in the block, header included
+      };
+
+      // directory must be a string literal, it is used as is
+      TimeSeries(FS& fs, const char* directory, uint16_t maxBlocks);
+      TimeSeries(const TimeSeries&) = delete;
+      TimeSeries& operator=(const TimeSeries&) = delete;
+
+      // Must be called after the file system is mounted
+      void Init();
+
+      // The time must not go backward (a new block is started if it does)
+      void Append(uint32_t time, int32_t value);
+      // Writes the block in RAM to the flash, even if it is not full
+      void Flush();
+
+      // Number of blocks, including the block in RAM if it is not empty
+      uint16_t NbBlocks();
+      // Index of the first block that may contain samples taken at or after time, NbBlocks() if there is none
+      uint16_t FindBlock(uint32_t time);
+      // Copies the block in buffer (blockSize bytes), returns the number of bytes used, 0 on error
+      size_t ReadBlock(uint16_t index, uint8_t* buffer);
+
+      // Decodes the samples of a block read by ReadBlock(), calls callback(time, value) for each of them
+      template <typename Callback>
+      static void Decode(const uint8_t* block, size_t size, Callback&& callback);
+
+    private:
+      FS& fs;
+      const char* directory;
+      uint16_t maxBlocks;
+      char currentPath[24];
+      char previousPath[24];
+
+      SemaphoreHandle_t mutex = nullptr;
+      uint16_t previousBlocks = 0;
+      uint16_t currentBlocks = 0;
+
+      alignas(BlockHeader) uint8_t block[blockSize];
+      uint32_t lastTime = 0;
+      int32_t lastValue = 0;
+
+      BlockHeader& Header() {
+        return *reinterpret_cast<BlockHeader*>(block);
+      }
+
+      uint16_t BlocksInFile(const char* path);
+      bool Read(uint16_t index, uint8_t* buffer, size_t size);
+      bool ReadFile(const char* path, uint16_t index, uint8_t* buffer, size_t size);
+      void Seal();
+      static size_t EncodeVarint(uint32_t value, uint8_t* buffer);
+      static size_t DecodeVarint(const uint8_t* buffer, size_t size, uint32_t& value);
+    };
+
+    template <typename Callback>
+    void TimeSeries::Decode(const uint8_t* block, size_t size, Callback&& callback) {
+      if (size < sizeof(BlockHeader)) {
+        return;
+      }
+      const auto* header = reinterpret_cast<const BlockHeader*>(block);
+      if (header->count == 0 || header->size > size) {
+        return;
+      }
+
+      uint32_t time = header->startTime;
+      int32_t value = header->firstValue;
+      callback(time, value);
+
+      size_t offset = sizeof(BlockHeader);
+      for (uint16_t i = 1; i < header->count; i++) {
+        uint32_t deltaTime;
+        uint32_t deltaValue;
+        size_t length = DecodeVarint(block + offset, header->size - offset, deltaTime);
+        if (length == 0) {
+          return;
+        }
+        offset += length;
+        length = DecodeVarint(block + offset, header->size - offset, deltaValue);
+        if (length == 0) {
+          return;
+        }
+        offset += length;
+
+        time += deltaTime;
+        // Zigzag decoding
+        value += static_cast<int32_t>(deltaValue >> 1) ^ -static_cast<int32_t>(deltaValue & 1);
+        callback(time, value);
+      }
+    }
+  }
+}
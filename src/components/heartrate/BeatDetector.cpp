@@ -0,0 +1,108 @@
+#include "components/heartrate/BeatDetector.h"
+#include <algorithm>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // Coefficient of the exponential moving average that has a cutoff frequency of cutoff Hz at sampleRate Hz
+  constexpr float MovingAverageAlpha(float cutoff, uint8_t sampleRate) {
+    constexpr float twoPi = 6.28318531f;
+    return (twoPi * cutoff) / (twoPi * cutoff + static_cast<float>(sampleRate));
+  }
+}
+
+template <uint8_t SampleRate>
+bool BeatDetector<SampleRate>::Process(uint32_t value, uint32_t timestampMs, uint16_t& interval) {
+  constexpr float lowPassAlpha = MovingAverageAlpha(4.0f, SampleRate);
+  constexpr float baselineAlpha = MovingAverageAlpha(0.5f, SampleRate);
+
+  const auto sample = static_cast<float>(value);
+  if (nbSamples == 0) {
+    lowPass = sample;
+    baseline = sample;
+  }
+  lowPass += lowPassAlpha * (sample - lowPass);
+  baseline += baselineAlpha * (sample - baseline);
+
+  signal[0] = signal[1];
+  signal[1] = signal[2];
+  time[0] = time[1];
+  time[1] = time[2];
+  // The reflected light decreases when the blood volume increases (systole): the pulse wave is inverted
+  signal[2] = baseline - lowPass;
+  time[2] = timestampMs;
+  if (nbSamples < 3) {
+    nbSamples++;
+    return false;
+  }
+
+  if (lastBeatValid && timestampMs - lastBeatTime > maxInterval) {
+    // No beat for too long: the amplitude estimate is too high, or the signal was lost
+    amplitude /= 2.0f;
+    lastBeatValid = false;
+  }
+
+  // Maximum at signal[1], above half the amplitude of the previous beats
+  if (signal[1] <= 0.0f || signal[1] <= signal[0] || signal[1] < signal[2] || signal[1] < amplitude / 2.0f) {
+    return false;
+  }
+
+  // Parabolic interpolation of the time of the maximum
+  float offset = 0.0f;
+  const float curvature = signal[0] - 2.0f * signal[1] + signal[2];
+  if (curvature < 0.0f) {
+    offset = 0.5f * (signal[0] - signal[2]) / curvature;
+  }
+  const float halfPeriod = static_cast<float>(time[2] - time[0]) / 2.0f;
+  const uint32_t beatTime = time[1] + static_cast<int32_t>(offset * halfPeriod);
+
+  if (lastBeatValid && beatTime - lastBeatTime < minInterval) {
+    // Dicrotic notch or noise, too close to the previous beat
+    return false;
+  }
+
+  amplitude = (amplitude == 0.0f) ? signal[1] : amplitude + (signal[1] - amplitude) / 4.0f;
+  const bool hasInterval = lastBeatValid;
+  const uint32_t elapsed = beatTime - lastBeatTime;
+  interval = static_cast<uint16_t>(std::min<uint32_t>(elapsed, UINT16_MAX));
+  lastBeatTime = beatTime;
+  lastBeatValid = true;
+  return hasInterval && Validate(interval);
+}
+
+template <uint8_t SampleRate>
+bool BeatDetector<SampleRate>::Validate(uint16_t interval) {
+  if (interval < minInterval || interval > maxInterval) {
+    return false;
+  }
+  if (averageInterval != 0 && interval * 8 > averageInterval * (8 + maxDeviation)) {
+    // Probably a missed beat
+    nbRejected++;
+  } else if (averageInterval != 0 && interval * 8 < averageInterval * (8 - maxDeviation)) {
+    // Probably an extra beat
+    nbRejected++;
+  } else {
+    nbRejected = 0;
+    averageInterval = (averageInterval == 0) ? interval : averageInterval + (interval - averageInterval) / 8;
+    return true;
+  }
+
+  if (nbRejected >= maxRejected) {
+    // The rhythm changed: restart from the last interval
+    nbRejected = 0;
+    averageInterval = interval;
+  }
+  return false;
+}
+
+template <uint8_t SampleRate>
+void BeatDetector<SampleRate>::Reset() {
+  nbSamples = 0;
+  amplitude = 0.0f;
+  lastBeatValid = false;
+  averageInterval = 0;
+  nbRejected = 0;
+}
+
+// Sample rates used by the firmware
+template class Pinetime::Controllers::BeatDetector<20>;
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    /*
+     * Time domain detector of the heart beats in the PPG signal, it gives the interval between 2 consecutive beats
+     * (RR interval) while the spectral estimator (Ppg) gives the average heart rate.
+     *
+     * The signal is band-pass filtered (0.5Hz - 4Hz) and the beats are the maxima of the pulse wave that exceed a
+     * fraction of the amplitude of the previous beats. The time of each maximum is interpolated between the samples.
+     * Intervals that are out of range or too different from the recent rhythm (artifacts, missed beats) are discarded.
+     *
+     * The implementation is instantiated in BeatDetector.cpp for the sample rates used by the firmware.
+     */
+    template <uint8_t SampleRate>
+    class BeatDetector {
+    public:
+      // timestampMs is the time at which the sample was read, in milliseconds.
+      // Returns true when a beat is detected, interval is then the time since the previous beat, in milliseconds.
+      bool Process(uint32_t value, uint32_t timestampMs, uint16_t& interval);
+      void Reset();
+
+    private:
+      // 230 BPM and 40 BPM
+      static constexpr uint16_t minInterval = 60000 / 230;
+      static constexpr uint16_t maxInterval = 60000 / 40;
+      // Maximum deviation from the average interval, in 1/8
+      static constexpr uint16_t maxDeviation = 3;
+      // Consecutive rejected intervals before the average interval is considered to be wrong
+      static constexpr uint8_t maxRejected = 3;
+
+      float lowPass = 0.0f;
+      float baseline = 0.0f;
+      // Last 3 values of the filtered signal and their time
+      float signal[3] = {};
+      uint32_t time[3] = {};
+      uint8_t nbSamples = 0;
+
+      float amplitude = 0.0f;
+      uint32_t lastBeatTime = 0;
+      bool lastBeatValid = false;
+      uint16_t averageInterval = 0;
+      uint8_t nbRejected = 0;
+
+      bool Validate(uint16_t interval);
+    };
+  }
+}
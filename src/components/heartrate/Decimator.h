@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    /*
+     * Reduces the rate of a signal by Factor.
+     *
+     * Before the signal is downsampled, it is low-pass filtered by a triangular FIR filter (2 stage CIC filter) of
+     * 2 * Factor - 1 taps, which strongly attenuates the frequencies that would fold into the output band. The output
+     * is the sum of Factor input samples: the extra bits compensate the resolution lost by reading the sensor faster.
+     */
+    template <uint8_t Factor>
+    class Decimator {
+    public:
+      static_assert(Factor > 0, "Factor must not be 0");
+
+      // Returns true when a new output value is available, every Factor input values
+      bool Push(uint32_t value, uint32_t& output) {
+        history[index] = value;
+        index = (index + 1) % taps;
+        if (count < taps) {
+          count++;
+        }
+        if (++phase < Factor) {
+          return false;
+        }
+        phase = 0;
+        if (count < taps) {
+          return false;
+        }
+
+        // history[index] is the oldest value
+        uint32_t sum = 0;
+        for (uint8_t i = 0; i < taps; i++) {
+          const uint32_t weight = (i < Factor) ? i + 1 : taps - i;
+          sum += weight * history[(index + i) % taps];
+        }
+        output = sum / Factor;
+        return true;
+      }
+
+      void Reset() {
+        index = 0;
+        count = 0;
+        phase = 0;
+      }
+
+    private:
+      static constexpr uint8_t taps = 2 * Factor - 1;
+
+      std::array<uint32_t, taps> history;
+      uint8_t index = 0;
+      uint8_t count = 0;
+      uint8_t phase = 0;
+    };
+  }
+}
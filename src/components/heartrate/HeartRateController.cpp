@@ -1,14 +1,84 @@
 #include "components/heartrate/HeartRateController.h"
 #include <heartratetask/HeartRateTask.h>
 #include <systemtask/SystemTask.h>
+#include <components/datetime/DateTimeController.h>
+#include <algorithm>
 
 using namespace Pinetime::Controllers;
 
+HeartRateController::HeartRateController(DateTime& dateTimeController, FS& fs)
+  : dateTimeController {dateTimeController}, history {fs, "/hr", historyBlocks} {
+}
+
+void HeartRateController::Init() {
+  pendingMutex = xSemaphoreCreateMutex();
+  history.Init();
+}
+
 void HeartRateController::Update(HeartRateController::States newState, uint8_t heartRate) {
   this->state = newState;
-  if (this->heartRate != heartRate) {
+  if (this->heartRate != heartRate || nbRrIntervals > 0) {
     this->heartRate = heartRate;
-    service->OnNewHeartRateValue(heartRate);
+    service->OnNewHeartRateValue(heartRate, rrIntervals.data(), nbRrIntervals);
+    nbRrIntervals = 0;
+  }
+}
+
+void HeartRateController::AddBeat(uint16_t interval) {
+  variability.Add(interval);
+  rmssd = variability.Rmssd();
+  sdnn = variability.Sdnn();
+
+  if (nbRrIntervals == rrIntervals.size()) {
+    // Not sent in time, the oldest is dropped
+    std::copy(rrIntervals.begin() + 1, rrIntervals.end(), rrIntervals.begin());
+    nbRrIntervals--;
+  }
+  rrIntervals[nbRrIntervals++] = interval;
+}
+
+void HeartRateController::ResetBeats() {
+  variability.Reset();
+  rmssd = 0;
+  sdnn = 0;
+  nbRrIntervals = 0;
+}
+
+void HeartRateController::Record(uint8_t heartRate) {
+  const auto now = std::chrono::duration_cast<std::chrono::seconds>(dateTimeController.CurrentDateTime().time_since_epoch());
+  xSemaphoreTake(pendingMutex, portMAX_DELAY);
+  if (nbPending == pending.size()) {
+    // Not saved in time, the oldest is dropped
+    std::copy(pending.begin() + 1, pending.end(), pending.begin());
+    nbPending--;
+  }
+  pending[nbPending++] = {static_cast<uint32_t>(now.count()), heartRate};
+  xSemaphoreGive(pendingMutex);
+}
+
+void HeartRateController::Save() {
+  std::array<Sample, maxPending> samples;
+  xSemaphoreTake(pendingMutex, portMAX_DELAY);
+  const uint8_t nbSamples = nbPending;
+  std::copy(pending.begin(), pending.begin() + nbPending, samples.begin());
+  nbPending = 0;
+  xSemaphoreGive(pendingMutex);
+
+  for (uint8_t i = 0; i < nbSamples; i++) {
+    history.Append(samples[i].time, samples[i].heartRate);
+  }
+}
+
+uint8_t HeartRateController::NbPending() {
+  xSemaphoreTake(pendingMutex, portMAX_DELAY);
+  const uint8_t count = nbPending;
+  xSemaphoreGive(pendingMutex);
+  return count;
+}
+
+void HeartRateController::UpdateBackgroundMeasurement() {
+  if (task != nullptr) {
+    task->PushMessage(Pinetime::Applications::HeartRateTask::Messages::UpdateBackgroundMeasurement);
   }
 }
 
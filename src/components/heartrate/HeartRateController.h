@@ -1,7 +1,12 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <components/ble/HeartRateService.h>
+#include <components/heartrate/HeartRateVariability.h>
+#include <components/fs/TimeSeries.h>
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 namespace Pinetime {
   namespace Applications {
@@ -13,14 +18,38 @@ namespace Pinetime {
   }
 
   namespace Controllers {
+    class DateTime;
+    class FS;
+
     class HeartRateController {
     public:
       enum class States { Stopped, NotEnoughData, NoTouch, Running };
 
-      HeartRateController() = default;
+      HeartRateController(DateTime& dateTimeController, FS& fs);
+      // Must be called after the file system is mounted
+      void Init();
       void Start();
       void Stop();
       void Update(States newState, uint8_t heartRate);
+      // Interval between the last 2 beats, in milliseconds. Sent with the next update.
+      void AddBeat(uint16_t interval);
+      void ResetBeats();
+
+      static constexpr uint8_t maxPending = 16;
+
+      // Stores a heart rate measured by the periodic background measurement. Called by the heart rate task, which
+      // measures while the flash sleeps: the samples are queued in RAM and appended to the history by Save().
+      void Record(uint8_t heartRate);
+      // Called by the system task, the flash must be awake
+      void Save();
+      uint8_t NbPending();
+      // The interval of the background measurement changed in the settings
+      void UpdateBackgroundMeasurement();
+
+      // Heart rate measured in the background (BPM), timestamped in seconds since the epoch
+      TimeSeries& History() {
+        return history;
+      }
 
       void SetHeartRateTask(Applications::HeartRateTask* task);
 
@@ -32,13 +61,43 @@ namespace Pinetime {
         return heartRate;
       }
 
+      // Heart rate variability (ms), 0 until enough beats are detected
+      uint16_t Rmssd() const {
+        return rmssd;
+      }
+
+      uint16_t Sdnn() const {
+        return sdnn;
+      }
+
       void SetService(Pinetime::Controllers::HeartRateService* service);
 
     private:
+      DateTime& dateTimeController;
       Applications::HeartRateTask* task = nullptr;
       States state = States::Stopped;
       uint8_t heartRate = 0;
       Pinetime::Controllers::HeartRateService* service = nullptr;
+
+      HeartRateVariability variability;
+      uint16_t rmssd = 0;
+      uint16_t sdnn = 0;
+      // Intervals not sent yet
+      std::array<uint16_t, HeartRateService::maxRrIntervals> rrIntervals;
+      uint8_t nbRrIntervals = 0;
+
+      struct Sample {
+        uint32_t time;
+        uint8_t heartRate;
+      };
+
+      // 2 x 64 blocks: 5 to 10 days of measurements every minute
+      static constexpr uint16_t historyBlocks = 64;
+      TimeSeries history;
+
+      SemaphoreHandle_t pendingMutex = nullptr;
+      std::array<Sample, maxPending> pending;
+      uint8_t nbPending = 0;
     };
   }
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "components/heartrate/HeartRateVariability.h"
+#include <cmath>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  uint32_t SquaredDifference(uint16_t a, uint16_t b) {
+    const int32_t difference = static_cast<int32_t>(a) - static_cast<int32_t>(b);
+    return static_cast<uint32_t>(difference * difference);
+  }
+}
+
+void HeartRateVariability::Add(uint16_t interval) {
+  if (count == windowSize) {
+    // The oldest interval leaves the window, with its difference to the next one
+    const uint16_t oldest = intervals[first];
+    first = (first + 1) % windowSize;
+    count--;
+    sum -= oldest;
+    sumSquares -= static_cast<uint32_t>(oldest) * oldest;
+    sumSquaredDifferences -= SquaredDifference(intervals[first], oldest);
+  }
+
+  if (count > 0) {
+    sumSquaredDifferences += SquaredDifference(interval, intervals[(first + count - 1) % windowSize]);
+  }
+  intervals[(first + count) % windowSize] = interval;
+  count++;
+  sum += interval;
+  sumSquares += static_cast<uint32_t>(interval) * interval;
+}
+
+void HeartRateVariability::Reset() {
+  first = 0;
+  count = 0;
+  sum = 0;
+  sumSquares = 0;
+  sumSquaredDifferences = 0;
+}
+
+uint16_t HeartRateVariability::Rmssd() const {
+  if (count < 2) {
+    return 0;
+  }
+  const float meanSquare = static_cast<float>(sumSquaredDifferences) / static_cast<float>(count - 1);
+  return static_cast<uint16_t>(std::sqrt(meanSquare) + 0.5f);
+}
+
+uint16_t HeartRateVariability::Sdnn() const {
+  if (count < 2) {
+    return 0;
+  }
+  // Sample variance: (sum(x^2) - sum(x)^2 / n) / (n - 1), computed with integers
+  const uint64_t squaredSum = static_cast<uint64_t>(sum) * sum;
+  const uint64_t deviations = sumSquares * count - squaredSum;
+  const float variance = static_cast<float>(deviations) / static_cast<float>(count) / static_cast<float>(count - 1);
+  return static_cast<uint16_t>(std::sqrt(variance) + 0.5f);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    /*
+     * Time domain heart rate variability over the last intervals between beats (RR intervals).
+     *
+     * The sums needed by RMSSD (root mean square of the successive differences) and SDNN (standard deviation of the
+     * intervals) are updated when an interval enters or leaves the window: adding an interval costs O(1) whatever
+     * the size of the window. The sums are integers, they do not drift.
+     */
+    class HeartRateVariability {
+    public:
+      // Interval between 2 beats, in milliseconds
+      void Add(uint16_t interval);
+      void Reset();
+
+      // Number of intervals in the window
+      uint8_t Count() const {
+        return count;
+      }
+
+      // In milliseconds, 0 if there are not enough intervals
+      uint16_t Rmssd() const;
+      uint16_t Sdnn() const;
+
+      // ~1 minute at rest
+      static constexpr uint8_t windowSize = 64;
+
+    private:
+      std::array<uint16_t, windowSize> intervals;
+      uint8_t first = 0;
+      uint8_t count = 0;
+
+      uint32_t sum = 0;
+      uint64_t sumSquares = 0;
+      uint64_t sumSquaredDifferences = 0;
+    };
+  }
+}
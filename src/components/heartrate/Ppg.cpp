@@ -5,6 +5,61 @@
 using namespace Pinetime::Controllers;
 
 namespace {
+  // The functions below are evaluated at compile time only: they generate the constants that depend on the
+  // configuration of Ppg, without linking cosf() and expf() (~5KB of flash).
+  constexpr double pi = 3.14159265358979323846;
+
+  // Valid for 0 <= x <= pi
+  constexpr double Cosine(double x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 30; n++) {
+      term *= -x * x / ((2 * n - 1) * (2 * n));
+      sum += term;
+    }
+    return sum;
+  }
+
+  // Valid for |x| < 10
+  constexpr double Exponential(double x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 60; n++) {
+      term *= x / n;
+      sum += term;
+    }
+    return sum;
+  }
+
+  // Valid for x > 0.01
+  constexpr double Logarithm(double x) {
+    // ln(x) = 2 * atanh((x - 1) / (x + 1))
+    const double z = (x - 1) / (x + 1);
+    double term = z;
+    double sum = 0.0;
+    for (int n = 0; n < 200; n++) {
+      sum += term / (2 * n + 1);
+      term *= z * z;
+    }
+    return 2 * sum;
+  }
+
+  // The filters were tuned at 10Hz: the coefficient of an exponential moving average at sampleRate that has the
+  // same time constant (in seconds) as the coefficient alpha at 10Hz.
+  constexpr float MovingAverageAlpha(double alpha, uint8_t sampleRate) {
+    return static_cast<float>(1.0 - Exponential(Logarithm(1.0 - alpha) * 10.0 / sampleRate));
+  }
+
+  // First half of the Hanning window (the window is symmetrical), same as numpy.hanning(length)
+  template <uint16_t Length>
+  constexpr std::array<float, Length / 2> HanningWindow() {
+    std::array<float, Length / 2> window {};
+    for (uint16_t n = 0; n < Length / 2; n++) {
+      window[n] = static_cast<float>(0.5 - 0.5 * Cosine(2.0 * pi * n / (Length - 1)));
+    }
+    return window;
+  }
+
   float LinearInterpolation(const float* xValues, const float* yValues, int length, float pointX) {
     if (pointX > xValues[length - 1]) {
       return yValues[length - 1];
@@ -59,7 +114,8 @@ namespace {
     return peakCenter;
   }
 
-  float SpectrumMean(const std::array<float, Ppg::spectrumLength>& signal, int start, int end) {
+  template <size_t N>
+  float SpectrumMean(const std::array<float, N>& signal, int start, int end) {
     int total = 0;
     float mean = 0.0f;
     for (int idx = start; idx < end; idx++) {
@@ -72,19 +128,23 @@ namespace {
     return mean;
   }
 
-  float SignalToNoise(const std::array<float, Ppg::spectrumLength>& signal, int start, int end, float max) {
+  template <size_t N>
+  float SignalToNoise(const std::array<float, N>& signal, int start, int end, float max) {
     float mean = SpectrumMean(signal, start, end);
     return max / mean;
   }
 
   // Simple bandpass filter using exponential moving average
-  void Filter30to240(std::array<float, Ppg::dataLength>& signal) {
+  template <uint8_t SampleRate, size_t N>
+  void Filter30to240(std::array<float, N>& signal) {
     // From:
     // https://www.norwegiancreations.com/2016/03/arduino-tutorial-simple-high-pass-band-pass-and-band-stop-filtering/
 
     int length = signal.size();
     // 0.268 is ~0.5Hz and 0.816 is ~4Hz cutoff at 10Hz sampling
-    float expAlpha = 0.816f;
+    constexpr float lowPassAlpha = MovingAverageAlpha(0.816, SampleRate);
+    constexpr float highPassAlpha = MovingAverageAlpha(0.268, SampleRate);
+    float expAlpha = lowPassAlpha;
     float expAvg = 0.0f;
     for (int loop = 0; loop < 4; loop++) {
       expAvg = signal.front();
@@ -93,7 +153,7 @@ namespace {
         signal[idx] = expAvg;
       }
     }
-    expAlpha = 0.268f;
+    expAlpha = highPassAlpha;
     for (int loop = 0; loop < 4; loop++) {
       expAvg = signal.front();
       for (int idx = 0; idx < length; idx++) {
@@ -103,7 +163,8 @@ namespace {
     }
   }
 
-  float SpectrumMax(const std::array<float, Ppg::spectrumLength>& data, int start, int end) {
+  template <size_t N>
+  float SpectrumMax(const std::array<float, N>& data, int start, int end) {
     float max = 0.0f;
     for (int idx = start; idx < end; idx++) {
       if (data.at(idx) > max) {
@@ -113,7 +174,8 @@ namespace {
     return max;
   }
 
-  void Detrend(std::array<float, Ppg::dataLength>& signal) {
+  template <size_t N>
+  void Detrend(std::array<float, N>& signal) {
     int size = signal.size();
     float offset = signal.front();
     float slope = (signal.at(size - 1) - offset) / static_cast<float>(size - 1);
@@ -125,25 +187,23 @@ namespace {
       signal[idx] = signal[idx + 1] - signal[idx];
     }
   }
-
-  // Hanning Coefficients from numpy: python -c 'import numpy;print(numpy.hanning(64))'
-  // Note: Harcoded and must be updated if constexpr dataLength is changed. Prevents the need to
-  // use cosf() which results in an extra ~5KB in storage.
-  // This data is symetrical so just using the first half (saves 128B when dataLength is 64).
-  static constexpr float hanning[Ppg::dataLength >> 1] {
-    0.0f,        0.00248461f, 0.00991376f, 0.0222136f,  0.03926189f, 0.06088921f, 0.08688061f, 0.11697778f,
-    0.15088159f, 0.1882551f,  0.22872687f, 0.27189467f, 0.31732949f, 0.36457977f, 0.41317591f, 0.46263495f,
-    0.51246535f, 0.56217185f, 0.61126047f, 0.65924333f, 0.70564355f, 0.75f,       0.79187184f, 0.83084292f,
-    0.86652594f, 0.89856625f, 0.92664544f, 0.95048443f, 0.96984631f, 0.98453864f, 0.99441541f, 0.99937846f};
 }
 
-Ppg::Ppg() {
+template <uint8_t SampleRate, uint16_t Length>
+Ppg<SampleRate, Length>::Ppg() {
   dataAverage.fill(0.0f);
   spectrum.fill(0.0f);
 }
 
-int8_t Ppg::Preprocess(uint32_t hrs, uint32_t als) {
+template <uint8_t SampleRate, uint16_t Length>
+int8_t Ppg<SampleRate, Length>::Preprocess(uint32_t hrs, uint32_t als, uint32_t timestampMs) {
+  const auto time = static_cast<uint16_t>(timestampMs);
+  if (dataIndex > 0 && static_cast<uint16_t>(time - dataTime[dataIndex - 1]) > maxSampleIntervalMs) {
+    // The FFT needs evenly spaced samples
+    dataIndex = 0;
+  }
   if (dataIndex < dataLength) {
+    dataTime[dataIndex] = time;
     dataHRS[dataIndex++] = hrs;
   }
   alsValue = als;
@@ -153,7 +213,8 @@ int8_t Ppg::Preprocess(uint32_t hrs, uint32_t als) {
   return 0;
 }
 
-int Ppg::HeartRate() {
+template <uint8_t SampleRate, uint16_t Length>
+int Ppg<SampleRate, Length>::HeartRate() {
   if (dataIndex < dataLength) {
     return 0;
   }
@@ -163,12 +224,14 @@ int Ppg::HeartRate() {
   // Make room for overlapWindow number of new samples
   for (int idx = 0; idx < dataLength - overlapWindow; idx++) {
     dataHRS[idx] = dataHRS[idx + overlapWindow];
+    dataTime[idx] = dataTime[idx + overlapWindow];
   }
   dataIndex = dataLength - overlapWindow;
   return hr;
 }
 
-void Ppg::Reset(bool resetDaqBuffer) {
+template <uint8_t SampleRate, uint16_t Length>
+void Ppg<SampleRate, Length>::Reset(bool resetDaqBuffer) {
   if (resetDaqBuffer) {
     dataIndex = 0;
   }
@@ -183,12 +246,14 @@ void Ppg::Reset(bool resetDaqBuffer) {
 
 // Pass init == true to reset spectral averaging.
 // Returns -1 (Reset Acquisition), 0 (Unable to obtain HR) or HR (BPM).
-int Ppg::ProcessHeartRate(bool init) {
+template <uint8_t SampleRate, uint16_t Length>
+int Ppg<SampleRate, Length>::ProcessHeartRate(bool init) {
   std::copy(dataHRS.begin(), dataHRS.end(), vReal.begin());
   Detrend(vReal);
-  Filter30to240(vReal);
+  Filter30to240<SampleRate>(vReal);
   vImag.fill(0.0f);
   // Apply Hanning Window
+  static constexpr auto hanning = HanningWindow<dataLength>();
   int hannIdx = 0;
   for (int idx = 0; idx < dataLength; idx++) {
     if (idx >= dataLength >> 1) {
@@ -224,7 +289,7 @@ int Ppg::ProcessHeartRate(bool init) {
                               static_cast<float>(hrROIbegin),
                               static_cast<float>(hrROIend),
                               specLen);
-    peakLocation *= freqResolution;
+    peakLocation *= MeasuredFrequencyResolution();
   }
   // Peak too wide? (broad spectrum noise or large, rapid HR change)
   if (peakWidth > maxPeakWidth) {
@@ -252,7 +317,23 @@ int Ppg::ProcessHeartRate(bool init) {
   return rtn;
 }
 
-void Ppg::SpectrumAverage(const float* data, float* spectrum, int length, bool reset) {
+// The actual sampling period differs slightly from deltaTms (tick rounding, jitter):
+// the frequency of the bins is computed from the time spanned by the samples.
+template <uint8_t SampleRate, uint16_t Length>
+float Ppg<SampleRate, Length>::MeasuredFrequencyResolution() const {
+  const uint16_t span = dataTime[dataLength - 1] - dataTime[0];
+  if (span == 0) {
+    return freqResolution;
+  }
+  const float measuredFreq = static_cast<float>(dataLength - 1) * 1000.0f / static_cast<float>(span);
+  if (measuredFreq < sampleFreq * 0.8f || measuredFreq > sampleFreq * 1.2f) {
+    return freqResolution;
+  }
+  return measuredFreq / dataLength;
+}
+
+template <uint8_t SampleRate, uint16_t Length>
+void Ppg<SampleRate, Length>::SpectrumAverage(const float* data, float* spectrum, int length, bool reset) {
   if (reset) {
     spectralAvgCount = 0;
   }
@@ -265,7 +346,8 @@ void Ppg::SpectrumAverage(const float* data, float* spectrum, int length, bool r
   }
 }
 
-float Ppg::HeartRateAverage(float hr) {
+template <uint8_t SampleRate, uint16_t Length>
+float Ppg<SampleRate, Length>::HeartRateAverage(float hr) {
   avgIndex++;
   avgIndex %= dataAverage.size();
   dataAverage[avgIndex] = hr;
@@ -290,3 +372,6 @@ float Ppg::HeartRateAverage(float hr) {
   }
   return avg;
 }
+
+// Configurations used by the firmware
+template class Pinetime::Controllers::Ppg<10, 64>;
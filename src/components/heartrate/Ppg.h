@@ -11,25 +11,43 @@
 
 namespace Pinetime {
   namespace Controllers {
+    /*
+     * Heart rate estimation from the spectrum of the PPG signal.
+     *
+     * SampleRate is the rate (Hz) of the samples given to Preprocess(), Length the number of samples analysed by
+     * each FFT (must be a power of 2). The window lasts Length / SampleRate seconds and the resolution of the spectrum
+     * is SampleRate / Length Hz: a longer window gives a finer resolution, at the cost of RAM, CPU time and latency.
+     *
+     * The implementation is instantiated in Ppg.cpp for the configurations used by the firmware.
+     */
+    template <uint8_t SampleRate, uint16_t Length>
     class Ppg {
     public:
+      static_assert((Length & (Length - 1)) == 0, "Length must be a power of 2");
+      // The heart rate region of interest (up to 240 BPM = 4Hz) must be below the Nyquist frequency
+      static_assert(SampleRate > 8, "SampleRate is too low to measure heart rates up to 240 BPM");
+
       Ppg();
-      int8_t Preprocess(uint32_t hrs, uint32_t als);
+      // timestampMs is the time at which the sample was read, in milliseconds
+      int8_t Preprocess(uint32_t hrs, uint32_t als, uint32_t timestampMs);
       int HeartRate();
       void Reset(bool resetDaqBuffer);
-      static constexpr int deltaTms = 100;
+      static constexpr uint8_t sampleRate = SampleRate;
+      static constexpr int deltaTms = 1000 / SampleRate;
       // Daq dataLength: Must be power of 2
-      static constexpr uint16_t dataLength = 64;
+      static constexpr uint16_t dataLength = Length;
       static constexpr uint16_t spectrumLength = dataLength >> 1;
 
     private:
-      // The sampling frequency (Hz) based on sampling time in milliseconds (DeltaTms)
-      static constexpr float sampleFreq = 1000.0f / static_cast<float>(deltaTms);
-      // The frequency resolution (Hz)
+      // The nominal sampling frequency (Hz)
+      static constexpr float sampleFreq = static_cast<float>(SampleRate);
+      // The nominal frequency resolution (Hz)
       static constexpr float freqResolution = sampleFreq / dataLength;
+      // The acquisition restarts if the interval between 2 samples exceeds this value (missed samples)
+      static constexpr uint16_t maxSampleIntervalMs = deltaTms * 3 / 2;
       // Number of samples before each analysis
-      // 0.5 second update rate at 10Hz
-      static constexpr uint16_t overlapWindow = 5;
+      // 0.5 second update rate
+      static constexpr uint16_t overlapWindow = SampleRate / 2;
       // Maximum number of spectrum running averages
       // Note: actual number of spectra averaged = spectralAvgMax + 1
       static constexpr uint16_t spectralAvgMax = 2;
@@ -54,6 +72,8 @@ namespace Pinetime {
 
       // Raw ADC data
       std::array<uint16_t, dataLength> dataHRS;
+      // Time of the samples (ms, 16 LSB)
+      std::array<uint16_t, dataLength> dataTime;
       // Stores Real numbers from FFT
       std::array<float, dataLength> vReal;
       // Stores Imaginary numbers from FFT
@@ -73,6 +93,7 @@ namespace Pinetime {
       bool resetSpectralAvg = true;
 
       int ProcessHeartRate(bool init);
+      float MeasuredFrequencyResolution() const;
       float HeartRateAverage(float hr);
       void SpectrumAverage(const float* data, float* spectrum, int length, bool reset);
     };
@@ -0,0 +1,92 @@
+#include "components/motion/Actigraphy.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace Pinetime::Controllers;
+
+Actigraphy::Actigraphy(FS& fs) : history {fs, "/acti", historyBlocks} {
+}
+
+void Actigraphy::Init() {
+  history.Init();
+}
+
+void Actigraphy::Update(int16_t x, int16_t y, int16_t z, uint32_t time) {
+  const uint32_t epoch = time - time % epochLength;
+  if (epoch != epochStart) {
+    CloseEpoch();
+    epochStart = epoch;
+  }
+
+  if (hasLast) {
+    const uint32_t delta = std::abs(x - lastX) + std::abs(y - lastY) + std::abs(z - lastZ);
+    if (delta > deadBand) {
+      activity += delta - deadBand;
+    }
+  }
+  lastX = x;
+  lastY = y;
+  lastZ = z;
+  hasLast = true;
+  nbSamples++;
+}
+
+void Actigraphy::Save() {
+  for (uint8_t i = 0; i < nbPending; i++) {
+    history.Append(pending[i].time, (pending[i].count << 1) | (pending[i].asleep ? 1 : 0));
+  }
+  nbPending = 0;
+}
+
+void Actigraphy::CloseEpoch() {
+  if (nbSamples >= minSamples) {
+    const uint64_t count = static_cast<uint64_t>(activity) * nominalSamples / nbSamples / countScale;
+    AddEpoch(epochStart, static_cast<uint16_t>(std::min<uint64_t>(count, UINT16_MAX)));
+  }
+  activity = 0;
+  nbSamples = 0;
+}
+
+void Actigraphy::AddEpoch(uint32_t time, uint16_t count) {
+  if (nbWindow > 0 && time != windowTime + epochLength) {
+    FlushWindow();
+  }
+
+  std::copy(window.begin() + 1, window.end(), window.begin());
+  window.back() = count;
+  nbWindow = std::min<uint8_t>(nbWindow + 1, window.size());
+  windowTime = time;
+  if (nbWindow > nextEpochs) {
+    Classify(window.size() - 1 - nextEpochs, nextEpochs);
+  }
+}
+
+void Actigraphy::Classify(uint8_t index, uint8_t nbNext) {
+  // The weights are centered on the epoch, the epochs out of the window count as 0
+  const uint8_t first = window.size() - nbWindow;
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < weights.size(); i++) {
+    const int position = index + i - (weights.size() - 1 - nextEpochs);
+    if (position >= first && position <= index + nbNext) {
+      sum += weights[i] * window[position];
+    }
+  }
+
+  if (nbPending == maxPending) {
+    // The history is not saved, the oldest epoch is lost
+    std::copy(pending.begin() + 1, pending.end(), pending.begin());
+    nbPending--;
+  }
+  const bool asleep = sum < threshold;
+  const uint32_t time = windowTime - (window.size() - 1 - index) * epochLength;
+  pending[nbPending++] = {time, window[index], asleep};
+  state = asleep ? States::Asleep : States::Awake;
+}
+
+void Actigraphy::FlushWindow() {
+  for (uint8_t remaining = std::min(nbWindow, nextEpochs); remaining > 0; remaining--) {
+    Classify(window.size() - remaining, remaining - 1);
+  }
+  window.fill(0);
+  nbWindow = 0;
+}
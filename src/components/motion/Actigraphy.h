@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "components/fs/TimeSeries.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+
+    /*
+     * Reduces the accelerometer values polled by the system task to an activity count per epoch of one minute, and
+     * classifies each epoch as sleep or wake.
+     *
+     * The activity of a sample is the sum of the absolute differences with the previous sample on each axis (gravity
+     * cancels out), above a dead band that removes the noise of the sensor. It is integrated over the epoch and
+     * normalized to the nominal polling rate. The counts are not calibrated against a reference actigraph.
+     *
+     * The epochs are classified with the Cole-Kripke algorithm (1992, one minute epochs): the weighted sum of the
+     * counts of the 4 previous epochs, the epoch and the 2 next ones. An epoch is therefore classified 2 minutes
+     * after its end, or when the series of epochs is interrupted (the next epochs then count as 0).
+     *
+     * The classified epochs are queued in RAM and appended to a time series by Save(): value = (count << 1) | asleep.
+     * Update() and Save() are called by the system task, the history can be read from another one.
+     */
+    class Actigraphy {
+    public:
+      enum class States : uint8_t { Unknown, Awake, Asleep };
+
+      static constexpr uint32_t epochLength = 60; // seconds
+      static constexpr uint8_t maxPending = 16;
+
+      explicit Actigraphy(FS& fs);
+
+      // Must be called after the file system is mounted
+      void Init();
+
+      // time is in seconds since the epoch
+      void Update(int16_t x, int16_t y, int16_t z, uint32_t time);
+      // Appends the classified epochs to the history, the flash must be awake
+      void Save();
+
+      uint8_t NbPending() const {
+        return nbPending;
+      }
+
+      // State of the last classified epoch
+      States State() const {
+        return state;
+      }
+
+      TimeSeries& History() {
+        return history;
+      }
+
+    private:
+      struct Epoch {
+        uint32_t time;
+        uint16_t count;
+        bool asleep;
+      };
+
+      // Samples of an epoch at the nominal polling rate of 10Hz
+      static constexpr uint32_t nominalSamples = 600;
+      // Epochs with less samples are ignored (the motion is not polled while the watch sleeps, depending on the settings)
+      static constexpr uint32_t minSamples = nominalSamples / 10;
+      static constexpr uint16_t deadBand = 24;
+      static constexpr uint16_t countScale = 100;
+      // Cole-Kripke weights of the epochs -4 to +2, the epoch is asleep if the weighted sum is below threshold
+      static constexpr std::array<uint16_t, 7> weights {106, 54, 58, 76, 230, 74, 67};
+      static constexpr uint32_t threshold = 1000;
+      static constexpr uint8_t nextEpochs = 2;
+
+      // 2 x 64 blocks: 3 to 7 days
+      static constexpr uint16_t historyBlocks = 64;
+      TimeSeries history;
+
+      int16_t lastX = 0;
+      int16_t lastY = 0;
+      int16_t lastZ = 0;
+      bool hasLast = false;
+      uint32_t epochStart = 0;
+      uint32_t activity = 0;
+      uint32_t nbSamples = 0;
+
+      // Counts of the last epochs, the most recent last
+      std::array<uint16_t, weights.size()> window {};
+      uint8_t nbWindow = 0;
+      uint32_t windowTime = 0;
+
+      std::array<Epoch, maxPending> pending;
+      uint8_t nbPending = 0;
+      States state = States::Unknown;
+
+      void CloseEpoch();
+      void AddEpoch(uint32_t time, uint16_t count);
+      void Classify(uint8_t index, uint8_t nbNext);
+      void FlushWindow();
+    };
+  }
+}
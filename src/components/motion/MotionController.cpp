@@ -2,6 +2,7 @@
 
 #include <task.h>
 
+#include "components/datetime/DateTimeController.h"
 #include "utility/Math.h"
 
 using namespace Pinetime::Controllers;
@@ -35,6 +36,10 @@ namespace {
   }
 }
 
+MotionController::MotionController(DateTime& dateTimeController, FS& fs)
+  : dateTimeController {dateTimeController}, history {fs}, actigraphy {fs} {
+}
+
 void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps) {
   if (this->nbSteps != nbSteps && service != nullptr) {
     service->OnNewStepCountValue(nbSteps);
@@ -61,6 +66,10 @@ void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps)
     currentTripSteps += deltaSteps;
   }
   this->nbSteps = nbSteps;
+
+  const uint32_t now = std::chrono::duration_cast<std::chrono::seconds>(dateTimeController.CurrentDateTime().time_since_epoch()).count();
+  history.Update(now / 86400, (now / 3600) % 24, nbSteps);
+  actigraphy.Update(x, y, z, now);
 }
 
 MotionController::AccelStats MotionController::GetAccelStats() const {
@@ -142,6 +151,9 @@ bool MotionController::ShouldLowerSleep() const {
 }
 
 void MotionController::Init(Pinetime::Drivers::Bma421::DeviceTypes types) {
+  history.Init();
+  actigraphy.Init();
+
   switch (types) {
     case Drivers::Bma421::DeviceTypes::BMA421:
       this->deviceType = DeviceTypes::BMA421;
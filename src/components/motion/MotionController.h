@@ -6,10 +6,15 @@
 
 #include "drivers/Bma421.h"
 #include "components/ble/MotionService.h"
+#include "components/motion/Actigraphy.h"
+#include "components/motion/StepHistory.h"
 #include "utility/CircularBuffer.h"
 
 namespace Pinetime {
   namespace Controllers {
+    class DateTime;
+    class FS;
+
     class MotionController {
     public:
       enum class DeviceTypes {
@@ -18,6 +23,8 @@ namespace Pinetime {
         BMA425,
       };
 
+      MotionController(DateTime& dateTimeController, FS& fs);
+
       void Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps);
 
       int16_t X() const {
@@ -56,8 +63,19 @@ namespace Pinetime {
         return deviceType;
       }
 
+      // Must be called after the file system is mounted
       void Init(Pinetime::Drivers::Bma421::DeviceTypes types);
 
+      // Steps of each day, per hour
+      StepHistory& History() {
+        return history;
+      }
+
+      // Activity and sleep per minute
+      Actigraphy& GetActigraphy() {
+        return actigraphy;
+      }
+
       void SetService(Pinetime::Controllers::MotionService* service) {
         this->service = service;
       }
@@ -67,6 +85,10 @@ namespace Pinetime {
       }
 
     private:
+      DateTime& dateTimeController;
+      StepHistory history;
+      Actigraphy actigraphy;
+
       uint32_t nbSteps = 0;
       uint32_t currentTripSteps = 0;
 
@@ -0,0 +1,194 @@
+#include "components/motion/StepHistory.h"
+#include "components/fs/FS.h"
+#include <algorithm>
+
+using namespace Pinetime::Controllers;
+
+StepHistory::StepHistory(FS& fs) : fs {fs} {
+}
+
+void StepHistory::Init() {
+  mutex = xSemaphoreCreateMutex();
+
+  lfs_info info;
+  if (fs.Stat(directory, &info) != LFS_ERR_OK) {
+    fs.DirCreate(directory);
+  }
+  previousRecords = RecordsInFile(previousPath);
+  currentRecords = RecordsInFile(currentPath);
+  DayRecord last;
+  if (previousRecords + currentRecords > 0 && Load(previousRecords + currentRecords - 1, last)) {
+    lastDay = last.day;
+  }
+
+  if (!ReadFile(todayPath, 0, today) || (today.day <= lastDay && previousRecords + currentRecords > 0)) {
+    // No record yet, or the reset happened after the day was appended and before the new one was written
+    today = {};
+  }
+}
+
+void StepHistory::Update(uint16_t day, uint8_t hour, uint32_t nbSteps) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const uint32_t delta = (nbSteps >= lastSteps) ? nbSteps - lastSteps : nbSteps;
+  lastSteps = nbSteps;
+
+  if (day > today.day) {
+    if (today.total > 0) {
+      // If the previous day is still pending, the flash was not awake for a whole day and it is lost
+      finished = today;
+      finishedPending = true;
+    }
+    today = {};
+    today.day = day;
+    todayDirty = true;
+  }
+  if (delta > 0) {
+    today.hours[hour] = std::min<uint32_t>(today.hours[hour] + delta, UINT16_MAX);
+    today.total += delta;
+    todayDirty = true;
+  }
+  currentHour = hour;
+  xSemaphoreGive(mutex);
+}
+
+void StepHistory::Save() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (finishedPending) {
+    Append(finished);
+    finishedPending = false;
+  }
+  if (todayDirty && currentHour != savedHour) {
+    WriteToday();
+    savedHour = currentHour;
+    todayDirty = false;
+  }
+  xSemaphoreGive(mutex);
+}
+
+uint16_t StepHistory::CurrentDay() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const uint16_t day = today.day;
+  xSemaphoreGive(mutex);
+  return day;
+}
+
+uint16_t StepHistory::NbRecords() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const uint16_t nbRecords = previousRecords + currentRecords + (finishedPending ? 1 : 0) + ((today.day != 0) ? 1 : 0);
+  xSemaphoreGive(mutex);
+  return nbRecords;
+}
+
+uint16_t StepHistory::FindRecord(uint16_t day) {
+  const uint16_t nbRecords = NbRecords();
+  uint16_t low = 0;
+  uint16_t high = nbRecords;
+  while (low < high) {
+    const uint16_t middle = low + (high - low) / 2;
+    DayRecord record;
+    if (!ReadRecord(middle, record)) {
+      return nbRecords;
+    }
+    if (record.day < day) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+bool StepHistory::ReadRecord(uint16_t index, DayRecord& record) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const bool valid = Load(index, record);
+  xSemaphoreGive(mutex);
+  return valid;
+}
+
+size_t StepHistory::Read(uint16_t firstDay, DayRecord* records, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    records[i] = {};
+    records[i].day = firstDay + i;
+  }
+
+  size_t nbDays = 0;
+  DayRecord record;
+  for (uint16_t index = FindRecord(firstDay); ReadRecord(index, record) && record.day < firstDay + count; index++) {
+    records[record.day - firstDay] = record;
+    nbDays++;
+  }
+  return nbDays;
+}
+
+bool StepHistory::Load(uint16_t index, DayRecord& record) {
+  if (index < previousRecords) {
+    return ReadFile(previousPath, index, record);
+  }
+  index -= previousRecords;
+  if (index < currentRecords) {
+    return ReadFile(currentPath, index, record);
+  }
+  index -= currentRecords;
+  if (finishedPending) {
+    if (index == 0) {
+      record = finished;
+      return true;
+    }
+    index--;
+  }
+  if (index == 0 && today.day != 0) {
+    record = today;
+    return true;
+  }
+  return false;
+}
+
+uint16_t StepHistory::RecordsInFile(const char* path) {
+  lfs_info info;
+  if (fs.Stat(path, &info) != LFS_ERR_OK) {
+    return 0;
+  }
+  // An incomplete record (power loss while it was written) is ignored, and overwritten by the next one
+  return info.size / sizeof(DayRecord);
+}
+
+bool StepHistory::ReadFile(const char* path, uint16_t index, DayRecord& record) {
+  lfs_file_t file;
+  if (fs.FileOpen(&file, path, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+  const bool valid = fs.FileSeek(&file, index * sizeof(DayRecord)) >= 0 &&
+                     fs.FileRead(&file, reinterpret_cast<uint8_t*>(&record), sizeof(record)) == static_cast<int>(sizeof(record));
+  fs.FileClose(&file);
+  return valid;
+}
+
+void StepHistory::Append(const DayRecord& record) {
+  if (previousRecords + currentRecords > 0 && record.day <= lastDay) {
+    return;
+  }
+  if (currentRecords >= maxDays) {
+    fs.FileDelete(previousPath);
+    fs.Rename(currentPath, previousPath);
+    previousRecords = currentRecords;
+    currentRecords = 0;
+  }
+
+  lfs_file_t file;
+  if (fs.FileOpen(&file, currentPath, LFS_O_WRONLY | LFS_O_CREAT) == LFS_ERR_OK) {
+    if (fs.FileSeek(&file, currentRecords * sizeof(DayRecord)) >= 0 &&
+        fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&record), sizeof(record)) == static_cast<int>(sizeof(record))) {
+      currentRecords++;
+      lastDay = record.day;
+    }
+    fs.FileClose(&file);
+  }
+}
+
+void StepHistory::WriteToday() {
+  lfs_file_t file;
+  if (fs.FileOpen(&file, todayPath, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) == LFS_ERR_OK) {
+    fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&today), sizeof(today));
+    fs.FileClose(&file);
+  }
+}
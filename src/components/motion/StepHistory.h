@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+
+    /*
+     * Number of steps of each day, per hour, stored in the file system.
+     *
+     * The steps of the current day are counted in RAM and written to a small file at most once per hour, so that
+     * at most one hour of steps is lost on reset. When the day changes, its record is appended to the file of the
+     * finished days: one page is programmed per day, and the records are never rewritten. The records have a fixed
+     * size and are sorted by day, record n is at offset n * sizeof(DayRecord). Like TimeSeries, the history keeps
+     * 2 files of maxDays records: when the current file is full, it replaces the previous one, which is deleted.
+     *
+     * The days are numbered from the epoch, in local time. The history never goes back in time: if the clock does
+     * (or is not set yet after a reset), the steps are counted in the latest day.
+     *
+     * Update() and Save() are called by the system task, the records can be read from another one.
+     */
+    class StepHistory {
+    public:
+      struct DayRecord {
+        uint16_t day;
+        uint16_t reserved;
+        uint32_t total;
+        std::array<uint16_t, 24> hours;
+      };
+
+      // The records of a year in each file
+      static constexpr uint16_t maxDays = 366;
+
+      explicit StepHistory(FS& fs);
+      StepHistory(const StepHistory&) = delete;
+      StepHistory& operator=(const StepHistory&) = delete;
+
+      // Must be called after the file system is mounted
+      void Init();
+
+      // nbSteps is the value of the step counter of the sensor, the difference with the previous value is counted in
+      // the current hour. The counter can be reset at any time.
+      void Update(uint16_t day, uint8_t hour, uint32_t nbSteps);
+      // Writes the records that changed, must be called while the flash is awake
+      void Save();
+
+      // The latest day, 0 until the first update
+      uint16_t CurrentDay();
+
+      // Number of records, including the current day
+      uint16_t NbRecords();
+      // Index of the first record of day or after it, NbRecords() if there is none
+      uint16_t FindRecord(uint16_t day);
+      bool ReadRecord(uint16_t index, DayRecord& record);
+
+      // Fills records[i] with the steps of firstDay + i (zero for the days without record), returns the number of
+      // days that have a record
+      size_t Read(uint16_t firstDay, DayRecord* records, size_t count);
+
+    private:
+      static constexpr const char* directory = "/steps";
+      static constexpr const char* todayPath = "/steps/today";
+      static constexpr const char* currentPath = "/steps/current";
+      static constexpr const char* previousPath = "/steps/previous";
+
+      FS& fs;
+      SemaphoreHandle_t mutex = nullptr;
+      uint16_t previousRecords = 0;
+      uint16_t currentRecords = 0;
+      // Day of the last record of the files
+      uint16_t lastDay = 0;
+
+      DayRecord today {};
+      // The previous day, until it is appended to the current file
+      DayRecord finished {};
+      bool finishedPending = false;
+      bool todayDirty = false;
+      uint8_t currentHour = 0;
+      // Hour of today whose steps were written last, 24 if none
+      uint8_t savedHour = 24;
+      uint32_t lastSteps = 0;
+
+      uint16_t RecordsInFile(const char* path);
+      bool ReadFile(const char* path, uint16_t index, DayRecord& record);
+      bool Load(uint16_t index, DayRecord& record);
+      void Append(const DayRecord& record);
+      void WriteToday();
+    };
+  }
+}
@@ -5,35 +5,37 @@
 
 using namespace Pinetime::Controllers;
 
+MotorController::MotorController(TimerWheel& timerWheel)
+  : timerWheel {timerWheel}, shortVib {StopMotor, nullptr}, longVib {Ring, this, pdMS_TO_TICKS(30)} {
+}
+
 void MotorController::Init() {
   nrf_gpio_cfg_output(PinMap::Motor);
   nrf_gpio_pin_set(PinMap::Motor);
-
-  shortVib = xTimerCreate("shortVib", 1, pdFALSE, nullptr, StopMotor);
-  longVib = xTimerCreate("longVib", pdMS_TO_TICKS(1000), pdTRUE, this, Ring);
 }
 
-void MotorController::Ring(TimerHandle_t xTimer) {
-  auto* motorController = static_cast<MotorController*>(pvTimerGetTimerID(xTimer));
+void MotorController::Ring(void* context) {
+  auto* motorController = static_cast<MotorController*>(context);
   motorController->RunForDuration(50);
 }
 
 void MotorController::RunForDuration(uint8_t motorDuration) {
-  if (motorDuration > 0 && xTimerChangePeriod(shortVib, pdMS_TO_TICKS(motorDuration), 0) == pdPASS && xTimerStart(shortVib, 0) == pdPASS) {
+  if (motorDuration > 0) {
+    timerWheel.Start(shortVib, pdMS_TO_TICKS(motorDuration));
     nrf_gpio_pin_clear(PinMap::Motor);
   }
 }
 
 void MotorController::StartRinging() {
   RunForDuration(50);
-  xTimerStart(longVib, 0);
+  timerWheel.Start(longVib, pdMS_TO_TICKS(1000), pdMS_TO_TICKS(1000));
 }
 
 void MotorController::StopRinging() {
-  xTimerStop(longVib, 0);
+  timerWheel.Stop(longVib);
   nrf_gpio_pin_set(PinMap::Motor);
 }
 
-void MotorController::StopMotor(TimerHandle_t /*xTimer*/) {
+void MotorController::StopMotor(void* /*context*/) {
   nrf_gpio_pin_set(PinMap::Motor);
 }
@@ -1,15 +1,14 @@
 #pragma once
 
-#include <FreeRTOS.h>
-#include <timers.h>
 #include <cstdint>
+#include "components/timer/TimerWheel.h"
 
 namespace Pinetime {
   namespace Controllers {
 
     class MotorController {
     public:
-      MotorController() = default;
+      explicit MotorController(TimerWheel& timerWheel);
 
       void Init();
       void RunForDuration(uint8_t motorDuration);
@@ -17,10 +16,12 @@ namespace Pinetime {
       void StopRinging();
 
     private:
-      static void Ring(TimerHandle_t xTimer);
-      static void StopMotor(TimerHandle_t xTimer);
-      TimerHandle_t shortVib;
-      TimerHandle_t longVib;
+      static void Ring(void* context);
+      static void StopMotor(void* context);
+
+      TimerWheel& timerWheel;
+      TimerWheel::Timer shortVib;
+      TimerWheel::Timer longVib;
     };
   }
 }
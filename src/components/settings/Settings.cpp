@@ -1,10 +1,26 @@
 #include "components/settings/Settings.h"
 #include <cstdlib>
 #include <cstring>
+#include <type_traits>
+#include <task.h>
 
 using namespace Pinetime::Controllers;
 
+namespace {
+  template <typename Fields>
+  constexpr bool FitInAttributes(const Fields& fields) {
+    for (const auto& field : fields) {
+      if (field.size > FS::maxAttributeSize) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
 Settings::Settings(Pinetime::Controllers::FS& fs) : fs {fs} {
+  static_assert(std::is_standard_layout_v<SettingsData>, "The fields are located with offsetof");
+  static_assert(FitInAttributes(fields), "A field is larger than an attribute");
 }
 
 void Settings::Init() {
@@ -17,31 +33,88 @@ void Settings::SaveSettings() {
 
   // verify if is necessary to save
   if (settingsChanged) {
-    SaveSettingsToFile();
+    flushPending = true;
+    saveTime = xTaskGetTickCount();
   }
   settingsChanged = false;
 }
 
-void Settings::LoadSettingsFromFile() {
-  SettingsData bufferSettings;
-  lfs_file_t settingsFile;
+void Settings::FlushPending() {
+  if (flushPending && xTaskGetTickCount() - saveTime >= flushDelay) {
+    Flush();
+  }
+}
+
+void Settings::Flush() {
+  if (flushPending) {
+    SaveSettingsToFile();
+  }
+  flushPending = false;
+}
 
-  if (fs.FileOpen(&settingsFile, "/settings.dat", LFS_O_RDONLY) != LFS_ERR_OK) {
+void Settings::LoadSettingsFromFile() {
+  lfs_info info;
+  if (fs.Stat(settingsPath, &info) != LFS_ERR_OK) {
+    LoadLegacySettings();
     return;
   }
-  fs.FileRead(&settingsFile, reinterpret_cast<uint8_t*>(&bufferSettings), sizeof(settings));
-  fs.FileClose(&settingsFile);
-  if (bufferSettings.version == settingsVersion) {
-    settings = bufferSettings;
+
+  auto* data = reinterpret_cast<uint8_t*>(&settings);
+  for (const auto& field : fields) {
+    uint8_t value[FS::maxAttributeSize];
+    if (fs.GetAttribute(settingsPath, field.key, value, sizeof(value)) == field.size) {
+      std::memcpy(data + field.offset, value, field.size);
+    }
   }
+  savedSettings = settings;
 }
 
-void Settings::SaveSettingsToFile() {
+void Settings::LoadLegacySettings() {
+  LegacySettingsData legacy;
   lfs_file_t settingsFile;
 
-  if (fs.FileOpen(&settingsFile, "/settings.dat", LFS_O_WRONLY | LFS_O_CREAT) != LFS_ERR_OK) {
+  if (fs.FileOpen(&settingsFile, legacyPath, LFS_O_RDONLY) == LFS_ERR_OK) {
+    const int size = fs.FileRead(&settingsFile, reinterpret_cast<uint8_t*>(&legacy), sizeof(legacy));
+    fs.FileClose(&settingsFile);
+    if (size == sizeof(legacy) && legacy.version == legacyVersion) {
+      // The fields added since then keep their default value
+      settings.stepsGoal = legacy.stepsGoal;
+      settings.screenTimeOut = legacy.screenTimeOut;
+      settings.clockType = static_cast<ClockType>(legacy.clockType);
+      settings.weatherFormat = static_cast<WeatherFormat>(legacy.weatherFormat);
+      settings.notificationStatus = static_cast<Notification>(legacy.notificationStatus);
+      settings.watchFace = static_cast<Pinetime::Applications::WatchFace>(legacy.watchFace);
+      settings.chimesOption = static_cast<ChimesOption>(legacy.chimesOption);
+      settings.PTS.ColorTime = static_cast<Colors>(legacy.PTS.colorTime);
+      settings.PTS.ColorBar = static_cast<Colors>(legacy.PTS.colorBar);
+      settings.PTS.ColorBG = static_cast<Colors>(legacy.PTS.colorBG);
+      settings.PTS.gaugeStyle = static_cast<PTSGaugeStyle>(legacy.PTS.gaugeStyle);
+      settings.PTS.weatherEnable = static_cast<PTSWeather>(legacy.PTS.weatherEnable);
+      settings.watchFaceInfineat.showSideCover = legacy.watchFaceInfineat.showSideCover;
+      settings.watchFaceInfineat.colorIndex = legacy.watchFaceInfineat.colorIndex;
+      settings.wakeUpMode = legacy.wakeUpMode;
+      settings.shakeWakeThreshold = legacy.shakeWakeThreshold;
+      settings.brightLevel = static_cast<Controllers::BrightnessController::Levels>(legacy.brightLevel);
+    }
+  }
+
+  // The attributes are stored on an empty file, only the fields that are not set to their default value are written
+  if (fs.FileOpen(&settingsFile, settingsPath, LFS_O_WRONLY | LFS_O_CREAT) != LFS_ERR_OK) {
     return;
   }
-  fs.FileWrite(&settingsFile, reinterpret_cast<uint8_t*>(&settings), sizeof(settings));
   fs.FileClose(&settingsFile);
+  savedSettings = {};
+  SaveSettingsToFile();
+  fs.FileDelete(legacyPath);
+}
+
+void Settings::SaveSettingsToFile() {
+  const auto* data = reinterpret_cast<const uint8_t*>(&settings);
+  auto* saved = reinterpret_cast<uint8_t*>(&savedSettings);
+  for (const auto& field : fields) {
+    if (std::memcmp(data + field.offset, saved + field.offset, field.size) != 0 &&
+        fs.SetAttribute(settingsPath, field.key, data + field.offset, field.size) == LFS_ERR_OK) {
+      std::memcpy(saved + field.offset, data + field.offset, field.size);
+    }
+  }
 }
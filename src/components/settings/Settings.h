@@ -1,6 +1,9 @@
 #pragma once
-#include <cstdint>
+#include <array>
 #include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
 #include "components/brightness/BrightnessController.h"
 #include "components/fs/FS.h"
 #include "displayapp/apps/Apps.h"
@@ -58,7 +61,12 @@ namespace Pinetime {
       Settings& operator=(Settings&&) = delete;
 
       void Init();
+      // Schedules the write of the settings that changed, see Flush()
       void SaveSettings();
+      // Writes the changed settings if they were saved at least flushDelay ago: consecutive changes are coalesced
+      void FlushPending();
+      // Writes the changed settings now, before the flash goes to sleep
+      void Flush();
 
       void SetWatchFace(Pinetime::Applications::WatchFace face) {
         if (face != settings.watchFace) {
@@ -214,6 +222,17 @@ namespace Pinetime {
         return settings.screenTimeOut;
       };
 
+      void SetAlwaysOnDisplay(bool enabled) {
+        if (enabled != settings.alwaysOnDisplay) {
+          settingsChanged = true;
+        }
+        settings.alwaysOnDisplay = enabled;
+      };
+
+      bool GetAlwaysOnDisplay() const {
+        return settings.alwaysOnDisplay;
+      };
+
       void SetShakeThreshold(uint16_t thresh) {
         if (settings.shakeWakeThreshold != thresh) {
           settings.shakeWakeThreshold = thresh;
@@ -275,6 +294,18 @@ namespace Pinetime {
         return settings.stepsGoal;
       };
 
+      // Interval of the background heart rate measurement in seconds, 0 when disabled
+      void SetHeartRateBackgroundInterval(uint32_t interval) {
+        if (interval != settings.heartRateBackgroundInterval) {
+          settingsChanged = true;
+        }
+        settings.heartRateBackgroundInterval = interval;
+      };
+
+      uint32_t GetHeartRateBackgroundInterval() const {
+        return settings.heartRateBackgroundInterval;
+      };
+
       void SetBleRadioEnabled(bool enabled) {
         bleRadioEnabled = enabled;
       };
@@ -286,12 +317,55 @@ namespace Pinetime {
     private:
       Pinetime::Controllers::FS& fs;
 
-      static constexpr uint32_t settingsVersion = 0x0007;
+      /*
+       * Each field of SettingsData is stored as a custom attribute of settingsPath, its key is the type of the
+       * attribute: changing a field appends a small commit to the metadata log of littlefs, instead of rewriting a
+       * file. A field without attribute, or whose attribute does not have the size of the field, keeps its default
+       * value. A key is never reused: if the type of a field changes, it gets a new key (and the old value can be
+       * converted when the settings are loaded).
+       */
+      static constexpr const char* settingsPath = "/settings";
+      // Settings of the released firmwares, stored as a LegacySettingsData blob
+      static constexpr const char* legacyPath = "/settings.dat";
+      static constexpr uint32_t legacyVersion = 0x0007;
+      static constexpr TickType_t flushDelay = pdMS_TO_TICKS(2000);
+
+      // Frozen copy of the layout of settings version 7: it must not follow the changes of SettingsData
+      struct LegacySettingsData {
+        uint32_t version;
+        uint32_t stepsGoal;
+        uint32_t screenTimeOut;
+
+        uint8_t clockType;
+        uint8_t weatherFormat;
+        uint8_t notificationStatus;
+
+        uint8_t watchFace;
+        uint8_t chimesOption;
+
+        struct {
+          uint8_t colorTime;
+          uint8_t colorBar;
+          uint8_t colorBG;
+          uint8_t gaugeStyle;
+          uint8_t weatherEnable;
+        } PTS;
+
+        struct {
+          bool showSideCover;
+          int colorIndex;
+        } watchFaceInfineat;
+
+        std::bitset<5> wakeUpMode;
+        uint16_t shakeWakeThreshold;
+
+        int brightLevel;
+      };
 
       struct SettingsData {
-        uint32_t version = settingsVersion;
         uint32_t stepsGoal = 10000;
         uint32_t screenTimeOut = 15000;
+        bool alwaysOnDisplay = false;
 
         ClockType clockType = ClockType::H24;
         WeatherFormat weatherFormat = WeatherFormat::Metric;
@@ -308,10 +382,39 @@ namespace Pinetime {
         uint16_t shakeWakeThreshold = 150;
 
         Controllers::BrightnessController::Levels brightLevel = Controllers::BrightnessController::Levels::Medium;
+
+        uint32_t heartRateBackgroundInterval = 0;
       };
 
+      struct Field {
+        uint8_t key;
+        uint8_t offset;
+        uint8_t size;
+      };
+
+      static constexpr std::array<Field, 14> fields {{
+        {1, offsetof(SettingsData, stepsGoal), sizeof(SettingsData::stepsGoal)},
+        {2, offsetof(SettingsData, screenTimeOut), sizeof(SettingsData::screenTimeOut)},
+        {3, offsetof(SettingsData, alwaysOnDisplay), sizeof(SettingsData::alwaysOnDisplay)},
+        {4, offsetof(SettingsData, clockType), sizeof(SettingsData::clockType)},
+        {5, offsetof(SettingsData, weatherFormat), sizeof(SettingsData::weatherFormat)},
+        {6, offsetof(SettingsData, notificationStatus), sizeof(SettingsData::notificationStatus)},
+        {7, offsetof(SettingsData, watchFace), sizeof(SettingsData::watchFace)},
+        {8, offsetof(SettingsData, chimesOption), sizeof(SettingsData::chimesOption)},
+        {9, offsetof(SettingsData, PTS), sizeof(SettingsData::PTS)},
+        {10, offsetof(SettingsData, watchFaceInfineat), sizeof(SettingsData::watchFaceInfineat)},
+        {11, offsetof(SettingsData, wakeUpMode), sizeof(SettingsData::wakeUpMode)},
+        {12, offsetof(SettingsData, shakeWakeThreshold), sizeof(SettingsData::shakeWakeThreshold)},
+        {13, offsetof(SettingsData, brightLevel), sizeof(SettingsData::brightLevel)},
+        {14, offsetof(SettingsData, heartRateBackgroundInterval), sizeof(SettingsData::heartRateBackgroundInterval)},
+      }};
+
       SettingsData settings;
+      // As stored in the file system
+      SettingsData savedSettings;
       bool settingsChanged = false;
+      bool flushPending = false;
+      TickType_t saveTime = 0;
 
       uint8_t appMenu = 0;
       uint8_t settingsMenu = 0;
@@ -322,6 +425,7 @@ namespace Pinetime {
       bool bleRadioEnabled = true;
 
       void LoadSettingsFromFile();
+      void LoadLegacySettings();
       void SaveSettingsToFile();
     };
   }
@@ -2,27 +2,26 @@
 
 using namespace Pinetime::Controllers;
 
-Timer::Timer(void* const timerData, TimerCallbackFunction_t timerCallbackFunction) {
-  timer = xTimerCreate("Timer", 1, pdFALSE, timerData, timerCallbackFunction);
+Timer::Timer(TimerWheel& timerWheel, void* const timerData, TimerWheel::Callback timerCallbackFunction)
+  : timerWheel {timerWheel}, timer {timerCallbackFunction, timerData} {
 }
 
 void Timer::StartTimer(std::chrono::milliseconds duration) {
-  xTimerChangePeriod(timer, pdMS_TO_TICKS(duration.count()), 0);
-  xTimerStart(timer, 0);
+  timerWheel.Start(timer, pdMS_TO_TICKS(duration.count()));
 }
 
 std::chrono::milliseconds Timer::GetTimeRemaining() {
   if (IsRunning()) {
-    TickType_t remainingTime = xTimerGetExpiryTime(timer) - xTaskGetTickCount();
+    TickType_t remainingTime = timerWheel.Remaining(timer);
     return std::chrono::milliseconds(remainingTime * 1000 / configTICK_RATE_HZ);
   }
   return std::chrono::milliseconds(0);
 }
 
 void Timer::StopTimer() {
-  xTimerStop(timer, 0);
+  timerWheel.Stop(timer);
 }
 
 bool Timer::IsRunning() {
-  return (xTimerIsTimerActive(timer) == pdTRUE);
+  return timerWheel.IsActive(timer);
 }
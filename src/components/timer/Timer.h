@@ -1,7 +1,6 @@
 #pragma once
 
-#include <FreeRTOS.h>
-#include <timers.h>
+#include "components/timer/TimerWheel.h"
 
 #include <chrono>
 
@@ -9,7 +8,7 @@ namespace Pinetime {
   namespace Controllers {
     class Timer {
     public:
-      Timer(void* timerData, TimerCallbackFunction_t timerCallbackFunction);
+      Timer(TimerWheel& timerWheel, void* timerData, TimerWheel::Callback timerCallbackFunction);
 
       void StartTimer(std::chrono::milliseconds duration);
 
@@ -20,7 +19,8 @@ namespace Pinetime {
       bool IsRunning();
 
     private:
-      TimerHandle_t timer;
+      TimerWheel& timerWheel;
+      TimerWheel::Timer timer;
     };
   }
 }
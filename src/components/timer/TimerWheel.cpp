@@ -0,0 +1,293 @@
+#include "components/timer/TimerWheel.h"
+
+using namespace Pinetime::Controllers;
+
+void TimerWheel::Init() {
+  // Auto-reload: if the timer cannot be reprogrammed when it expires, it expires again after the same period and
+  // Process() retries
+  timer = xTimerCreate("timerWheel", 1, pdTRUE, this, Process);
+}
+
+void TimerWheel::Start(Timer& wheelTimer, TickType_t delay, TickType_t period) {
+  vTaskSuspendAll();
+  Insert(wheelTimer, xTaskGetTickCount(), delay, period);
+  Reprogram();
+  xTaskResumeAll();
+  RetryReprogram();
+}
+
+void TimerWheel::Stop(Timer& wheelTimer) {
+  vTaskSuspendAll();
+  Remove(wheelTimer);
+  Reprogram();
+  xTaskResumeAll();
+  RetryReprogram();
+}
+
+bool TimerWheel::IsActive(const Timer& wheelTimer) const {
+  return wheelTimer.previous != nullptr;
+}
+
+TickType_t TimerWheel::Remaining(const Timer& wheelTimer) const {
+  if (!IsActive(wheelTimer)) {
+    return 0;
+  }
+  TickType_t remaining = wheelTimer.expiry - xTaskGetTickCount();
+  return (static_cast<int32_t>(remaining) > 0) ? remaining : 0;
+}
+
+void TimerWheel::Insert(Timer& wheelTimer, TickType_t now, TickType_t delay, TickType_t period) {
+  Remove(wheelTimer);
+  if (nbActive == 0) {
+    // Nothing to process until now, no need to walk through the wheel
+    current = now;
+  }
+
+  wheelTimer.period = period;
+  wheelTimer.expiry = now + ((delay > 0) ? delay : 1);
+  wheelTimer.deadline = Coalesce(wheelTimer.expiry, wheelTimer.slack);
+  Schedule(wheelTimer);
+  nbActive++;
+}
+
+void TimerWheel::Remove(Timer& wheelTimer) {
+  if (wheelTimer.previous == nullptr) {
+    return;
+  }
+
+  *wheelTimer.previous = wheelTimer.next;
+  if (wheelTimer.next != nullptr) {
+    wheelTimer.next->previous = wheelTimer.previous;
+  }
+  if (wheelTimer.slot < overflowSlot && slots[wheelTimer.slot] == nullptr) {
+    occupied[wheelTimer.slot / nbSlots] &= ~(1 << (wheelTimer.slot % nbSlots));
+  }
+  wheelTimer.next = nullptr;
+  wheelTimer.previous = nullptr;
+  nbActive--;
+}
+
+void TimerWheel::Advance(TickType_t now) {
+  while (static_cast<int32_t>(now - current) > 0) {
+    // Jump to the next tick at which something can happen: the next tick if level 0 has timers,
+    // the next boundary of the first level that has timers otherwise.
+    uint8_t level = 0;
+    TickType_t step = 1;
+    while (level < nbLevels && occupied[level] == 0) {
+      level++;
+      step = Granularity(level);
+    }
+    if (level == nbLevels && slots[overflowSlot] == nullptr) {
+      current = now;
+      break;
+    }
+
+    TickType_t next = (current | (step - 1)) + 1;
+    if (static_cast<int32_t>(now - next) < 0) {
+      current = now;
+      break;
+    }
+    current = next;
+
+    // Higher levels first: their timers can move to a lower level slot that expires now
+    if ((current & (Granularity(nbLevels) - 1)) == 0) {
+      Cascade(overflowSlot);
+    }
+    for (uint8_t l = nbLevels - 1; l > 0; l--) {
+      if ((current & (Granularity(l) - 1)) == 0) {
+        Cascade(l * nbSlots + ((current >> (slotBits * l)) & (nbSlots - 1)));
+      }
+    }
+    Cascade(current & (nbSlots - 1));
+  }
+}
+
+TimerWheel::Timer* TimerWheel::PopExpired() {
+  Timer* expired = slots[expiredSlot];
+  if (expired == nullptr) {
+    return nullptr;
+  }
+
+  Remove(*expired);
+  if (expired->period != 0) {
+    expired->expiry += expired->period;
+    if (static_cast<int32_t>(expired->expiry - current) <= 0) {
+      // Periods missed while the timer task was busy are skipped
+      expired->expiry = current + expired->period;
+    }
+    expired->deadline = Coalesce(expired->expiry, expired->slack);
+    Schedule(*expired);
+    nbActive++;
+  }
+  return expired;
+}
+
+bool TimerWheel::NextDeadline(TickType_t& deadline) const {
+  if (slots[expiredSlot] != nullptr) {
+    deadline = current;
+    return true;
+  }
+
+  bool found = false;
+  auto update = [&](const Timer* first) {
+    for (const Timer* t = first; t != nullptr; t = t->next) {
+      if (!found || static_cast<int32_t>(t->deadline - deadline) < 0) {
+        deadline = t->deadline;
+        found = true;
+      }
+    }
+  };
+
+  for (uint8_t level = 0; level < nbLevels; level++) {
+    if (occupied[level] == 0) {
+      continue;
+    }
+    // The slot of the current time is the last one: it contains the timers that wrapped around the level
+    const uint8_t start = ((current >> (slotBits * level)) + 1) & (nbSlots - 1);
+    for (uint8_t i = 0; i < nbSlots; i++) {
+      const uint8_t index = (start + i) & (nbSlots - 1);
+      if ((occupied[level] & (1 << index)) != 0) {
+        update(slots[level * nbSlots + index]);
+        break;
+      }
+    }
+  }
+  update(slots[overflowSlot]);
+  return found;
+}
+
+TickType_t TimerWheel::Coalesce(TickType_t expiry, TickType_t slack) {
+  if (slack == 0) {
+    return expiry;
+  }
+  // Largest power of 2 <= slack + 1: the deadline is delayed by at most slack ticks
+  const TickType_t alignment = static_cast<TickType_t>(1) << (31 - __builtin_clz(slack + 1));
+  return (expiry + alignment - 1) & ~(alignment - 1);
+}
+
+void TimerWheel::Schedule(Timer& wheelTimer) {
+  const TickType_t delta = wheelTimer.deadline - current;
+  if (static_cast<int32_t>(delta) <= 0) {
+    Link(wheelTimer, expiredSlot);
+    return;
+  }
+
+  uint8_t level = 0;
+  while (level < nbLevels && delta >= Granularity(level + 1)) {
+    level++;
+  }
+  if (level == nbLevels) {
+    Link(wheelTimer, overflowSlot);
+  } else {
+    Link(wheelTimer, level * nbSlots + ((wheelTimer.deadline >> (slotBits * level)) & (nbSlots - 1)));
+  }
+}
+
+void TimerWheel::Link(Timer& wheelTimer, uint8_t slot) {
+  wheelTimer.next = slots[slot];
+  if (wheelTimer.next != nullptr) {
+    wheelTimer.next->previous = &wheelTimer.next;
+  }
+  slots[slot] = &wheelTimer;
+  wheelTimer.previous = &slots[slot];
+  wheelTimer.slot = slot;
+  if (slot < overflowSlot) {
+    occupied[slot / nbSlots] |= (1 << (slot % nbSlots));
+  }
+}
+
+void TimerWheel::Cascade(uint8_t slot) {
+  Timer* wheelTimer = slots[slot];
+  slots[slot] = nullptr;
+  if (slot < overflowSlot) {
+    occupied[slot / nbSlots] &= ~(1 << (slot % nbSlots));
+  }
+
+  while (wheelTimer != nullptr) {
+    Timer* next = wheelTimer->next;
+    Schedule(*wheelTimer);
+    wheelTimer = next;
+  }
+}
+
+void TimerWheel::Reprogram() {
+  TickType_t deadline = 0;
+  const bool active = NextDeadline(deadline);
+  if (!reprogramPending && programmed == active && (!active || deadline == programmedDeadline)) {
+    return;
+  }
+
+  // The scheduler is suspended, the command cannot wait for room in the queue of the timer task
+  if (SendCommand(active, deadline, 0) == pdPASS) {
+    programmed = active;
+    programmedDeadline = deadline;
+    reprogramPending = false;
+  } else {
+    reprogramPending = true;
+  }
+}
+
+void TimerWheel::RetryReprogram() {
+  // The timer task cannot wait for itself to empty its queue: Process() reprograms the timer before returning,
+  // and is called again by the auto-reload if it fails.
+  if (xTaskGetCurrentTaskHandle() == xTimerGetTimerDaemonTaskHandle()) {
+    return;
+  }
+
+  vTaskSuspendAll();
+  while (reprogramPending) {
+    TickType_t deadline = 0;
+    const bool active = NextDeadline(deadline);
+    xTaskResumeAll();
+    const BaseType_t sent = SendCommand(active, deadline, commandTimeout);
+    vTaskSuspendAll();
+    if (sent != pdPASS) {
+      // Still pending: retried by the next call to Start() or Stop(), or by Process()
+      break;
+    }
+    // The timers may have changed, and other commands may have been queued, while the command was waiting
+    programmed = active;
+    programmedDeadline = deadline;
+    reprogramPending = false;
+    Reprogram();
+  }
+  xTaskResumeAll();
+}
+
+BaseType_t TimerWheel::SendCommand(bool active, TickType_t deadline, TickType_t blockTime) {
+  if (!active) {
+    return xTimerStop(timer, blockTime);
+  }
+  const TickType_t delay = deadline - xTaskGetTickCount();
+  return xTimerChangePeriod(timer, (static_cast<int32_t>(delay) > 0) ? delay : 1, blockTime);
+}
+
+void TimerWheel::Process(TimerHandle_t xTimer) {
+  auto* wheel = static_cast<TimerWheel*>(pvTimerGetTimerID(xTimer));
+
+  vTaskSuspendAll();
+  wheel->wakeups++;
+  // The timer reloaded itself with the same period, it must be reprogrammed
+  wheel->reprogramPending = true;
+  wheel->Advance(xTaskGetTickCount());
+  xTaskResumeAll();
+
+  // The callbacks are called with the scheduler running, they can start and stop timers
+  while (true) {
+    vTaskSuspendAll();
+    Timer* expired = wheel->PopExpired();
+    if (expired != nullptr) {
+      wheel->expirations++;
+    }
+    xTaskResumeAll();
+
+    if (expired == nullptr) {
+      break;
+    }
+    expired->callback(expired->context);
+  }
+
+  vTaskSuspendAll();
+  wheel->Reprogram();
+  xTaskResumeAll();
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <FreeRTOS.h>
+#include <timers.h>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    /*
+     * Hierarchical timer wheel that multiplexes the software timers of the firmware on a single FreeRTOS timer.
+     *
+     * Each timer has a slack: its deadline is rounded up to a multiple of the largest power of 2 that does not exceed
+     * the slack, so that timers expiring close to each other are aligned on the same tick and share one wakeup.
+     *
+     * Timers are started and stopped from tasks (not from interrupt handlers), callbacks run in the context of the
+     * FreeRTOS timer task, like the callbacks of FreeRTOS timers.
+     */
+    class TimerWheel {
+    public:
+      using Callback = void (*)(void* context);
+
+      class Timer {
+      public:
+        Timer(Callback callback, void* context, TickType_t slack = 0) : callback {callback}, context {context}, slack {slack} {
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+      private:
+        friend class TimerWheel;
+
+        Callback callback;
+        void* context;
+        TickType_t slack;
+        TickType_t period = 0;
+        TickType_t expiry = 0;   // Requested expiry
+        TickType_t deadline = 0; // Expiry rounded up according to the slack
+        uint8_t slot = 0;
+        Timer* next = nullptr;
+        Timer** previous = nullptr; // nullptr when the timer is not active
+      };
+
+      void Init();
+
+      // Starts (or restarts) the timer, the callback is called once after delay ticks,
+      // then every period ticks if period is not 0.
+      void Start(Timer& timer, TickType_t delay, TickType_t period = 0);
+      void Stop(Timer& timer);
+      bool IsActive(const Timer& timer) const;
+      TickType_t Remaining(const Timer& timer) const;
+
+      // Number of times the wheel woke up to process expired timers, and number of callbacks called
+      uint32_t Wakeups() const {
+        return wakeups;
+      }
+
+      uint32_t Expirations() const {
+        return expirations;
+      }
+
+      // The functions below implement the wheel, independently of FreeRTOS: the caller must make sure they are not
+      // called concurrently. The time is given in ticks, and must not go backward.
+      void Insert(Timer& timer, TickType_t now, TickType_t delay, TickType_t period);
+      void Remove(Timer& timer);
+      // Moves the timers that expire before or at now to the list of expired timers
+      void Advance(TickType_t now);
+      // Removes the first expired timer and restarts it if it is periodic
+      Timer* PopExpired();
+      // Returns false if no timer is active
+      bool NextDeadline(TickType_t& deadline) const;
+
+    private:
+      static constexpr uint8_t slotBits = 4;
+      static constexpr uint8_t nbSlots = 1 << slotBits;
+      static constexpr uint8_t nbLevels = 4;
+      static constexpr uint8_t overflowSlot = nbLevels * nbSlots;
+      static constexpr uint8_t expiredSlot = overflowSlot + 1;
+
+      static constexpr TickType_t Granularity(uint8_t level) {
+        return static_cast<TickType_t>(1) << (slotBits * level);
+      }
+
+      static TickType_t Coalesce(TickType_t expiry, TickType_t slack);
+
+      void Schedule(Timer& timer);
+      void Link(Timer& timer, uint8_t slot);
+      void Cascade(uint8_t slot);
+      void Reprogram();
+      void RetryReprogram();
+      BaseType_t SendCommand(bool active, TickType_t deadline, TickType_t blockTime);
+      static void Process(TimerHandle_t xTimer);
+
+      // Timers of the level l slot s are stored in slots[l * nbSlots + s],
+      // followed by the timers that expire after the range of the last level, and the expired timers.
+      Timer* slots[nbLevels * nbSlots + 2] = {};
+      uint16_t occupied[nbLevels] = {};
+      uint8_t nbActive = 0;
+      TickType_t current = 0;
+
+      // Time a task waits for room in the queue of the timer task when the command could not be queued at once
+      static constexpr TickType_t commandTimeout = pdMS_TO_TICKS(100);
+
+      TimerHandle_t timer;
+      // The FreeRTOS timer is running, and expires at programmedDeadline unless reprogramPending is set
+      bool programmed = false;
+      TickType_t programmedDeadline = 0;
+      bool reprogramPending = false;
+
+      uint32_t wakeups = 0;
+      uint32_t expirations = 0;
+    };
+  }
+}
@@ -47,10 +47,12 @@
 #include "displayapp/screens/settings/SettingSteps.h"
 #include "displayapp/screens/settings/SettingSetDateTime.h"
 #include "displayapp/screens/settings/SettingChimes.h"
+#include "displayapp/screens/settings/SettingHeartRate.h"
 #include "displayapp/screens/settings/SettingShakeThreshold.h"
 #include "displayapp/screens/settings/SettingBluetooth.h"
 
 #include "libs/lv_conf.h"
+#include "FreeRTOS/heap_arena.h"
 #include "UserApps.h"
 
 using namespace Pinetime::Applications;
@@ -61,8 +63,8 @@ namespace {
     return (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0;
   }
 
-  void TimerCallback(TimerHandle_t xTimer) {
-    auto* dispApp = static_cast<DisplayApp*>(pvTimerGetTimerID(xTimer));
+  void TimerCallback(void* context) {
+    auto* dispApp = static_cast<DisplayApp*>(context);
     dispApp->PushMessage(Display::Messages::TimerDone);
   }
 }
@@ -81,7 +83,8 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
                        Pinetime::Controllers::AlarmController& alarmController,
                        Pinetime::Controllers::BrightnessController& brightnessController,
                        Pinetime::Controllers::TouchHandler& touchHandler,
-                       Pinetime::Controllers::FS& filesystem)
+                       Pinetime::Controllers::FS& filesystem,
+                       Pinetime::Controllers::TimerWheel& timerWheel)
   : lcd {lcd},
     touchPanel {touchPanel},
     batteryController {batteryController},
@@ -97,8 +100,9 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
     brightnessController {brightnessController},
     touchHandler {touchHandler},
     filesystem {filesystem},
+    timerWheel {timerWheel},
     lvgl {lcd, filesystem},
-    timer(this, TimerCallback),
+    timer(timerWheel, this, TimerCallback),
     controllers {batteryController,
                  bleController,
                  dateTimeController,
@@ -181,14 +185,14 @@ void DisplayApp::Refresh() {
   };
 
   auto DimScreen = [this]() {
-    if (brightnessController.Level() != Controllers::BrightnessController::Levels::Off) {
+    if (state != States::AlwaysOn && brightnessController.Level() != Controllers::BrightnessController::Levels::Off) {
       isDimmed = true;
       brightnessController.Set(Controllers::BrightnessController::Levels::Low);
     }
   };
 
   auto RestoreBrightness = [this]() {
-    if (brightnessController.Level() != Controllers::BrightnessController::Levels::Off) {
+    if (state != States::AlwaysOn && brightnessController.Level() != Controllers::BrightnessController::Levels::Off) {
       isDimmed = false;
       lv_disp_trig_activity(nullptr);
       ApplyBrightness();
@@ -208,11 +212,15 @@ void DisplayApp::Refresh() {
     case States::Idle:
       queueTimeout = portMAX_DELAY;
       break;
+    case States::AlwaysOn:
+      queueTimeout = AlwaysOnRefreshTimeout();
+      break;
     case States::Running:
       if (!currentScreen->IsRunning()) {
         LoadPreviousScreen();
       }
       queueTimeout = lv_task_handler();
+      settingsController.FlushPending();
 
       if (!systemTask->IsSleepDisabled() && IsPastDimTime()) {
         if (!isDimmed) {
@@ -220,7 +228,7 @@ void DisplayApp::Refresh() {
         }
         if (IsPastSleepTime()) {
           systemTask->PushMessage(System::Messages::GoToSleep);
-          state = States::Idle;
+          SetState(States::Idle);
         }
       } else if (isDimmed) {
         RestoreBrightness();
@@ -241,19 +249,39 @@ void DisplayApp::Refresh() {
         RestoreBrightness();
         break;
       case Messages::GoToSleep:
+        // The flash sleeps with the system task
+        settingsController.Flush();
+        if (state == States::AlwaysOn) {
+          PushMessageToSystemTask(Pinetime::System::Messages::OnDisplayTaskSleeping);
+          break;
+        }
         while (brightnessController.Level() != Controllers::BrightnessController::Levels::Off) {
           brightnessController.Lower();
           vTaskDelay(100);
         }
-        lcd.Sleep();
+        if (settingsController.GetAlwaysOnDisplay()) {
+          EnterAlwaysOn();
+          SetState(States::AlwaysOn);
+        } else {
+          lcd.Sleep();
+          SetState(States::Idle);
+        }
         PushMessageToSystemTask(Pinetime::System::Messages::OnDisplayTaskSleeping);
-        state = States::Idle;
         break;
       case Messages::GoToRunning:
-        lcd.Wakeup();
+        if (state == States::AlwaysOn) {
+          ExitAlwaysOn();
+        } else {
+          lcd.Wakeup();
+        }
         lv_disp_trig_activity(nullptr);
+        // The display retained its frame memory during sleep: instead of repainting the whole screen,
+        // let the current screen update what changed while sleeping (ex: the time) and flush only these
+        // areas before switching the backlight on, so that the first visible frame is already up to date.
+        lv_task_handler();
+        lv_refr_now(nullptr);
         ApplyBrightness();
-        state = States::Running;
+        SetState(States::Running);
         break;
       case Messages::UpdateBleConnection:
         //        clockScreen.SetBleConnectionState(bleController.IsConnected() ? Screens::Clock::BleConnectionStates::Connected :
@@ -385,6 +413,8 @@ void DisplayApp::Refresh() {
         motorController.RunForDuration(15);
         break;
     }
+  } else if (state == States::AlwaysOn) {
+    RefreshAlwaysOn();
   }
 
   if (touchHandler.IsTouching()) {
@@ -418,9 +448,35 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
   lv_disp_trig_activity(nullptr);
   motorController.StopRinging();
 
-  currentScreen.reset(nullptr);
+  if (currentApp == Apps::Clock && app != Apps::Clock && KeepClockInBackground(app)) {
+    // Keep the watch face alive on its own LVGL screen and build the app on another one
+    // The watch face is always built on its own screen, the next app must not be built (and cleaned) on it
+    ASSERT(lv_scr_act() == clockLvScreen && clockLvScreen != appsLvScreen);
+    currentScreen->PauseRefresh();
+    backgroundClock = std::move(currentScreen);
+    if (appsLvScreen == nullptr) {
+      // Kept for the lifetime of the app, must not be allocated in the arena of a screen
+      vHeapArenaSuspend();
+      appsLvScreen = lv_obj_create(nullptr, nullptr);
+      vHeapArenaResume();
+    }
+    lv_scr_load(appsLvScreen);
+  } else {
+    currentScreen.reset(nullptr);
+  }
+  // All the allocations of the previous screen are released at once
+  vHeapArenaEnd();
+  if (app == Apps::Settings) {
+    // The watch face may be changed from the settings
+    UnloadBackgroundClock();
+  }
   SetFullRefresh(direction);
 
+  // The watch face can be kept in the background, it doesn't get an arena
+  if (app != Apps::Clock && xHeapArenaBegin(screenArenaSize) == 0) {
+    NRF_LOG_INFO("[DisplayApp] No arena for the screen");
+  }
+
   switch (app) {
     case Apps::Launcher: {
       std::array<Screens::Tile::Applications, UserAppTypes::Count> apps;
@@ -437,6 +493,22 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
                                                                  std::move(apps));
     } break;
     case Apps::Clock: {
+      const TickType_t loadStart = xTaskGetTickCount();
+      if (backgroundClock != nullptr) {
+        lv_scr_load(clockLvScreen);
+        currentScreen = std::move(backgroundClock);
+        currentScreen->ResumeRefresh();
+        clockLoadDuration = xTaskGetTickCount() - loadStart;
+        settingsController.SetAppMenu(0);
+        break;
+      }
+      if (clockLvScreen == nullptr) {
+        // The screen the first watch face is built on, appsLvScreen is only created once it exists
+        clockLvScreen = lv_scr_act();
+      }
+      // The previous app may have been built on appsLvScreen
+      lv_scr_load(clockLvScreen);
+      const size_t freeHeapBefore = xPortGetFreeHeapSize();
       const auto* watchFace =
         std::find_if(userWatchFaces.begin(), userWatchFaces.end(), [this](const WatchFaceDescription& watchfaceDescription) {
           return watchfaceDescription.watchFace == settingsController.GetWatchFace();
@@ -446,6 +518,9 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
       else {
         currentScreen.reset(userWatchFaces[0].create(controllers));
       }
+      clockMemoryUsage = freeHeapBefore - xPortGetFreeHeapSize();
+      clockLoadDuration = xTaskGetTickCount() - loadStart;
+      NRF_LOG_INFO("[DisplayApp] Watch face : %d B, %d ticks", clockMemoryUsage, clockLoadDuration);
       settingsController.SetAppMenu(0);
     } break;
     case Apps::Error:
@@ -465,6 +540,7 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
 
     case Apps::Notifications:
       currentScreen = std::make_unique<Screens::Notifications>(this,
+                                                               lvgl,
                                                                notificationManager,
                                                                systemTask->nimble().alertService(),
                                                                motorController,
@@ -473,6 +549,7 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
       break;
     case Apps::NotificationsPreview:
       currentScreen = std::make_unique<Screens::Notifications>(this,
+                                                               lvgl,
                                                                notificationManager,
                                                                systemTask->nimble().alertService(),
                                                                motorController,
@@ -521,6 +598,9 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
     case Apps::SettingChimes:
       currentScreen = std::make_unique<Screens::SettingChimes>(settingsController);
       break;
+    case Apps::SettingHeartRate:
+      currentScreen = std::make_unique<Screens::SettingHeartRate>(settingsController, heartRateController);
+      break;
     case Apps::SettingShakeThreshold:
       currentScreen = std::make_unique<Screens::SettingShakeThreshold>(settingsController, motionController, *systemTask);
       break;
@@ -538,7 +618,9 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
                                                             bleController,
                                                             watchdog,
                                                             motionController,
-                                                            touchPanel);
+                                                            touchPanel,
+                                                            systemTask->Monitor(),
+                                                            timerWheel);
       break;
     case Apps::FlashLight:
       currentScreen = std::make_unique<Screens::FlashLight>(*systemTask, brightnessController);
@@ -558,6 +640,21 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
   currentApp = app;
 }
 
+bool DisplayApp::KeepClockInBackground(Apps app) const {
+  return app != Apps::Settings && xPortGetFreeHeapSize() >= minFreeHeapForBackgroundClock;
+}
+
+void DisplayApp::UnloadBackgroundClock() {
+  if (backgroundClock == nullptr) {
+    return;
+  }
+  // Watch faces clean the active screen when they are destroyed
+  lv_obj_t* activeScreen = lv_scr_act();
+  lv_scr_load(clockLvScreen);
+  backgroundClock.reset(nullptr);
+  lv_scr_load(activeScreen);
+}
+
 void DisplayApp::PushMessage(Messages msg) {
   if (in_isr()) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
@@ -624,6 +721,65 @@ void DisplayApp::Register(Pinetime::Controllers::NavigationService* NavigationSe
   this->controllers.navigationService = NavigationService;
 }
 
+void DisplayApp::SetState(States newState) {
+  state = newState;
+  stateResidency.Enter(newState, xTaskGetTickCount());
+}
+
+void DisplayApp::EnterAlwaysOn() {
+  // Lines of the frame memory must match lines of the screen to set the partial area
+  lvgl.ResetScroll();
+
+  // Minimal watch face drawn on top of the current screen, which is kept as is for when the watch wakes up
+  alwaysOnBackground = lv_obj_create(lv_layer_top(), nullptr);
+  lv_obj_set_size(alwaysOnBackground, LV_HOR_RES, LV_VER_RES);
+  lv_obj_set_style_local_bg_color(alwaysOnBackground, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLACK);
+  lv_obj_set_style_local_radius(alwaysOnBackground, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_style_local_border_width(alwaysOnBackground, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, 0);
+
+  alwaysOnTime = lv_label_create(alwaysOnBackground, nullptr);
+  lv_obj_set_style_local_text_font(alwaysOnTime, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &jetbrains_mono_76);
+  lv_obj_set_style_local_text_color(alwaysOnTime, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_WHITE);
+  alwaysOnMinutes = Utility::DirtyValue<uint8_t> {};
+  RefreshAlwaysOn();
+  lv_refr_now(nullptr);
+
+  lvgl.WaitFlushDone();
+  const lv_coord_t firstLine = lv_obj_get_y(alwaysOnTime);
+  lcd.LowPowerOn(firstLine, firstLine + lv_obj_get_height(alwaysOnTime) - 1);
+  brightnessController.Set(Controllers::BrightnessController::Levels::Low);
+}
+
+void DisplayApp::ExitAlwaysOn() {
+  brightnessController.Set(Controllers::BrightnessController::Levels::Off);
+  lvgl.WaitFlushDone();
+  lcd.LowPowerOff();
+  // Invalidates the whole screen, the current screen is redrawn before the brightness is restored
+  lv_obj_del(alwaysOnBackground);
+  alwaysOnBackground = nullptr;
+  alwaysOnTime = nullptr;
+}
+
+void DisplayApp::RefreshAlwaysOn() {
+  alwaysOnMinutes = dateTimeController.Minutes();
+  if (!alwaysOnMinutes.IsUpdated()) {
+    return;
+  }
+  uint8_t hours = dateTimeController.Hours();
+  if (settingsController.GetClockType() == Controllers::Settings::ClockType::H12) {
+    hours = (hours % 12 == 0) ? 12 : hours % 12;
+  }
+  lv_label_set_text_fmt(alwaysOnTime, "%02d:%02d", hours, alwaysOnMinutes.Get());
+  lv_obj_align(alwaysOnTime, nullptr, LV_ALIGN_CENTER, 0, 0);
+  // Only the lines of the label are redrawn and sent to the display
+  lv_refr_now(nullptr);
+}
+
+TickType_t DisplayApp::AlwaysOnRefreshTimeout() const {
+  // Wake up right after the next minute (the time is updated every 100ms by the system task)
+  return pdMS_TO_TICKS((60 - dateTimeController.Seconds()) * 1000 + 200);
+}
+
 void DisplayApp::ApplyBrightness() {
   auto brightness = settingsController.GetBrightness();
   if (brightness != Controllers::BrightnessController::Levels::Low && brightness != Controllers::BrightnessController::Levels::Medium &&
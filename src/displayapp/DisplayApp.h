@@ -20,6 +20,8 @@
 #include "BootErrors.h"
 
 #include "utility/StaticStack.h"
+#include "utility/StateResidency.h"
+#include "utility/DirtyValue.h"
 #include "displayapp/Controllers.h"
 
 namespace Pinetime {
@@ -49,7 +51,8 @@ namespace Pinetime {
   namespace Applications {
     class DisplayApp {
     public:
-      enum class States { Idle, Running };
+      enum class States { Idle, Running, AlwaysOn };
+      static constexpr size_t nbStates = 3;
       enum class FullRefreshDirections { None, Up, Down, Left, Right, LeftAnim, RightAnim };
 
       DisplayApp(Drivers::St7789& lcd,
@@ -66,7 +69,8 @@ namespace Pinetime {
                  Pinetime::Controllers::AlarmController& alarmController,
                  Pinetime::Controllers::BrightnessController& brightnessController,
                  Pinetime::Controllers::TouchHandler& touchHandler,
-                 Pinetime::Controllers::FS& filesystem);
+                 Pinetime::Controllers::FS& filesystem,
+                 Pinetime::Controllers::TimerWheel& timerWheel);
       void Start(System::BootErrors error);
       void PushMessage(Display::Messages msg);
 
@@ -79,6 +83,20 @@ namespace Pinetime {
       void Register(Pinetime::Controllers::MusicService* musicService);
       void Register(Pinetime::Controllers::NavigationService* NavigationService);
 
+      // Time spent in each state, in ticks
+      const Utility::StateResidency<States, nbStates>& StateResidency() const {
+        return stateResidency;
+      }
+
+      // Heap used by the watch face, and time (in ticks) it took to display it the last time
+      size_t ClockMemoryUsage() const {
+        return clockMemoryUsage;
+      }
+
+      TickType_t ClockLoadDuration() const {
+        return clockLoadDuration;
+      }
+
     private:
       Pinetime::Drivers::St7789& lcd;
       const Pinetime::Drivers::Cst816S& touchPanel;
@@ -96,6 +114,7 @@ namespace Pinetime {
       Pinetime::Controllers::BrightnessController& brightnessController;
       Pinetime::Controllers::TouchHandler& touchHandler;
       Pinetime::Controllers::FS& filesystem;
+      Pinetime::Controllers::TimerWheel& timerWheel;
 
       Pinetime::Controllers::FirmwareValidator validator;
       Pinetime::Components::LittleVgl lvgl;
@@ -105,6 +124,7 @@ namespace Pinetime {
       TaskHandle_t taskHandle;
 
       States state = States::Running;
+      Utility::StateResidency<States, nbStates> stateResidency {States::Running};
       QueueHandle_t msgQueue;
 
       static constexpr uint8_t queueSize = 10;
@@ -112,6 +132,20 @@ namespace Pinetime {
 
       std::unique_ptr<Screens::Screen> currentScreen;
 
+      // The watch face stays loaded, with its refresh paused, on its own LVGL screen while apps are displayed
+      // so that going back to it is only a screen switch
+      static constexpr size_t minFreeHeapForBackgroundClock = 8 * 1024;
+      std::unique_ptr<Screens::Screen> backgroundClock;
+      lv_obj_t* clockLvScreen = nullptr;
+      lv_obj_t* appsLvScreen = nullptr;
+      size_t clockMemoryUsage = 0;
+      TickType_t clockLoadDuration = 0;
+      bool KeepClockInBackground(Apps app) const;
+      void UnloadBackgroundClock();
+
+      // Size of the arena the allocations of each app screen are carved from
+      static constexpr size_t screenArenaSize = 4096;
+
       Apps currentApp = Apps::None;
       Apps returnToApp = Apps::None;
       FullRefreshDirections returnDirection = FullRefreshDirections::None;
@@ -129,6 +163,15 @@ namespace Pinetime {
       DisplayApp::FullRefreshDirections nextDirection;
       System::BootErrors bootError;
       void ApplyBrightness();
+      void SetState(States newState);
+
+      void EnterAlwaysOn();
+      void ExitAlwaysOn();
+      void RefreshAlwaysOn();
+      TickType_t AlwaysOnRefreshTimeout() const;
+      lv_obj_t* alwaysOnBackground = nullptr;
+      lv_obj_t* alwaysOnTime = nullptr;
+      Utility::DirtyValue<uint8_t> alwaysOnMinutes {};
 
       static constexpr size_t returnAppStackSize = 10;
       Utility::StaticStack<Apps, returnAppStackSize> returnAppStack;
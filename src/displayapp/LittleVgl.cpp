@@ -6,6 +6,7 @@
 #include "drivers/St7789.h"
 #include "littlefs/lfs.h"
 #include "components/fs/FS.h"
+#include "logging/Trace.h"
 
 using namespace Pinetime::Components;
 
@@ -77,6 +78,9 @@ LittleVgl::LittleVgl(Pinetime::Drivers::St7789& lcd, Pinetime::Controllers::FS&
 }
 
 void LittleVgl::Init() {
+#ifdef DRIVER_DISPLAY_12BIT
+  lcd.SetColorMode(Pinetime::Drivers::St7789::ColorModes::Rgb444);
+#endif
   lv_init();
   InitTheme();
   InitDisplay();
@@ -132,6 +136,8 @@ void LittleVgl::InitFileSystem() {
 }
 
 void LittleVgl::SetFullRefresh(FullRefreshDirections direction) {
+  // The whole screen is redrawn, the rows of a pending vertical scroll with it
+  pendingScrollLines = 0;
   if (scrollDirection == FullRefreshDirections::None) {
     scrollDirection = direction;
     if (scrollDirection == FullRefreshDirections::Down) {
@@ -151,11 +157,20 @@ void LittleVgl::SetFullRefresh(FullRefreshDirections direction) {
 
 void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
   uint16_t y1, y2, width, height = 0;
+  TRACE_EVENT(DisplayFlushStart, area->y1, area->y2);
 
   ulTaskNotifyTake(pdTRUE, 200);
   // Notification is still needed (even if there is a mutex on SPI) because of the DataCommand pin
   // which cannot be set/clear during a transfer.
 
+  if (pendingScrollLines != 0 && flushScrollLines == 0) {
+    // First flush since the vertical scroll: all the areas of this refresh are written with the new offset, and
+    // the scroll start address is updated once the last one is flushed
+    writeOffset = (writeOffset + totalNbLines + pendingScrollLines) % totalNbLines;
+    flushScrollLines = pendingScrollLines;
+    pendingScrollLines = 0;
+  }
+
   if ((scrollDirection == LittleVgl::FullRefreshDirections::Down) && (area->y2 == visibleNbLines - 1)) {
     writeOffset = ((writeOffset + totalNbLines) - visibleNbLines) % totalNbLines;
   } else if ((scrollDirection == FullRefreshDirections::Up) && (area->y1 == 0)) {
@@ -218,23 +233,77 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
     height = totalNbLines - y1;
 
     if (height > 0) {
-      lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+      DrawBuffer(area->x1, y1, width, height, color_p);
       ulTaskNotifyTake(pdTRUE, 100);
     }
 
     uint16_t pixOffset = width * height;
     height = y2 + 1;
-    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2);
+    DrawBuffer(area->x1, 0, width, height, color_p + pixOffset);
 
   } else {
-    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+    DrawBuffer(area->x1, y1, width, height, color_p);
   }
 
+  if (flushScrollLines != 0 && lv_disp_flush_is_last(&disp_drv)) {
+    // The exposed rows have been written outside of the visible window, bring them into view
+    // once the transfer is done (the D/C pin cannot be changed during a transfer).
+    ulTaskNotifyTake(pdTRUE, 100);
+    scrollOffset = (scrollOffset + totalNbLines + flushScrollLines) % totalNbLines;
+    lcd.VerticalScrollStartAddress(scrollOffset);
+    flushScrollLines = 0;
+    // Commands are sent synchronously and do not notify the task: unlock the next flush
+    xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+  }
+
+  TRACE_EVENT(DisplayFlushEnd, area->y1, area->y2);
+
   // IMPORTANT!!!
   // Inform the graphics library that you are ready with the flushing
   lv_disp_flush_ready(&disp_drv);
 }
 
+void LittleVgl::DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const lv_color_t* data) {
+  const size_t nbPixels = width * height;
+#ifdef DRIVER_DISPLAY_12BIT
+  // Only called once the previous transfer is done, the packed buffer can be reused
+  const size_t size = Utility::PackRgb444(reinterpret_cast<const uint8_t*>(data), nbPixels, packedBuffer);
+  lcd.DrawBuffer(x, y, width, height, packedBuffer, size);
+#else
+  lcd.DrawBuffer(x, y, width, height, reinterpret_cast<const uint8_t*>(data), nbPixels * 2);
+#endif
+}
+
+bool LittleVgl::ScrollVertical(int16_t lines) {
+  static constexpr int16_t maxScrollLines = totalNbLines - visibleNbLines;
+  if (lines == 0 || lines > maxScrollLines || lines < -maxScrollLines) {
+    return false;
+  }
+  if (scrollDirection != FullRefreshDirections::None || fullRefresh || pendingScrollLines != 0 || flushScrollLines != 0) {
+    return false;
+  }
+
+  // Applied by the next refresh: the exposed rows are drawn in the part of the frame memory that is not visible
+  // yet, then the scroll start address brings them into view.
+  pendingScrollLines = lines;
+  return true;
+}
+
+void LittleVgl::WaitFlushDone() {
+  ulTaskNotifyTake(pdTRUE, 200);
+  // Give the notification back for the next flush
+  xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+}
+
+void LittleVgl::ResetScroll() {
+  WaitFlushDone();
+  writeOffset = 0;
+  scrollOffset = 0;
+  pendingScrollLines = 0;
+  flushScrollLines = 0;
+  lcd.VerticalScrollStartAddress(scrollOffset);
+}
+
 void LittleVgl::SetNewTouchPoint(int16_t x, int16_t y, bool contact) {
   if (contact) {
     if (!isCancelled) {
@@ -2,6 +2,9 @@
 
 #include <lvgl/lvgl.h>
 #include <components/fs/FS.h>
+#ifdef DRIVER_DISPLAY_12BIT
+  #include "utility/ColorPacking.h"
+#endif
 
 namespace Pinetime {
   namespace Drivers {
@@ -27,6 +30,17 @@ namespace Pinetime {
       void SetNewTouchPoint(int16_t x, int16_t y, bool contact);
       void CancelTap();
 
+      /** Shift the visible content by 'lines' rows (positive moves it up) using the display's vertical scroll
+       * register instead of redrawing it. The shift is applied by the next refresh, the caller must invalidate the
+       * rows exposed by it.
+       * @return false if the shift cannot be done in hardware right now */
+      bool ScrollVertical(int16_t lines);
+
+      // Blocks until the last flush has been sent, so that commands can be sent to the display
+      void WaitFlushDone();
+      // Cancels any vertical scrolling so that lines of the frame memory match lines of the screen
+      void ResetScroll();
+
       bool GetFullRefresh() {
         bool returnValue = fullRefresh;
         if (fullRefresh) {
@@ -39,6 +53,7 @@ namespace Pinetime {
       void InitDisplay();
       void InitTouchpad();
       void InitFileSystem();
+      void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const lv_color_t* data);
 
       Pinetime::Drivers::St7789& lcd;
       Pinetime::Controllers::FS& filesystem;
@@ -46,6 +61,9 @@ namespace Pinetime {
       lv_disp_buf_t disp_buf_2;
       lv_color_t buf2_1[LV_HOR_RES_MAX * 4];
       lv_color_t buf2_2[LV_HOR_RES_MAX * 4];
+#ifdef DRIVER_DISPLAY_12BIT
+      uint8_t packedBuffer[Utility::Rgb444Size(LV_HOR_RES_MAX * 4)];
+#endif
 
       lv_disp_drv_t disp_drv;
 
@@ -61,6 +79,9 @@ namespace Pinetime {
       FullRefreshDirections scrollDirection = FullRefreshDirections::None;
       uint16_t writeOffset = 0;
       uint16_t scrollOffset = 0;
+      // Vertical scroll requested, and being flushed by the current refresh
+      int16_t pendingScrollLines = 0;
+      int16_t flushScrollLines = 0;
 
       lv_point_t touchPoint = {};
       bool tapped = false;
@@ -152,12 +152,12 @@ Music::~Music() {
 void Music::Refresh() {
   if (artist != musicService.getArtist()) {
     artist = musicService.getArtist();
-    lv_label_set_text(txtArtist, artist.data());
+    lv_label_set_text(txtArtist, artist.Data());
   }
 
   if (track != musicService.getTrack()) {
     track = musicService.getTrack();
-    lv_label_set_text(txtTrack, track.data());
+    lv_label_set_text(txtTrack, track.Data());
   }
 
   if (album != musicService.getAlbum()) {
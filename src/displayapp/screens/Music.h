@@ -19,17 +19,13 @@
 
 #include <FreeRTOS.h>
 #include <lvgl/src/lv_core/lv_obj.h>
-#include <string>
 #include "displayapp/screens/Screen.h"
+#include "components/ble/MusicService.h"
 #include "displayapp/apps/Apps.h"
 #include "displayapp/Controllers.h"
 #include "Symbols.h"
 
 namespace Pinetime {
-  namespace Controllers {
-    class MusicService;
-  }
-
   namespace Applications {
     namespace Screens {
       class Music : public Screen {
@@ -67,9 +63,9 @@ namespace Pinetime {
 
         Pinetime::Controllers::MusicService& musicService;
 
-        std::string artist;
-        std::string album;
-        std::string track;
+        Controllers::MusicService::Text artist;
+        Controllers::MusicService::Text album;
+        Controllers::MusicService::Text track;
 
         /** Total length in seconds */
         int totalLength = 0;
@@ -176,7 +176,7 @@ namespace {
     return {iconsFile1, static_cast<int16_t>(iconHeight * (index - maxIconsPerFile))};
   }
 
-  Icon GetIcon(const std::string& icon) {
+  Icon GetIcon(std::string_view icon) {
     for (const auto& iter : iconMap) {
       if (iter.first == icon) {
         return GetIcon(iter.second);
@@ -249,12 +249,12 @@ void Navigation::Refresh() {
 
   if (narrative != navService.getNarrative()) {
     narrative = navService.getNarrative();
-    lv_label_set_text(txtNarrative, narrative.data());
+    lv_label_set_text(txtNarrative, narrative.Data());
   }
 
   if (manDist != navService.getManDist()) {
     manDist = navService.getManDist();
-    lv_label_set_text(txtManDist, manDist.data());
+    lv_label_set_text(txtManDist, manDist.Data());
   }
 
   if (progress != navService.getProgress()) {
@@ -269,17 +269,5 @@ void Navigation::Refresh() {
 }
 
 bool Navigation::IsAvailable(Pinetime::Controllers::FS& filesystem) {
-  lfs_file file = {};
-
-  if (filesystem.FileOpen(&file, "/images/navigation0.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-  filesystem.FileClose(&file);
-
-  if (filesystem.FileOpen(&file, "/images/navigation1.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-  filesystem.FileClose(&file);
-
-  return true;
+  return filesystem.IsResourceAvailable("/images/navigation0.bin") && filesystem.IsResourceAvailable("/images/navigation1.bin");
 }
@@ -19,16 +19,15 @@
 
 #include <FreeRTOS.h>
 #include <lvgl/src/lv_core/lv_obj.h>
-#include <string>
 #include "displayapp/screens/Screen.h"
 #include <array>
+#include "components/ble/NavigationService.h"
 #include "displayapp/apps/Apps.h"
 #include "displayapp/Controllers.h"
 #include "Symbols.h"
 
 namespace Pinetime {
   namespace Controllers {
-    class NavigationService;
     class FS;
   }
 
@@ -50,9 +49,9 @@ namespace Pinetime {
 
         Pinetime::Controllers::NavigationService& navService;
 
-        std::string flag;
-        std::string narrative;
-        std::string manDist;
+        Controllers::NavigationService::Flag flag;
+        Controllers::NavigationService::Narrative narrative;
+        Controllers::NavigationService::ManDist manDist;
         int progress = 0;
 
         lv_task_t* taskRefresh;
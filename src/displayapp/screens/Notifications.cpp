@@ -11,12 +11,14 @@ extern lv_font_t jetbrains_mono_extrabold_compressed;
 extern lv_font_t jetbrains_mono_bold_20;
 
 Notifications::Notifications(DisplayApp* app,
+                             Pinetime::Components::LittleVgl& lvgl,
                              Pinetime::Controllers::NotificationManager& notificationManager,
                              Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                              Pinetime::Controllers::MotorController& motorController,
                              System::SystemTask& systemTask,
                              Modes mode)
   : app {app},
+    lvgl {lvgl},
     notificationManager {notificationManager},
     alertNotificationService {alertNotificationService},
     motorController {motorController},
@@ -27,7 +29,8 @@ Notifications::Notifications(DisplayApp* app,
   auto notification = notificationManager.GetLastNotification();
   if (notification.valid) {
     currentId = notification.id;
-    currentItem = std::make_unique<NotificationItem>(notification.Title(),
+    currentItem = std::make_unique<NotificationItem>(lvgl,
+                                                     notification.Title(),
                                                      notification.Message(),
                                                      1,
                                                      notification.category,
@@ -36,7 +39,7 @@ Notifications::Notifications(DisplayApp* app,
                                                      motorController);
     validDisplay = true;
   } else {
-    currentItem = std::make_unique<NotificationItem>(alertNotificationService, motorController);
+    currentItem = std::make_unique<NotificationItem>(lvgl, alertNotificationService, motorController);
     validDisplay = false;
   }
   if (mode == Modes::Preview) {
@@ -82,7 +85,7 @@ void Notifications::Refresh() {
 
   } else if (mode == Modes::Preview && dismissingNotification) {
     running = false;
-    currentItem = std::make_unique<NotificationItem>(alertNotificationService, motorController);
+    currentItem = std::make_unique<NotificationItem>(lvgl, alertNotificationService, motorController);
 
   } else if (dismissingNotification) {
     dismissingNotification = false;
@@ -105,7 +108,8 @@ void Notifications::Refresh() {
 
     if (validDisplay) {
       Controllers::NotificationManager::Notification::Idx currentIdx = notificationManager.IndexOf(currentId);
-      currentItem = std::make_unique<NotificationItem>(notification.Title(),
+      currentItem = std::make_unique<NotificationItem>(lvgl,
+                                                       notification.Title(),
                                                        notification.Message(),
                                                        currentIdx + 1,
                                                        notification.category,
@@ -113,7 +117,7 @@ void Notifications::Refresh() {
                                                        alertNotificationService,
                                                        motorController);
     } else {
-      currentItem = std::make_unique<NotificationItem>(alertNotificationService, motorController);
+      currentItem = std::make_unique<NotificationItem>(lvgl, alertNotificationService, motorController);
     }
   }
 
@@ -149,6 +153,11 @@ void Notifications::OnPreviewDismiss() {
 }
 
 bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
+  // The swipe that ends the scrolling of a long notification does not change the notification
+  if (currentItem->OnRelease() && (event == TouchEvents::SwipeUp || event == TouchEvents::SwipeDown)) {
+    return true;
+  }
+
   if (mode != Modes::Normal) {
     if (!interacted && event == TouchEvents::Tap) {
       interacted = true;
@@ -196,7 +205,8 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Down);
-      currentItem = std::make_unique<NotificationItem>(previousNotification.Title(),
+      currentItem = std::make_unique<NotificationItem>(lvgl,
+                                                       previousNotification.Title(),
                                                        previousNotification.Message(),
                                                        currentIdx + 1,
                                                        previousNotification.category,
@@ -223,7 +233,8 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Up);
-      currentItem = std::make_unique<NotificationItem>(nextNotification.Title(),
+      currentItem = std::make_unique<NotificationItem>(lvgl,
+                                                       nextNotification.Title(),
                                                        nextNotification.Message(),
                                                        currentIdx + 1,
                                                        nextNotification.category,
@@ -237,6 +248,16 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
   }
 }
 
+bool Notifications::OnTouchEvent(uint16_t /*x*/, uint16_t y) {
+  if (mode != Modes::Normal && !interacted) {
+    // The timeout line is not part of the scrolled content
+    interacted = true;
+    OnPreviewInteraction();
+  }
+  currentItem->OnTouch(y);
+  return true;
+}
+
 namespace {
   void CallEventHandler(lv_obj_t* obj, lv_event_t event) {
     auto* item = static_cast<Notifications::NotificationItem*>(obj->user_data);
@@ -244,9 +265,11 @@ namespace {
   }
 }
 
-Notifications::NotificationItem::NotificationItem(Pinetime::Controllers::AlertNotificationService& alertNotificationService,
+Notifications::NotificationItem::NotificationItem(Pinetime::Components::LittleVgl& lvgl,
+                                                  Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                                                   Pinetime::Controllers::MotorController& motorController)
-  : NotificationItem("Notification",
+  : NotificationItem(lvgl,
+                     "Notification",
                      "No notification to display",
                      0,
                      Controllers::NotificationManager::Categories::Unknown,
@@ -255,15 +278,17 @@ Notifications::NotificationItem::NotificationItem(Pinetime::Controllers::AlertNo
                      motorController) {
 }
 
-Notifications::NotificationItem::NotificationItem(const char* title,
+Notifications::NotificationItem::NotificationItem(Pinetime::Components::LittleVgl& lvgl,
+                                                  const char* title,
                                                   const char* msg,
                                                   uint8_t notifNr,
                                                   Controllers::NotificationManager::Categories category,
                                                   uint8_t notifNb,
                                                   Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                                                   Pinetime::Controllers::MotorController& motorController)
-  : alertNotificationService {alertNotificationService}, motorController {motorController} {
-  container = lv_cont_create(lv_scr_act(), nullptr);
+  : scrollView {lvgl}, alertNotificationService {alertNotificationService}, motorController {motorController} {
+  scrollView.Create(lv_scr_act());
+  container = lv_cont_create(scrollView.GetContent(), nullptr);
   lv_obj_set_size(container, LV_HOR_RES, LV_VER_RES);
   lv_obj_set_style_local_bg_color(container, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLACK);
   lv_obj_set_style_local_pad_all(container, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
@@ -308,9 +333,14 @@ Notifications::NotificationItem::NotificationItem(const char* title,
   lv_obj_set_width(alert_subject, LV_HOR_RES - 20);
 
   switch (category) {
-    default:
+    default: {
       lv_label_set_text(alert_subject, msg);
-      break;
+      const lv_coord_t height = lv_obj_get_height(alert_subject) + 2 * 10;
+      if (height > LV_VER_RES - 50) {
+        lv_obj_set_height(subject_container, height);
+        lv_obj_set_height(container, 50 + height);
+      }
+    } break;
     case Controllers::NotificationManager::Categories::IncomingCall: {
       lv_obj_set_height(subject_container, 108);
       lv_label_set_text_static(alert_subject, "Incoming call from");
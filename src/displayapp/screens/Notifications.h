@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <memory>
 #include "displayapp/screens/Screen.h"
+#include "displayapp/widgets/ScrollView.h"
 #include "components/ble/NotificationManager.h"
 #include "components/motor/MotorController.h"
 #include "systemtask/SystemTask.h"
@@ -21,6 +22,7 @@ namespace Pinetime {
       public:
         enum class Modes { Normal, Preview };
         explicit Notifications(DisplayApp* app,
+                               Pinetime::Components::LittleVgl& lvgl,
                                Pinetime::Controllers::NotificationManager& notificationManager,
                                Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                                Pinetime::Controllers::MotorController& motorController,
@@ -30,15 +32,18 @@ namespace Pinetime {
 
         void Refresh() override;
         bool OnTouchEvent(Pinetime::Applications::TouchEvents event) override;
+        bool OnTouchEvent(uint16_t x, uint16_t y) override;
         void DismissToBlack();
         void OnPreviewInteraction();
         void OnPreviewDismiss();
 
         class NotificationItem {
         public:
-          NotificationItem(Pinetime::Controllers::AlertNotificationService& alertNotificationService,
+          NotificationItem(Pinetime::Components::LittleVgl& lvgl,
+                           Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                            Pinetime::Controllers::MotorController& motorController);
-          NotificationItem(const char* title,
+          NotificationItem(Pinetime::Components::LittleVgl& lvgl,
+                           const char* title,
                            const char* msg,
                            uint8_t notifNr,
                            Controllers::NotificationManager::Categories,
@@ -53,7 +58,17 @@ namespace Pinetime {
 
           void OnCallButtonEvent(lv_obj_t*, lv_event_t event);
 
+          void OnTouch(uint16_t y) {
+            scrollView.OnTouch(y);
+          }
+
+          bool OnRelease() {
+            return scrollView.OnRelease();
+          }
+
         private:
+          // Long messages extend the notification below the screen, it is scrolled by dragging it
+          Widgets::ScrollView scrollView;
           lv_obj_t* container;
           lv_obj_t* subject_container;
           lv_obj_t* bt_accept;
@@ -70,6 +85,7 @@ namespace Pinetime {
 
       private:
         DisplayApp* app;
+        Pinetime::Components::LittleVgl& lvgl;
         Pinetime::Controllers::NotificationManager& notificationManager;
         Pinetime::Controllers::AlertNotificationService& alertNotificationService;
         Pinetime::Controllers::MotorController& motorController;
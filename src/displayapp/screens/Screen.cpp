@@ -4,3 +4,30 @@ using namespace Pinetime::Applications::Screens;
 void Screen::RefreshTaskCallback(lv_task_t* task) {
   static_cast<Screen*>(task->user_data)->Refresh();
 }
+
+void Screen::PauseRefresh() {
+  SetRefreshTasksPriority(LV_TASK_PRIO_OFF, false);
+}
+
+void Screen::ResumeRefresh() {
+  SetRefreshTasksPriority(LV_TASK_PRIO_MID, true);
+}
+
+void Screen::SetRefreshTasksPriority(lv_task_prio_t priority, bool ready) {
+  // Changing the priority reorders the list of tasks: find them all before updating them
+  static constexpr uint8_t maxTasks = 4;
+  lv_task_t* tasks[maxTasks];
+  uint8_t nbTasks = 0;
+  for (lv_task_t* task = lv_task_get_next(nullptr); task != nullptr && nbTasks < maxTasks; task = lv_task_get_next(task)) {
+    if (task->task_cb == RefreshTaskCallback && task->user_data == this) {
+      tasks[nbTasks++] = task;
+    }
+  }
+
+  for (uint8_t i = 0; i < nbTasks; i++) {
+    lv_task_set_prio(tasks[i], priority);
+    if (ready) {
+      lv_task_ready(tasks[i]);
+    }
+  }
+}
@@ -40,8 +40,15 @@ namespace Pinetime {
           return false;
         }
 
+        /** Stops/restarts the refresh tasks of the screen while it is kept loaded in the background */
+        void PauseRefresh();
+        void ResumeRefresh();
+
       protected:
         bool running = true;
+
+      private:
+        void SetRefreshTasksPriority(lv_task_prio_t priority, bool ready);
       };
     }
   }
@@ -2,6 +2,7 @@
 #include <lvgl/lvgl.h>
 #include "displayapp/DisplayApp.h"
 #include "displayapp/InfiniTimeTheme.h"
+#include <algorithm>
 
 using namespace Pinetime::Applications::Screens;
 
@@ -87,6 +88,81 @@ void Steps::Refresh() {
   lv_arc_set_value(stepsArc, int16_t(500 * stepsCount / settingsController.GetStepsGoal()));
 }
 
+bool Steps::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
+  switch (event) {
+    case TouchEvents::SwipeUp:
+      if (weekView == nullptr || lv_obj_get_hidden(weekView)) {
+        ShowWeek();
+        return true;
+      }
+      return false;
+    case TouchEvents::SwipeDown:
+      if (weekView != nullptr && !lv_obj_get_hidden(weekView)) {
+        lv_obj_set_hidden(weekView, true);
+        return true;
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
+void Steps::ShowWeek() {
+  if (weekView == nullptr) {
+    weekView = lv_obj_create(lv_scr_act(), nullptr);
+    lv_obj_set_size(weekView, LV_HOR_RES, LV_VER_RES);
+    lv_obj_set_style_local_bg_color(weekView, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLACK);
+    lv_obj_set_style_local_border_width(weekView, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, 0);
+    lv_obj_set_style_local_radius(weekView, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, 0);
+
+    weekLabel = lv_label_create(weekView, nullptr);
+    lv_obj_set_style_local_text_color(weekLabel, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, Colors::lightGray);
+
+    weekChart = lv_chart_create(weekView, nullptr);
+    lv_obj_set_size(weekChart, 220, 180);
+    lv_obj_align(weekChart, nullptr, LV_ALIGN_IN_BOTTOM_MID, 0, -5);
+    lv_chart_set_type(weekChart, LV_CHART_TYPE_COLUMN);
+    lv_chart_set_point_count(weekChart, nbWeekDays);
+    lv_chart_set_div_line_count(weekChart, 0, 0);
+    lv_obj_set_style_local_bg_opa(weekChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+    lv_obj_set_style_local_border_width(weekChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, 0);
+    lv_obj_set_style_local_pad_bottom(weekChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, 20);
+    lv_obj_set_style_local_text_color(weekChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, Colors::lightGray);
+    weekSeries = lv_chart_add_series(weekChart, Colors::blue);
+  }
+
+  auto& history = motionController.History();
+  const uint16_t today = history.CurrentDay();
+  const uint16_t firstDay = (today >= nbWeekDays - 1) ? today - (nbWeekDays - 1) : 0;
+  history.Read(firstDay, weekDays.data(), nbWeekDays);
+
+  static constexpr char initials[] = "SMTWTFS";
+  uint32_t total = 0;
+  uint32_t maxSteps = settingsController.GetStepsGoal();
+  for (uint8_t i = 0; i < nbWeekDays; i++) {
+    // The epoch was a Thursday
+    weekTicks[i * 2] = initials[(weekDays[i].day + 4) % 7];
+    weekTicks[i * 2 + 1] = '\n';
+    total += weekDays[i].total;
+    maxSteps = std::max(maxSteps, weekDays[i].total);
+  }
+  weekTicks[nbWeekDays * 2 - 1] = '\0';
+
+  // The range of the chart is limited to 16 bits
+  const uint32_t scale = maxSteps / 10000 + 1;
+  lv_chart_set_range(weekChart, 0, maxSteps / scale);
+  for (uint8_t i = 0; i < nbWeekDays; i++) {
+    lv_chart_set_point_id(weekChart, weekSeries, weekDays[i].total / scale, i);
+  }
+  lv_chart_set_x_tick_texts(weekChart, weekTicks, 1, LV_CHART_AXIS_DRAW_LAST_TICK);
+  lv_chart_refresh(weekChart);
+
+  lv_label_set_text_fmt(weekLabel, "7 days: %lu\nAverage: %lu", total, total / nbWeekDays);
+  lv_label_set_align(weekLabel, LV_LABEL_ALIGN_CENTER);
+  lv_obj_align(weekLabel, nullptr, LV_ALIGN_IN_TOP_MID, 0, 5);
+  lv_obj_set_hidden(weekView, false);
+}
+
 void Steps::lapBtnEventHandler(lv_event_t event) {
   if (event != LV_EVENT_CLICKED) {
     return;
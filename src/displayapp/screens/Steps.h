@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <lvgl/lvgl.h>
 #include "displayapp/screens/Screen.h"
@@ -23,6 +24,7 @@ namespace Pinetime {
         ~Steps() override;
 
         void Refresh() override;
+        bool OnTouchEvent(TouchEvents event) override;
         void lapBtnEventHandler(lv_event_t event);
 
       private:
@@ -39,7 +41,19 @@ namespace Pinetime {
 
         uint32_t stepsCount;
 
+        // Steps of the last days, shown on swipe up
+        static constexpr uint8_t nbWeekDays = 7;
+        lv_obj_t* weekView = nullptr;
+        lv_obj_t* weekChart;
+        lv_chart_series_t* weekSeries;
+        lv_obj_t* weekLabel;
+        // Initials of the days under the columns, used as is by the chart
+        char weekTicks[nbWeekDays * 2];
+        std::array<Controllers::StepHistory::DayRecord, nbWeekDays> weekDays;
+
         lv_task_t* taskRefresh;
+
+        void ShowWeek();
       };
     }
 
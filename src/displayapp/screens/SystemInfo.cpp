@@ -12,8 +12,13 @@
 #include "components/brightness/BrightnessController.h"
 #include "components/datetime/DateTimeController.h"
 #include "components/motion/MotionController.h"
+#include "components/timer/TimerWheel.h"
 #include "drivers/Watchdog.h"
+#include "systemtask/SystemMonitor.h"
 #include "displayapp/InfiniTimeTheme.h"
+#include "FreeRTOS/heap_pools.h"
+#include "FreeRTOS/heap_arena.h"
+#include "FreeRTOS/heap_stats.h"
 
 using namespace Pinetime::Applications::Screens;
 
@@ -38,7 +43,9 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
                        const Pinetime::Controllers::Ble& bleController,
                        const Pinetime::Drivers::Watchdog& watchdog,
                        Pinetime::Controllers::MotionController& motionController,
-                       const Pinetime::Drivers::Cst816S& touchPanel)
+                       const Pinetime::Drivers::Cst816S& touchPanel,
+                       const Pinetime::System::SystemMonitor& systemMonitor,
+                       const Pinetime::Controllers::TimerWheel& timerWheel)
   : app {app},
     dateTimeController {dateTimeController},
     batteryController {batteryController},
@@ -47,6 +54,8 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
     watchdog {watchdog},
     motionController {motionController},
     touchPanel {touchPanel},
+    systemMonitor {systemMonitor},
+    timerWheel {timerWheel},
     screens {app,
              0,
              {[this]() -> std::unique_ptr<Screen> {
@@ -63,6 +72,21 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
               },
               [this]() -> std::unique_ptr<Screen> {
                 return CreateScreen5();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen6();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen7();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen8();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen9();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen10();
               }},
              Screens::ScreenListModes::UpDown} {
 }
@@ -95,7 +119,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen1() {
                         BootloaderVersion::VersionString());
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(0, 5, label);
+  return std::make_unique<Screens::Label>(0, 10, label);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
@@ -174,7 +198,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
                         touchPanel.GetFwVersion(),
                         TARGET_DEVICE_NAME);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(1, 5, label);
+  return std::make_unique<Screens::Label>(1, 10, label);
 }
 
 extern int mallocFailedCount;
@@ -195,7 +219,8 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         " #808080 Free# %d\n"
                         " #808080 Min free# %d\n"
                         " #808080 Alloc err# %d\n"
-                        " #808080 Ovrfl err# %d\n",
+                        " #808080 Ovrfl err# %d\n"
+                        " #808080 Clock# %dB %lums\n",
                         bleAddr[5],
                         bleAddr[4],
                         bleAddr[3],
@@ -205,9 +230,11 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         xPortGetFreeHeapSize(),
                         xPortGetMinimumEverFreeHeapSize(),
                         mallocFailedCount,
-                        stackOverflowCount);
+                        stackOverflowCount,
+                        app->ClockMemoryUsage(),
+                        static_cast<unsigned long>(app->ClockLoadDuration() * 1000 / configTICK_RATE_HZ));
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(2, 5, label);
+  return std::make_unique<Screens::Label>(2, 10, label);
 }
 
 bool SystemInfo::sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs) {
@@ -268,10 +295,167 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
     }
     lv_table_set_cell_value(infoTask, i + 1, 3, buffer);
   }
-  return std::make_unique<Screens::Label>(3, 5, infoTask);
+  return std::make_unique<Screens::Label>(3, 10, infoTask);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+  using States = DisplayApp::States;
+  const auto& residency = app->StateResidency();
+  const TickType_t now = xTaskGetTickCount();
+  const uint32_t total = std::max<uint32_t>(1, now);
+
+  // Time in each state, as hh:mm and as a percentage of the uptime
+  auto hours = [&](States state) {
+    return residency.TimeIn(state, now) / configTICK_RATE_HZ / 3600;
+  };
+  auto minutes = [&](States state) {
+    return (residency.TimeIn(state, now) / configTICK_RATE_HZ / 60) % 60;
+  };
+  auto percent = [&](States state) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(residency.TimeIn(state, now)) * 100 / total);
+  };
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#FFFF00 Display power#\n\n"
+                        "#808080 On#\n %02lu:%02lu %3lu%% %lux\n"
+                        "#808080 Always on#\n %02lu:%02lu %3lu%% %lux\n"
+                        "#808080 Off#\n %02lu:%02lu %3lu%% %lux",
+                        hours(States::Running),
+                        minutes(States::Running),
+                        percent(States::Running),
+                        residency.Entries(States::Running),
+                        hours(States::AlwaysOn),
+                        minutes(States::AlwaysOn),
+                        percent(States::AlwaysOn),
+                        residency.Entries(States::AlwaysOn),
+                        hours(States::Idle),
+                        minutes(States::Idle),
+                        percent(States::Idle),
+                        residency.Entries(States::Idle));
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(4, 10, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen6() {
+  HeapPoolStats_t pools[heapPOOLS_CLASS_COUNT];
+  vHeapPoolsGetStats(pools);
+
+  char text[256];
+  int length = snprintf(text, sizeof(text), "#FFFF00 Memory pools#\n\n#808080 Size Used Peak Ovfl#\n");
+  // The text is truncated once it is full
+  for (size_t i = 0; i < heapPOOLS_CLASS_COUNT && length < static_cast<int>(sizeof(text)); i++) {
+    const auto& pool = pools[i];
+    length += snprintf(text + length,
+                       sizeof(text) - length,
+                       " %2u %2u/%-2u %2u %lu\n",
+                       pool.usBlockSize,
+                       pool.usUsed,
+                       pool.usBlockCount,
+                       pool.usPeak,
+                       pool.ulOverflows);
+  }
+  HeapArenaStats_t arena;
+  vHeapArenaGetStats(&arena);
+  if (length < static_cast<int>(sizeof(text))) {
+    snprintf(text + length,
+             sizeof(text) - length,
+             "\n#808080 Heap largest# %u\n#808080 Heap blocks# %u\n#808080 Arena# %lu/%lu %lu\n#808080 Pinned# %lu",
+             static_cast<unsigned>(xPortGetLargestFreeBlockSize()),
+             static_cast<unsigned>(xPortGetNumberOfFreeBlocks()),
+             arena.ulUsed,
+             arena.ulSize,
+             arena.ulOverflows,
+             arena.ulPinned);
+  }
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text(label, text);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(5, 10, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen7() {
+  // CPU load during the last sampling period and number of allocations since boot of each task
+  char text[256];
+  int length = snprintf(text, sizeof(text), "#FFFF00 Tasks#\n#808080 CPU   Alloc#\n");
+  const auto& tasks = systemMonitor.Tasks();
+  // The text is truncated once it is full
+  for (size_t i = 0; i < systemMonitor.NbTasks() && length < static_cast<int>(sizeof(text)); i++) {
+    length += snprintf(text + length,
+                       sizeof(text) - length,
+                       "#808080 %-3.10s# %3u.%u%% %lu\n",
+                       tasks[i].name,
+                       tasks[i].cpuLoad / 10,
+                       tasks[i].cpuLoad % 10,
+                       tasks[i].allocations);
+  }
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text(label, text);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(6, 10, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen8() {
+  const auto& previousRun = systemMonitor.PreviousRun();
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  if (previousRun.minFreeHeap == 0) {
+    lv_label_set_text_static(label, "#FFFF00 Previous run#\n\nNot available");
+  } else {
+    lv_label_set_text_fmt(label,
+                          "#FFFF00 Previous run#\n\n"
+                          "#808080 Min free# %lu\n"
+                          "#808080 Min largest# %lu\n"
+                          "#808080 Alloc err# %lu\n"
+                          "#808080 Ovrfl err# %lu\n"
+                          "#808080 Min stack# %.*s %u",
+                          previousRun.minFreeHeap,
+                          previousRun.minLargestFreeBlock,
+                          previousRun.mallocFailures,
+                          previousRun.stackOverflows,
+                          static_cast<int>(sizeof(previousRun.minFreeStackTask)),
+                          previousRun.minFreeStackTask,
+                          previousRun.minFreeStack);
+  }
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(7, 10, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen9() {
+  static constexpr const char* binNames[portSLEEP_HISTOGRAM_BINS] = {"<4ms", "<16ms", "<64ms", "<.25s", "<1s", "<4s", ">4s"};
+  const auto& sleeps = systemMonitor.Sleeps();
+  const uint32_t uptime = std::max<uint32_t>(1, xTaskGetTickCount());
+
+  // Number of tickless idle sleeps and share of the uptime spent in them, by duration
+  char text[256];
+  int length = snprintf(text, sizeof(text), "#FFFF00 Sleep#\n");
+  for (size_t i = 0; i < portSLEEP_HISTOGRAM_BINS && length < static_cast<int>(sizeof(text)); i++) {
+    length += snprintf(text + length,
+                       sizeof(text) - length,
+                       "#808080 %-5s# %6lu %3lu%%\n",
+                       binNames[i],
+                       sleeps.counts[i],
+                       static_cast<uint32_t>(static_cast<uint64_t>(sleeps.ticks[i]) * 100 / uptime));
+  }
+  // Wakeups of the timer wheel, and number of expired timers: the difference is the number of wakeups saved
+  if (length < static_cast<int>(sizeof(text))) {
+    snprintf(text + length, sizeof(text) - length, "#FFFF00 Timers# %lu/%lu", timerWheel.Wakeups(), timerWheel.Expirations());
+  }
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text(label, text);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(8, 10, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen10() {
   lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_recolor(label, true);
   lv_label_set_text_static(label,
@@ -285,5 +469,5 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
                            "#FFFF00 InfiniTime#");
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(4, 5, label);
+  return std::make_unique<Screens::Label>(9, 10, label);
 }
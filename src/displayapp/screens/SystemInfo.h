@@ -10,12 +10,17 @@ namespace Pinetime {
     class Battery;
     class BrightnessController;
     class Ble;
+    class TimerWheel;
   }
 
   namespace Drivers {
     class Watchdog;
   }
 
+  namespace System {
+    class SystemMonitor;
+  }
+
   namespace Applications {
     class DisplayApp;
 
@@ -29,7 +34,9 @@ namespace Pinetime {
                             const Pinetime::Controllers::Ble& bleController,
                             const Pinetime::Drivers::Watchdog& watchdog,
                             Pinetime::Controllers::MotionController& motionController,
-                            const Pinetime::Drivers::Cst816S& touchPanel);
+                            const Pinetime::Drivers::Cst816S& touchPanel,
+                            const Pinetime::System::SystemMonitor& systemMonitor,
+                            const Pinetime::Controllers::TimerWheel& timerWheel);
         ~SystemInfo() override;
         bool OnTouchEvent(TouchEvents event) override;
 
@@ -42,8 +49,10 @@ namespace Pinetime {
         const Pinetime::Drivers::Watchdog& watchdog;
         Pinetime::Controllers::MotionController& motionController;
         const Pinetime::Drivers::Cst816S& touchPanel;
+        const Pinetime::System::SystemMonitor& systemMonitor;
+        const Pinetime::Controllers::TimerWheel& timerWheel;
 
-        ScreenList<5> screens;
+        ScreenList<10> screens;
 
         static bool sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs);
 
@@ -52,6 +61,11 @@ namespace Pinetime {
         std::unique_ptr<Screen> CreateScreen3();
         std::unique_ptr<Screen> CreateScreen4();
         std::unique_ptr<Screen> CreateScreen5();
+        std::unique_ptr<Screen> CreateScreen6();
+        std::unique_ptr<Screen> CreateScreen7();
+        std::unique_ptr<Screen> CreateScreen8();
+        std::unique_ptr<Screen> CreateScreen9();
+        std::unique_ptr<Screen> CreateScreen10();
       };
     }
   }
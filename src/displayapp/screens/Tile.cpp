@@ -94,7 +94,7 @@ Tile::~Tile() {
 }
 
 void Tile::UpdateScreen() {
-  lv_label_set_text(label_time, dateTimeController.FormattedTime().c_str());
+  lv_label_set_text(label_time, dateTimeController.FormattedTime().Data());
   statusIcons.Update();
 }
 
@@ -32,19 +32,15 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
     heartRateController {heartRateController},
     motionController {motionController} {
 
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/lv_font_dots_40.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
+  if (filesystem.IsResourceAvailable("/fonts/lv_font_dots_40.bin")) {
     font_dot40 = lv_font_load("F:/fonts/lv_font_dots_40.bin");
   }
 
-  if (filesystem.FileOpen(&f, "/fonts/7segments_40.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
+  if (filesystem.IsResourceAvailable("/fonts/7segments_40.bin")) {
     font_segment40 = lv_font_load("F:/fonts/7segments_40.bin");
   }
 
-  if (filesystem.FileOpen(&f, "/fonts/7segments_115.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
+  if (filesystem.IsResourceAvailable("/fonts/7segments_115.bin")) {
     font_segment115 = lv_font_load("F:/fonts/7segments_115.bin");
   }
 
@@ -313,22 +309,6 @@ void WatchFaceCasioStyleG7710::Refresh() {
 }
 
 bool WatchFaceCasioStyleG7710::IsAvailable(Pinetime::Controllers::FS& filesystem) {
-  lfs_file file = {};
-
-  if (filesystem.FileOpen(&file, "/fonts/lv_font_dots_40.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/fonts/7segments_40.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/fonts/7segments_115.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  return true;
+  return filesystem.IsResourceAvailable("/fonts/lv_font_dots_40.bin") && filesystem.IsResourceAvailable("/fonts/7segments_40.bin") &&
+         filesystem.IsResourceAvailable("/fonts/7segments_115.bin");
 }
@@ -133,14 +133,11 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
     notificationManager {notificationManager},
     settingsController {settingsController},
     motionController {motionController} {
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/teko.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
+  if (filesystem.IsResourceAvailable("/fonts/teko.bin")) {
     font_teko = lv_font_load("F:/fonts/teko.bin");
   }
 
-  if (filesystem.FileOpen(&f, "/fonts/bebas.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
+  if (filesystem.IsResourceAvailable("/fonts/bebas.bin")) {
     font_bebas = lv_font_load("F:/fonts/bebas.bin");
   }
 
@@ -488,22 +485,6 @@ void WatchFaceInfineat::ToggleBatteryIndicatorColor(bool showSideCover) {
 }
 
 bool WatchFaceInfineat::IsAvailable(Pinetime::Controllers::FS& filesystem) {
-  lfs_file file = {};
-
-  if (filesystem.FileOpen(&file, "/fonts/teko.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/fonts/bebas.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/images/pine_small.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  return true;
+  return filesystem.IsResourceAvailable("/fonts/teko.bin") && filesystem.IsResourceAvailable("/fonts/bebas.bin") &&
+         filesystem.IsResourceAvailable("/images/pine_small.bin");
 }
@@ -131,7 +131,7 @@ QuickSettings::~QuickSettings() {
 }
 
 void QuickSettings::UpdateScreen() {
-  lv_label_set_text(label_time, dateTimeController.FormattedTime().c_str());
+  lv_label_set_text(label_time, dateTimeController.FormattedTime().Data());
   statusIcons.Update();
 }
 
@@ -56,6 +56,12 @@ SettingDisplay::SettingDisplay(Pinetime::Applications::DisplayApp* app, Pinetime
       lv_checkbox_set_checked(cbOption[i], true);
     }
   }
+
+  alwaysOnCheckbox = lv_checkbox_create(container1, nullptr);
+  lv_checkbox_set_text_static(alwaysOnCheckbox, "Always On");
+  lv_checkbox_set_checked(alwaysOnCheckbox, settingsController.GetAlwaysOnDisplay());
+  alwaysOnCheckbox->user_data = this;
+  lv_obj_set_event_cb(alwaysOnCheckbox, event_handler);
 }
 
 SettingDisplay::~SettingDisplay() {
@@ -64,6 +70,13 @@ SettingDisplay::~SettingDisplay() {
 }
 
 void SettingDisplay::UpdateSelected(lv_obj_t* object, lv_event_t event) {
+  if (object == alwaysOnCheckbox) {
+    if (event == LV_EVENT_VALUE_CHANGED) {
+      settingsController.SetAlwaysOnDisplay(lv_checkbox_is_checked(alwaysOnCheckbox));
+    }
+    return;
+  }
+
   if (event == LV_EVENT_CLICKED) {
     for (unsigned int i = 0; i < options.size(); i++) {
       if (object == cbOption[i]) {
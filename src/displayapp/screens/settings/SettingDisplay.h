@@ -25,6 +25,7 @@ namespace Pinetime {
 
         Controllers::Settings& settingsController;
         lv_obj_t* cbOption[options.size()];
+        lv_obj_t* alwaysOnCheckbox;
       };
     }
   }
@@ -0,0 +1,67 @@
+#include "displayapp/screens/settings/SettingHeartRate.h"
+#include <lvgl/lvgl.h>
+#include "components/heartrate/HeartRateController.h"
+#include "displayapp/DisplayApp.h"
+#include "displayapp/screens/Styles.h"
+#include "displayapp/screens/Screen.h"
+#include "displayapp/screens/Symbols.h"
+#include <array>
+
+using namespace Pinetime::Applications::Screens;
+
+namespace {
+  struct Option {
+    uint32_t interval; // seconds
+    const char* name;
+  };
+
+  constexpr std::array<Option, 4> options = {{
+    {0, "Off"},
+    {60, "Every minute"},
+    {10 * 60, "Every 10 mins"},
+    {60 * 60, "Every hour"},
+  }};
+
+  std::array<CheckboxList::Item, CheckboxList::MaxItems> CreateOptionArray() {
+    std::array<Pinetime::Applications::Screens::CheckboxList::Item, CheckboxList::MaxItems> optionArray;
+    for (size_t i = 0; i < CheckboxList::MaxItems; i++) {
+      if (i >= options.size()) {
+        optionArray[i].name = "";
+        optionArray[i].enabled = false;
+      } else {
+        optionArray[i].name = options[i].name;
+        optionArray[i].enabled = true;
+      }
+    }
+    return optionArray;
+  }
+
+  uint32_t GetDefaultOption(uint32_t currentInterval) {
+    for (size_t i = 0; i < options.size(); i++) {
+      if (options[i].interval == currentInterval) {
+        return i;
+      }
+    }
+    return 0;
+  }
+}
+
+SettingHeartRate::SettingHeartRate(Pinetime::Controllers::Settings& settingsController,
+                                   Pinetime::Controllers::HeartRateController& heartRateController)
+  : checkboxList(
+      0,
+      1,
+      "Heart rate",
+      Symbols::heartBeat,
+      GetDefaultOption(settingsController.GetHeartRateBackgroundInterval()),
+      [&settings = settingsController, &heartRateController](uint32_t index) {
+        settings.SetHeartRateBackgroundInterval(options[index].interval);
+        settings.SaveSettings();
+        heartRateController.UpdateBackgroundMeasurement();
+      },
+      CreateOptionArray()) {
+}
+
+SettingHeartRate::~SettingHeartRate() {
+  lv_obj_clean(lv_scr_act());
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <lvgl/lvgl.h>
+
+#include "components/settings/Settings.h"
+#include "displayapp/screens/Screen.h"
+#include "displayapp/screens/CheckboxList.h"
+
+namespace Pinetime {
+
+  namespace Controllers {
+    class HeartRateController;
+  }
+
+  namespace Applications {
+    namespace Screens {
+
+      class SettingHeartRate : public Screen {
+      public:
+        SettingHeartRate(Pinetime::Controllers::Settings& settingsController,
+                         Pinetime::Controllers::HeartRateController& heartRateController);
+        ~SettingHeartRate() override;
+
+      private:
+        CheckboxList checkboxList;
+      };
+    }
+  }
+}
@@ -0,0 +1,84 @@
+#include "displayapp/widgets/ScrollView.h"
+#include <algorithm>
+#include <task.h>
+
+using namespace Pinetime::Applications::Widgets;
+
+ScrollView::ScrollView(Components::LittleVgl& lvgl) : lvgl {lvgl} {
+}
+
+void ScrollView::Create(lv_obj_t* parent) {
+  viewport = lv_cont_create(parent, nullptr);
+  lv_obj_set_style_local_bg_opa(viewport, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+  lv_obj_set_style_local_border_width(viewport, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_style_local_pad_all(viewport, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_pos(viewport, 0, 0);
+  lv_obj_set_size(viewport, LV_HOR_RES, LV_VER_RES);
+
+  content = lv_cont_create(viewport, nullptr);
+  lv_obj_set_style_local_bg_opa(content, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+  lv_obj_set_style_local_border_width(content, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_style_local_pad_all(content, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_style_local_pad_inner(content, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_pos(content, 0, 0);
+  lv_obj_set_width(content, LV_HOR_RES);
+  lv_cont_set_fit2(content, LV_FIT_NONE, LV_FIT_TIGHT);
+  lv_cont_set_layout(content, LV_LAYOUT_COLUMN_LEFT);
+}
+
+bool ScrollView::ScrollBy(lv_coord_t distance) {
+  const lv_coord_t minY = std::min<lv_coord_t>(0, LV_VER_RES - lv_obj_get_height(content));
+  const lv_coord_t currentY = lv_obj_get_y(content);
+  const lv_coord_t newY = std::max<lv_coord_t>(minY, std::min<lv_coord_t>(0, currentY - distance));
+  const lv_coord_t shift = currentY - newY;
+  if (shift == 0) {
+    return false;
+  }
+
+  if (!lvgl.ScrollVertical(shift)) {
+    lv_obj_set_y(content, newY);
+    return true;
+  }
+
+  // The rows still visible are moved by the display itself: drop the invalidation of the whole
+  // content triggered by moving it and only redraw the rows that have just been exposed.
+  lv_disp_t* disp = lv_disp_get_default();
+  const auto invalidatedAreas = disp->inv_p;
+  lv_obj_set_y(content, newY);
+  disp->inv_p = invalidatedAreas;
+
+  lv_area_t exposed;
+  exposed.x1 = 0;
+  exposed.x2 = LV_HOR_RES - 1;
+  if (shift > 0) {
+    exposed.y1 = LV_VER_RES - shift;
+    exposed.y2 = LV_VER_RES - 1;
+  } else {
+    exposed.y1 = 0;
+    exposed.y2 = -shift - 1;
+  }
+  _lv_inv_area(disp, &exposed);
+  return true;
+}
+
+void ScrollView::ScrollToTop() {
+  lv_obj_set_y(content, 0);
+}
+
+void ScrollView::OnTouch(uint16_t y) {
+  const TickType_t now = xTaskGetTickCount();
+  if (lastTouchY >= 0 && now - lastTouchTime < dragTimeout) {
+    moved |= ScrollBy(lastTouchY - static_cast<int16_t>(y));
+  } else {
+    moved = false;
+  }
+  lastTouchY = y;
+  lastTouchTime = now;
+}
+
+bool ScrollView::OnRelease() {
+  const bool wasMoved = moved;
+  lastTouchY = -1;
+  moved = false;
+  return wasMoved;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <lvgl/lvgl.h>
+#include <FreeRTOS.h>
+#include "displayapp/LittleVgl.h"
+
+namespace Pinetime {
+  namespace Applications {
+    namespace Widgets {
+      // Full screen scrollable container. Scrolling shifts the content already on the panel with the
+      // display's vertical scroll register, so only the newly exposed rows are rendered and flushed.
+      class ScrollView {
+      public:
+        explicit ScrollView(Components::LittleVgl& lvgl);
+        void Create(lv_obj_t* parent);
+
+        // Children must be created in this object
+        lv_obj_t* GetContent() const {
+          return content;
+        }
+
+        // Positive values reveal the content below, negative values the content above.
+        // @return false if the view is already at the end of the content
+        bool ScrollBy(lv_coord_t distance);
+        void ScrollToTop();
+
+        // Scrolls the content by following a finger being dragged on the screen. A new drag starts after
+        // OnRelease(), or if the touch points stopped for more than dragTimeout.
+        void OnTouch(uint16_t y);
+        // @return true if the content was moved since the touch started: the gesture that ends the drag must
+        // then be ignored
+        bool OnRelease();
+
+      private:
+        Components::LittleVgl& lvgl;
+        lv_obj_t* viewport;
+        lv_obj_t* content;
+
+        static constexpr TickType_t dragTimeout = pdMS_TO_TICKS(100);
+
+        int16_t lastTouchY = -1;
+        TickType_t lastTouchTime = 0;
+        bool moved = false;
+      };
+    }
+  }
+}
@@ -1,4 +1,5 @@
 #include "drivers/Bma421.h"
+#include <algorithm>
 #include <libraries/delay/nrf_delay.h>
 #include <libraries/log/nrf_log.h>
 #include "drivers/TwiMaster.h"
@@ -32,6 +33,11 @@ namespace {
     [BMA4_ACCEL_RANGE_8G] = 256,  // LSB/g +/- 8g range
     [BMA4_ACCEL_RANGE_16G] = 128  // LSB/g +/- 16g range
   };
+
+  constexpr uint16_t fifoSize = 1024;
+  constexpr uint8_t fifoFlushCommand = 0xB0;
+  // A TWI transfer is limited to 255 bytes
+  constexpr size_t maxFifoSamples = 255 / BMA4_FIFO_A_LENGTH;
 }
 
 Bma421::Bma421(TwiMaster& twiMaster, uint8_t twiAddress) : twiMaster {twiMaster}, deviceAddress {twiAddress} {
@@ -84,6 +90,7 @@ void Bma421::Init() {
   if (ret != BMA4_OK)
     return;
 
+  static_assert(sampleRate == 100);
   accel_conf.odr = BMA4_OUTPUT_DATA_RATE_100HZ;
   accel_conf.range = BMA4_ACCEL_RANGE_2G;
   accel_conf.bandwidth = BMA4_ACCEL_NORMAL_AVG4;
@@ -137,6 +144,60 @@ Bma421::Values Bma421::Process() {
   return {steps, data.y, data.x, data.z};
 }
 
+void Bma421::EnableFifo(bool enable) {
+  if (not isOk)
+    return;
+  if (enable) {
+    // Headerless frames of 6 bytes (X, Y, Z), the oldest frames are overwritten when the FIFO is full
+    bma4_set_fifo_config(BMA4_FIFO_HEADER | BMA4_FIFO_STOP_ON_FULL, 0, &bma);
+    bma4_set_fifo_config(BMA4_FIFO_ACCEL, 1, &bma);
+    bma4_set_command_register(fifoFlushCommand, &bma);
+  } else {
+    bma4_set_fifo_config(BMA4_FIFO_ACCEL, 0, &bma);
+  }
+  fifoEnabled = enable;
+}
+
+size_t Bma421::FifoLength() {
+  if (not isOk or not fifoEnabled)
+    return 0;
+
+  uint16_t length = 0;
+  if (bma4_get_fifo_length(&length, &bma) != BMA4_OK)
+    return 0;
+  return std::min(static_cast<size_t>(length / BMA4_FIFO_A_LENGTH), maxFifoSamples);
+}
+
+size_t Bma421::ReadFifo(Sample* samples, size_t maxSamples, bool& overflow) {
+  static_assert(sizeof(Sample) == BMA4_FIFO_A_LENGTH);
+  overflow = false;
+  if (not isOk or not fifoEnabled)
+    return 0;
+
+  uint16_t length = 0;
+  if (bma4_get_fifo_length(&length, &bma) != BMA4_OK)
+    return 0;
+  overflow = length > fifoSize - BMA4_FIFO_A_LENGTH;
+
+  // The frames are read directly in samples: the registers are little endian, like the CPU
+  const size_t nbSamples = std::min({static_cast<size_t>(length / BMA4_FIFO_A_LENGTH), maxSamples, maxFifoSamples});
+  if (nbSamples == 0)
+    return 0;
+  Read(BMA4_FIFO_DATA_ADDR, reinterpret_cast<uint8_t*>(samples), nbSamples * BMA4_FIFO_A_LENGTH);
+
+  const int16_t divider = (bma.resolution == BMA4_12_BIT_RESOLUTION) ? 0x10 : ((bma.resolution == BMA4_14_BIT_RESOLUTION) ? 0x04 : 1);
+  for (size_t i = 0; i < nbSamples; i++) {
+    const int32_t x = samples[i].x / divider;
+    const int32_t y = samples[i].y / divider;
+    const int32_t z = samples[i].z / divider;
+    // Same scaling and axes as Process()
+    samples[i] = {static_cast<int16_t>(1024 * y / accelScaleFactors[accel_conf.range]),
+                  static_cast<int16_t>(1024 * x / accelScaleFactors[accel_conf.range]),
+                  static_cast<int16_t>(1024 * z / accelScaleFactors[accel_conf.range])};
+  }
+  return nbSamples;
+}
+
 bool Bma421::IsOk() const {
   return isOk;
 }
@@ -16,6 +16,16 @@ namespace Pinetime {
         int16_t z;
       };
 
+      // Acceleration in binary milli-g, with the same axes as Values
+      struct Sample {
+        int16_t x;
+        int16_t y;
+        int16_t z;
+      };
+
+      // Output data rate of the accelerometer, and of the FIFO
+      static constexpr uint16_t sampleRate = 100;
+
       Bma421(TwiMaster& twiMaster, uint8_t twiAddress);
       Bma421(const Bma421&) = delete;
       Bma421& operator=(const Bma421&) = delete;
@@ -29,6 +39,19 @@ namespace Pinetime {
       Values Process();
       void ResetStepCounter();
 
+      // The FIFO stores the samples of the accelerometer (up to 170) until they are read by ReadFifo(). It is flushed
+      // when it is enabled.
+      void EnableFifo(bool enable);
+      bool IsFifoEnabled() const {
+        return fifoEnabled;
+      }
+
+      // Number of samples in the FIFO
+      size_t FifoLength();
+      // Reads at most maxSamples samples, the oldest first. overflow is set if the FIFO was full: samples were lost
+      // before the ones that are returned.
+      size_t ReadFifo(Sample* samples, size_t maxSamples, bool& overflow);
+
       void Read(uint8_t registerAddress, uint8_t* buffer, size_t size);
       void Write(uint8_t registerAddress, const uint8_t* data, size_t size);
 
@@ -44,6 +67,7 @@ namespace Pinetime {
       struct bma4_accel_config accel_conf; // Store the device configuration for later reference.
       bool isOk = false;
       bool isResetOk = false;
+      bool fifoEnabled = false;
       DeviceTypes deviceType = DeviceTypes::Unknown;
     };
   }
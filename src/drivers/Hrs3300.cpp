@@ -103,6 +103,20 @@ void Hrs3300::SetDrive(uint8_t drive) {
   WriteRegister(static_cast<uint8_t>(Registers::PDriver), pd);
 }
 
+void Hrs3300::SetConversion(WaitTimes waitTime, uint8_t resolution) {
+  constexpr uint8_t minResolution = 8;
+  constexpr uint8_t maxResolution = 16;
+  resolution = std::clamp(resolution, minResolution, maxResolution);
+
+  auto en = ReadRegister(static_cast<uint8_t>(Registers::Enable));
+  en = (en & 0x8f) | (static_cast<uint8_t>(waitTime) << 4);
+  WriteRegister(static_cast<uint8_t>(Registers::Enable), en);
+
+  // The same resolution for HRS (low nibble) and ALS (high nibble), 0x7 is 15-bit
+  const uint8_t res = resolution - minResolution;
+  WriteRegister(static_cast<uint8_t>(Registers::Res), (res << 4) | res);
+}
+
 void Hrs3300::WriteRegister(uint8_t reg, uint8_t data) {
   auto ret = twiMaster.Write(twiAddress, reg, &data, 1);
   if (ret != TwiMaster::ErrorCodes::NoError)
@@ -21,6 +21,9 @@ namespace Pinetime {
         Hgain = 0x17
       };
 
+      // Wait time between 2 ADC conversions (HWT bits of the Enable register)
+      enum class WaitTimes : uint8_t { Ms800 = 0, Ms400, Ms200, Ms100, Ms75, Ms50, Ms12_5, Ms0 };
+
       Hrs3300(TwiMaster& twiMaster, uint8_t twiAddress);
       Hrs3300(const Hrs3300&) = delete;
       Hrs3300& operator=(const Hrs3300&) = delete;
@@ -34,6 +37,9 @@ namespace Pinetime {
       uint32_t ReadAls();
       void SetGain(uint8_t gain);
       void SetDrive(uint8_t drive);
+      // Sets the conversion period of the sensor: resolution (bits) of the HRS and ALS ADCs and wait time between 2
+      // conversions. Each bit of resolution removed halves the conversion time (~50ms at 15 bits).
+      void SetConversion(WaitTimes waitTime, uint8_t resolution);
 
     private:
       TwiMaster& twiMaster;
@@ -3,6 +3,7 @@
 #include <hal/nrf_spim.h>
 #include <nrfx_log.h>
 #include <algorithm>
+#include "logging/Trace.h"
 
 using namespace Pinetime::Drivers;
 
@@ -128,6 +129,7 @@ void SpiMaster::OnEndEvent() {
   }
 
   auto s = currentBufferSize;
+  TRACE_EVENT(SpiChunkSent, s, 0);
   if (s > 0) {
     auto currentSize = std::min((size_t) 255, s);
     PrepareTx(currentBufferAddr, currentSize);
@@ -3,6 +3,7 @@
 #include <libraries/delay/nrf_delay.h>
 #include <nrfx_log.h>
 #include "drivers/Spi.h"
+#include <task.h>
 
 using namespace Pinetime::Drivers;
 
@@ -58,7 +59,7 @@ void St7789::SleepIn() {
 
 void St7789::ColMod() {
   WriteCommand(static_cast<uint8_t>(Commands::ColMod));
-  WriteData(0x55);
+  WriteData(static_cast<uint8_t>(colorMode));
   nrf_delay_ms(10);
 }
 
@@ -137,7 +138,26 @@ void St7789::SetVdv() {
 
 void St7789::DisplayOff() {
   WriteCommand(static_cast<uint8_t>(Commands::DisplayOff));
-  nrf_delay_ms(500);
+}
+
+void St7789::PartialArea(uint16_t firstLine, uint16_t lastLine) {
+  WriteCommand(static_cast<uint8_t>(Commands::PartialArea));
+  WriteData(firstLine >> 8u);
+  WriteData(firstLine & 0xffu);
+  WriteData(lastLine >> 8u);
+  WriteData(lastLine & 0xffu);
+}
+
+void St7789::PartialModeOn() {
+  WriteCommand(static_cast<uint8_t>(Commands::PartialModeOn));
+}
+
+void St7789::IdleModeOn() {
+  WriteCommand(static_cast<uint8_t>(Commands::IdleModeOn));
+}
+
+void St7789::IdleModeOff() {
+  WriteCommand(static_cast<uint8_t>(Commands::IdleModeOff));
 }
 
 void St7789::VerticalScrollStartAddress(uint16_t line) {
@@ -150,6 +170,10 @@ void St7789::VerticalScrollStartAddress(uint16_t line) {
 void St7789::Uninit() {
 }
 
+void St7789::SetColorMode(ColorModes mode) {
+  colorMode = mode;
+}
+
 void St7789::DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size) {
   SetAddrWindow(x, y, x + width - 1, y + height - 1);
   nrf_gpio_pin_set(pinDataCommand);
@@ -162,15 +186,42 @@ void St7789::HardwareReset() {
   nrf_gpio_pin_set(pinReset);
 }
 
+void St7789::WaitSinceLastSleepTransition(TickType_t delay) {
+  const TickType_t elapsed = xTaskGetTickCount() - lastSleepTransition;
+  if (elapsed < delay) {
+    vTaskDelay(delay - elapsed);
+  }
+}
+
 void St7789::Sleep() {
+  // The frame memory is retained in sleep mode: the content will be visible again as is on wakeup
+  WaitSinceLastSleepTransition(sleepOutToSleepInDelay);
   SleepIn();
+  lastSleepTransition = xTaskGetTickCount();
   nrf_gpio_cfg_default(pinDataCommand);
   NRF_LOG_INFO("[LCD] Sleep");
 }
 
+void St7789::LowPowerOn(uint16_t firstLine, uint16_t lastLine) {
+  PartialArea(firstLine, lastLine);
+  PartialModeOn();
+  IdleModeOn();
+  NRF_LOG_INFO("[LCD] Low power mode");
+}
+
+void St7789::LowPowerOff() {
+  IdleModeOff();
+  // Leaves partial mode
+  WriteCommand(static_cast<uint8_t>(Commands::NormalModeOn));
+  NRF_LOG_INFO("[LCD] Normal power mode");
+}
+
 void St7789::Wakeup() {
+  WaitSinceLastSleepTransition(sleepTransitionDelay);
   nrf_gpio_cfg_output(pinDataCommand);
   SleepOut();
+  lastSleepTransition = xTaskGetTickCount();
+  WaitSinceLastSleepTransition(sleepTransitionDelay);
   VerticalScrollStartAddress(verticalScrollingStartAddress);
   DisplayOn();
   NRF_LOG_INFO("[LCD] Wakeup")
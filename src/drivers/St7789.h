@@ -1,6 +1,7 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <FreeRTOS.h>
 
 namespace Pinetime {
   namespace Drivers {
@@ -8,6 +9,8 @@ namespace Pinetime {
 
     class St7789 {
     public:
+      enum class ColorModes : uint8_t { Rgb565 = 0x55, Rgb444 = 0x53 };
+
       explicit St7789(Spi& spi, uint8_t pinDataCommand, uint8_t pinReset);
       St7789(const St7789&) = delete;
       St7789& operator=(const St7789&) = delete;
@@ -17,6 +20,9 @@ namespace Pinetime {
       void Init();
       void Uninit();
 
+      // Takes effect on the next call to Init()
+      void SetColorMode(ColorModes mode);
+
       void VerticalScrollStartAddress(uint16_t line);
 
       void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size);
@@ -24,11 +30,16 @@ namespace Pinetime {
       void Sleep();
       void Wakeup();
 
+      // Idle mode (8 colors) with only the lines firstLine to lastLine displayed
+      void LowPowerOn(uint16_t firstLine, uint16_t lastLine);
+      void LowPowerOff();
+
     private:
       Spi& spi;
       uint8_t pinDataCommand;
       uint8_t pinReset;
-      uint8_t verticalScrollingStartAddress = 0;
+      uint16_t verticalScrollingStartAddress = 0;
+      ColorModes colorMode = ColorModes::Rgb565;
 
       void HardwareReset();
       void SoftwareReset();
@@ -41,6 +52,12 @@ namespace Pinetime {
       void WriteToRam();
       void DisplayOn();
       void DisplayOff();
+      void PartialArea(uint16_t firstLine, uint16_t lastLine);
+      void PartialModeOn();
+      void IdleModeOn();
+      void IdleModeOff();
+
+      void WaitSinceLastSleepTransition(TickType_t delay);
 
       void SetAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
       void SetVdv();
@@ -51,6 +68,7 @@ namespace Pinetime {
         SoftwareReset = 0x01,
         SleepIn = 0x10,
         SleepOut = 0x11,
+        PartialModeOn = 0x12,
         NormalModeOn = 0x13,
         DisplayInversionOn = 0x21,
         DisplayOff = 0x28,
@@ -58,15 +76,24 @@ namespace Pinetime {
         ColumnAddressSet = 0x2a,
         RowAddressSet = 0x2b,
         WriteToRam = 0x2c,
+        PartialArea = 0x30,
         MemoryDataAccessControl = 0x36,
         VerticalScrollDefinition = 0x33,
         VerticalScrollStartAddress = 0x37,
+        IdleModeOff = 0x38,
+        IdleModeOn = 0x39,
         ColMod = 0x3a,
         VdvSet = 0xc4,
       };
       void WriteData(uint8_t data);
       void ColumnAddressSet();
 
+      // The controller needs 120ms between SLPOUT and SLPIN, and 5ms after both before accepting new commands.
+      // Instead of blocking for a fixed time, only wait for the remaining time, if any.
+      static constexpr TickType_t sleepOutToSleepInDelay = pdMS_TO_TICKS(120);
+      static constexpr TickType_t sleepTransitionDelay = pdMS_TO_TICKS(5);
+      TickType_t lastSleepTransition = 0;
+
       static constexpr uint16_t Width = 240;
       static constexpr uint16_t Height = 320;
       void RowAddressSet();
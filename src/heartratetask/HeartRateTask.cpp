@@ -1,21 +1,29 @@
 #include "heartratetask/HeartRateTask.h"
 #include <drivers/Hrs3300.h>
 #include <components/heartrate/HeartRateController.h>
+#include <components/settings/Settings.h>
 #include <nrf_log.h>
+#include "logging/Trace.h"
 
 using namespace Pinetime::Applications;
 
-HeartRateTask::HeartRateTask(Drivers::Hrs3300& heartRateSensor, Controllers::HeartRateController& controller)
-  : heartRateSensor {heartRateSensor}, controller {controller} {
+HeartRateTask::HeartRateTask(Drivers::Hrs3300& heartRateSensor,
+                             Controllers::HeartRateController& controller,
+                             Controllers::Settings& settingsController)
+  : heartRateSensor {heartRateSensor}, controller {controller}, settingsController {settingsController} {
 }
 
 void HeartRateTask::Start() {
   messageQueue = xQueueCreate(10, 1);
+  sampleQueue = xQueueCreate(sampleQueueSize, sizeof(Sample));
   controller.SetHeartRateTask(this);
 
   if (pdPASS != xTaskCreate(HeartRateTask::Process, "Heartrate", 500, this, 0, &taskHandle)) {
     APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
   }
+  if (pdPASS != xTaskCreate(HeartRateTask::ProcessSampling, "HrsSampling", 120, this, 1, &samplingTaskHandle)) {
+    APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
+  }
 }
 
 void HeartRateTask::Process(void* instance) {
@@ -23,31 +31,40 @@ void HeartRateTask::Process(void* instance) {
   app->Work();
 }
 
+void HeartRateTask::ProcessSampling(void* instance) {
+  auto* app = static_cast<HeartRateTask*>(instance);
+  app->Sampling();
+}
+
 void HeartRateTask::Work() {
+  // Ppg analyses the signal every 0.5s, there is no need to wake up for each sample
+  static constexpr TickType_t analysisPeriod = pdMS_TO_TICKS(500);
   int lastBpm = 0;
+  int backgroundBpm = 0;
+  UpdateBackgroundPeriod();
   while (true) {
     Messages msg;
-    uint32_t delay;
-    if (state == States::Running) {
-      if (measurementStarted) {
-        delay = ppg.deltaTms;
-      } else {
-        delay = 100;
-      }
-    } else {
-      delay = portMAX_DELAY;
+    TickType_t delay = portMAX_DELAY;
+    if (Foreground() || backgroundMeasurement) {
+      delay = analysisPeriod;
+    } else if (backgroundPeriod != 0) {
+      const TickType_t remaining = nextBackgroundMeasurement - xTaskGetTickCount();
+      delay = (static_cast<int32_t>(remaining) > 0) ? remaining : 0;
     }
 
     if (xQueueReceive(messageQueue, &msg, delay)) {
       switch (msg) {
         case Messages::GoToSleep:
-          StopMeasurement();
+          if (!backgroundMeasurement) {
+            StopMeasurement();
+          }
           state = States::Idle;
           break;
         case Messages::WakeUp:
           state = States::Running;
           if (measurementStarted) {
             lastBpm = 0;
+            backgroundMeasurement = false;
             StartMeasurement();
           }
           break;
@@ -56,6 +73,7 @@ void HeartRateTask::Work() {
             break;
           }
           lastBpm = 0;
+          backgroundMeasurement = false;
           StartMeasurement();
           measurementStarted = true;
           break;
@@ -63,41 +81,155 @@ void HeartRateTask::Work() {
           if (!measurementStarted) {
             break;
           }
-          StopMeasurement();
+          if (!backgroundMeasurement) {
+            StopMeasurement();
+          }
           measurementStarted = false;
           break;
+        case Messages::UpdateBackgroundMeasurement:
+          UpdateBackgroundPeriod();
+          break;
       }
     }
 
-    if (measurementStarted) {
-      int8_t ambient = ppg.Preprocess(heartRateSensor.ReadHrs(), heartRateSensor.ReadAls());
-      int bpm = ppg.HeartRate();
-
-      // If ambient light detected or a reset requested (bpm < 0)
-      if (ambient > 0) {
-        // Reset all DAQ buffers
-        ppg.Reset(true);
-        // Force state to NotEnoughData (below)
-        lastBpm = 0;
-        bpm = 0;
-      } else if (bpm < 0) {
-        // Reset all DAQ buffers except HRS buffer
-        ppg.Reset(false);
-        // Set HR to zero and update
-        bpm = 0;
-        controller.Update(Controllers::HeartRateController::States::Running, bpm);
+    Sample sample;
+    while (xQueueReceive(sampleQueue, &sample, 0) == pdTRUE) {
+      if (Foreground()) {
+        lastBpm = Analyze(sample, lastBpm);
+      } else if (backgroundMeasurement) {
+        backgroundBpm = Analyze(sample, backgroundBpm);
       }
+    }
 
-      if (lastBpm == 0 && bpm == 0) {
-        controller.Update(Controllers::HeartRateController::States::NotEnoughData, bpm);
-      }
+    if (backgroundMeasurement) {
+      CompleteBackgroundMeasurement(backgroundBpm);
+    } else {
+      backgroundBpm = 0;
+    }
+    ScheduleBackgroundMeasurement(lastBpm);
+  }
+}
+
+void HeartRateTask::UpdateBackgroundPeriod() {
+  backgroundPeriod = settingsController.GetHeartRateBackgroundInterval() * configTICK_RATE_HZ;
+  nextBackgroundMeasurement = xTaskGetTickCount() + backgroundPeriod;
+}
+
+void HeartRateTask::ScheduleBackgroundMeasurement(int lastBpm) {
+  const TickType_t now = xTaskGetTickCount();
+  if (backgroundPeriod == 0 || backgroundMeasurement || static_cast<int32_t>(now - nextBackgroundMeasurement) < 0) {
+    return;
+  }
+
+  nextBackgroundMeasurement += backgroundPeriod;
+  if (static_cast<int32_t>(now - nextBackgroundMeasurement) >= 0) {
+    nextBackgroundMeasurement = now + backgroundPeriod;
+  }
 
-      if (bpm != 0) {
-        lastBpm = bpm;
-        controller.Update(Controllers::HeartRateController::States::Running, lastBpm);
+  if (Foreground()) {
+    // The sensor is already running
+    if (lastBpm != 0) {
+      controller.Record(lastBpm);
+    }
+    return;
+  }
+  StartMeasurement();
+  backgroundMeasurement = true;
+  backgroundMeasurementStart = now;
+}
+
+void HeartRateTask::CompleteBackgroundMeasurement(int bpm) {
+  const TickType_t elapsed = xTaskGetTickCount() - backgroundMeasurementStart;
+  if (bpm != 0 && elapsed >= backgroundMinDuration) {
+    controller.Record(bpm);
+  } else if (elapsed < backgroundMaxDuration) {
+    return;
+  }
+
+  backgroundMeasurement = false;
+  if (!Foreground()) {
+    StopMeasurement();
+  }
+}
+
+void HeartRateTask::Sampling() {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    while (sampling) {
+      // Absolute deadlines: the period does not drift with the time spent reading the sensor
+      vTaskDelayUntil(&lastWakeTime, samplingPeriod);
+      if (!sampling) {
+        break;
       }
+
+      Sample sample;
+      sample.timestamp = xTaskGetTickCount();
+      sample.hrs = heartRateSensor.ReadHrs();
+      sample.als = heartRateSensor.ReadAls();
+      TRACE_EVENT(HeartRateSample, sample.als, sample.hrs);
+      // If the queue is full, the sample is dropped and Ppg detects the gap from the timestamps
+      xQueueSend(sampleQueue, &sample, 0);
+    }
+  }
+}
+
+int HeartRateTask::Analyze(const Sample& sample, int lastBpm) {
+  const auto timestampMs = static_cast<uint32_t>(static_cast<uint64_t>(sample.timestamp) * 1000 / configTICK_RATE_HZ);
+  uint16_t interval;
+  // The intervals are only valid while the spectral estimator finds a heart rate (skin contact, low noise)
+  if (beatDetector.Process(sample.hrs, timestampMs, interval) && lastBpm != 0 && Foreground()) {
+    TRACE_EVENT(HeartRateBeat, interval, 0);
+    controller.AddBeat(interval);
+  }
+
+  uint32_t hrs;
+  uint32_t als;
+  const bool hrsReady = hrsDecimator.Push(sample.hrs, hrs);
+  const bool alsReady = alsDecimator.Push(sample.als, als);
+  if (!hrsReady || !alsReady) {
+    return lastBpm;
+  }
+
+  // The delay of the decimation filter is constant, Ppg only uses the intervals between the samples
+  int8_t ambient = ppg.Preprocess(hrs, als, timestampMs);
+  int bpm = ppg.HeartRate();
+  TRACE_EVENT(HeartRateBpm, bpm, 0);
+
+  // If ambient light detected or a reset requested (bpm < 0)
+  if (ambient > 0) {
+    // Reset all DAQ buffers
+    ppg.Reset(true);
+    beatDetector.Reset();
+    // Force state to NotEnoughData (below)
+    lastBpm = 0;
+    bpm = 0;
+  } else if (bpm < 0) {
+    // Reset all DAQ buffers except HRS buffer
+    ppg.Reset(false);
+    if (!Foreground()) {
+      return 0;
     }
+    // Set HR to zero and update
+    bpm = 0;
+    controller.Update(Controllers::HeartRateController::States::Running, bpm);
+  }
+
+  if (!Foreground()) {
+    // The controller only reports the measurement requested by the user
+    return (bpm != 0) ? bpm : lastBpm;
+  }
+
+  if (lastBpm == 0 && bpm == 0) {
+    controller.Update(Controllers::HeartRateController::States::NotEnoughData, bpm);
+  }
+
+  if (bpm != 0) {
+    lastBpm = bpm;
+    controller.Update(Controllers::HeartRateController::States::Running, lastBpm);
   }
+  return lastBpm;
 }
 
 void HeartRateTask::PushMessage(HeartRateTask::Messages msg) {
@@ -107,12 +239,21 @@ void HeartRateTask::PushMessage(HeartRateTask::Messages msg) {
 }
 
 void HeartRateTask::StartMeasurement() {
+  heartRateSensor.SetConversion(sensorWaitTime, sensorResolution);
   heartRateSensor.Enable();
   ppg.Reset(true);
+  hrsDecimator.Reset();
+  alsDecimator.Reset();
+  beatDetector.Reset();
+  controller.ResetBeats();
   vTaskDelay(100);
+  xQueueReset(sampleQueue);
+  sampling = true;
+  xTaskNotifyGive(samplingTaskHandle);
 }
 
 void HeartRateTask::StopMeasurement() {
+  sampling = false;
   heartRateSensor.Disable();
   ppg.Reset(true);
   vTaskDelay(100);
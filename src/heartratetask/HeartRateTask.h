@@ -3,39 +3,94 @@
 #include <task.h>
 #include <queue.h>
 #include <components/heartrate/Ppg.h>
+#include <components/heartrate/Decimator.h>
+#include <components/heartrate/BeatDetector.h>
+#include <drivers/Hrs3300.h>
 
 namespace Pinetime {
-  namespace Drivers {
-    class Hrs3300;
-  }
-
   namespace Controllers {
     class HeartRateController;
+    class Settings;
   }
 
   namespace Applications {
     class HeartRateTask {
     public:
-      enum class Messages : uint8_t { GoToSleep, WakeUp, StartMeasurement, StopMeasurement };
+      enum class Messages : uint8_t { GoToSleep, WakeUp, StartMeasurement, StopMeasurement, UpdateBackgroundMeasurement };
       enum class States { Idle, Running };
 
-      explicit HeartRateTask(Drivers::Hrs3300& heartRateSensor, Controllers::HeartRateController& controller);
+      HeartRateTask(Drivers::Hrs3300& heartRateSensor,
+                    Controllers::HeartRateController& controller,
+                    Controllers::Settings& settingsController);
       void Start();
       void Work();
       void PushMessage(Messages msg);
 
     private:
+      struct Sample {
+        TickType_t timestamp;
+        uint32_t hrs;
+        uint32_t als;
+      };
+
       static void Process(void* instance);
+      static void ProcessSampling(void* instance);
+      void Sampling();
       void StartMeasurement();
       void StopMeasurement();
+      int Analyze(const Sample& sample, int lastBpm);
+      void UpdateBackgroundPeriod();
+      void ScheduleBackgroundMeasurement(int lastBpm);
+      void CompleteBackgroundMeasurement(int bpm);
+
+      // The measurement requested by the user runs while the watch is awake
+      bool Foreground() const {
+        return measurementStarted && state == States::Running;
+      }
+
+      // The heart rate is computed from 64 samples at 10Hz (6.4s window, 0.156Hz resolution).
+      // Other configurations must be instantiated in Ppg.cpp.
+      using HeartRatePpg = Controllers::Ppg<10, 64>;
+      // The sensor is read decimationFactor times faster than the analysis rate, the samples are low-pass filtered
+      // before they are decimated so that the noise above the Nyquist frequency of the analysis does not alias into it.
+      static constexpr uint8_t decimationFactor = 2;
+      static constexpr uint16_t acquisitionRate = HeartRatePpg::sampleRate * decimationFactor; // Hz
+      // The sensor must complete a conversion within each acquisition period: 14-bit conversions (~25ms)
+      // and 12.5ms wait time at 20Hz. The decimator adds 1 bit of resolution back.
+      static constexpr Drivers::Hrs3300::WaitTimes sensorWaitTime = Drivers::Hrs3300::WaitTimes::Ms12_5;
+      static constexpr uint8_t sensorResolution = 14;
+
+      // The samples are read by a dedicated task, paced by the tick, so that they are not delayed by the analysis
+      // done by this task (filters and FFT), which runs at a lower priority.
+      static constexpr TickType_t samplingPeriod = pdMS_TO_TICKS(1000 / acquisitionRate);
+      static constexpr uint8_t sampleQueueSize = 8 * decimationFactor;
+
+      // The background measurement turns the sensor on periodically, until the heart rate is stable (the window of
+      // Ppg is full and 2 more spectra are averaged) or for at most 30s if there is no usable signal.
+      static constexpr TickType_t backgroundMinDuration =
+        pdMS_TO_TICKS((HeartRatePpg::dataLength * 1000 / HeartRatePpg::sampleRate) + 3000);
+      static constexpr TickType_t backgroundMaxDuration = pdMS_TO_TICKS(30000);
 
       TaskHandle_t taskHandle;
+      TaskHandle_t samplingTaskHandle;
       QueueHandle_t messageQueue;
+      QueueHandle_t sampleQueue;
       States state = States::Running;
       Drivers::Hrs3300& heartRateSensor;
       Controllers::HeartRateController& controller;
-      Controllers::Ppg ppg;
+      Controllers::Settings& settingsController;
+      HeartRatePpg ppg;
+      Controllers::Decimator<decimationFactor> hrsDecimator;
+      Controllers::Decimator<decimationFactor> alsDecimator;
+      // The beats are detected before the decimation, for a finer time resolution
+      Controllers::BeatDetector<acquisitionRate> beatDetector;
       bool measurementStarted = false;
+      volatile bool sampling = false;
+
+      TickType_t backgroundPeriod = 0; // 0 when disabled
+      TickType_t nextBackgroundMeasurement = 0;
+      TickType_t backgroundMeasurementStart = 0;
+      bool backgroundMeasurement = false;
     };
 
   }
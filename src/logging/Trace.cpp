@@ -0,0 +1,70 @@
+#include "logging/Trace.h"
+
+#ifdef INFINITIME_TRACE
+  #include <atomic>
+  #include <nrf.h>
+  #include <FreeRTOS.h>
+  #include <task.h>
+
+using namespace Pinetime::Logging;
+
+namespace {
+  static_assert((Trace::capacity & (Trace::capacity - 1)) == 0, "The capacity of the trace buffer must be a power of 2");
+
+  Trace::Record records[Trace::capacity];
+
+  // Number of slots reserved by the writers, and number of records completely written
+  std::atomic<uint32_t> head {0};
+  std::atomic<uint32_t> committed {0};
+  std::atomic<bool> paused {false};
+}
+
+void Trace::Init() {
+  // The cycle counter is part of the DWT unit, which is enabled by the debugger only
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void Trace::Add(TraceEvents event, uint16_t arg0, uint32_t arg1) {
+  if (paused.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  // Each writer reserves its own slot: an interrupt that records an event while a task is writing
+  // gets the next one, and no lock is needed.
+  auto& record = records[head.fetch_add(1, std::memory_order_relaxed) & (capacity - 1)];
+  record.tick = NRF_RTC1->COUNTER;
+  record.cycles = DWT->CYCCNT;
+  record.event = static_cast<uint16_t>(event);
+  record.arg0 = arg0;
+  record.arg1 = arg1;
+  committed.fetch_add(1, std::memory_order_release);
+}
+
+void Trace::Pause() {
+  paused = true;
+  // A task preempted while writing a record must be allowed to finish it
+  for (uint8_t retry = 0; retry < 10 && committed.load(std::memory_order_acquire) != head.load(); retry++) {
+    vTaskDelay(1);
+  }
+}
+
+void Trace::Resume() {
+  paused = false;
+}
+
+size_t Trace::Count() {
+  uint32_t total = committed.load(std::memory_order_acquire);
+  return (total < capacity) ? total : capacity;
+}
+
+uint32_t Trace::Total() {
+  return committed.load(std::memory_order_acquire);
+}
+
+const Trace::Record& Trace::Get(size_t index) {
+  uint32_t oldest = committed.load(std::memory_order_acquire) - Count();
+  return records[(oldest + index) & (capacity - 1)];
+}
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Deferred binary trace buffer.
+ *
+ * TRACE_EVENT() stores a fixed size record (timestamps, event id, 2 arguments) in a RAM ring buffer. Nothing is
+ * formatted or sent on the device: the buffer is dumped to a file on demand (see TelemetryService) and decoded on the
+ * host by tools/trace-decode.py. Recording is lock-free and can be done from interrupt handlers.
+ *
+ * Tracing is compiled in only when the firmware is built with -DENABLE_TRACE=1, TRACE_EVENT() is a no-op otherwise.
+ */
+
+#ifdef INFINITIME_TRACE
+  #define TRACE_EVENT(id, arg0, arg1) Pinetime::Logging::Trace::Add(Pinetime::Logging::TraceEvents::id, (arg0), (arg1))
+#else
+  #define TRACE_EVENT(id, arg0, arg1)
+#endif
+
+namespace Pinetime {
+  namespace Logging {
+    // The ids are stored in the trace files: append new events at the end, never reuse a value.
+    // tools/trace-decode.py reads the names from this enum.
+    enum class TraceEvents : uint16_t {
+      SpiChunkSent = 0,      // arg0: remaining bytes (0 when the transfer is complete)
+      DisplayFlushStart = 1, // arg0: first line, arg1: last line of the area
+      DisplayFlushEnd = 2,   // arg0: first line, arg1: last line of the area
+      HeartRateSample = 3,   // arg0: ambient light, arg1: HRS value
+      HeartRateBpm = 4,      // arg0: bpm
+      HeartRateBeat = 5,     // arg0: interval since the previous beat (ms)
+    };
+
+    class Trace {
+    public:
+      struct Record {
+        uint32_t tick;   // RTC1 counter (1024Hz, 24 bits)
+        uint32_t cycles; // CPU cycle counter (64MHz), stopped while the CPU sleeps
+        uint16_t event;
+        uint16_t arg0;
+        uint32_t arg1;
+      };
+
+      static constexpr size_t capacity = 128;
+
+#ifdef INFINITIME_TRACE
+      static void Init();
+      static void Add(TraceEvents event, uint16_t arg0, uint32_t arg1);
+
+      // Stops the recording and waits for the records being written, so the buffer can be read safely
+      static void Pause();
+      static void Resume();
+
+      // Number of records available in the buffer, and total number of records since boot
+      static size_t Count();
+      static uint32_t Total();
+
+      // Index 0 is the oldest record. Only valid while the recording is paused.
+      static const Record& Get(size_t index);
+#else
+      static void Init() {
+      }
+#endif
+    };
+  }
+}
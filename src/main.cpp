@@ -36,6 +36,7 @@
 #include "components/datetime/DateTimeController.h"
 #include "components/heartrate/HeartRateController.h"
 #include "components/fs/FS.h"
+#include "components/timer/TimerWheel.h"
 #include "drivers/Spi.h"
 #include "drivers/SpiMaster.h"
 #include "drivers/SpiNorFlash.h"
@@ -46,6 +47,7 @@
 #include "systemtask/SystemTask.h"
 #include "touchhandler/TouchHandler.h"
 #include "buttonhandler/ButtonHandler.h"
+#include "logging/Trace.h"
 
 #if NRF_LOG_ENABLED
   #include "logging/NrfLogger.h"
@@ -93,20 +95,20 @@ TimerHandle_t debounceChargeTimer;
 Pinetime::Controllers::Battery batteryController;
 Pinetime::Controllers::Ble bleController;
 
-Pinetime::Controllers::HeartRateController heartRateController;
-Pinetime::Applications::HeartRateTask heartRateApp(heartRateSensor, heartRateController);
-
+Pinetime::Controllers::TimerWheel timerWheel;
 Pinetime::Controllers::FS fs {spiNorFlash};
 Pinetime::Controllers::Settings settingsController {fs};
-Pinetime::Controllers::MotorController motorController {};
+Pinetime::Controllers::MotorController motorController {timerWheel};
 
 Pinetime::Controllers::DateTime dateTimeController {settingsController};
+Pinetime::Controllers::HeartRateController heartRateController {dateTimeController, fs};
+Pinetime::Applications::HeartRateTask heartRateApp(heartRateSensor, heartRateController, settingsController);
 Pinetime::Drivers::Watchdog watchdog;
 Pinetime::Controllers::NotificationManager notificationManager;
-Pinetime::Controllers::MotionController motionController;
-Pinetime::Controllers::AlarmController alarmController {dateTimeController};
+Pinetime::Controllers::MotionController motionController {dateTimeController, fs};
+Pinetime::Controllers::AlarmController alarmController {dateTimeController, timerWheel};
 Pinetime::Controllers::TouchHandler touchHandler;
-Pinetime::Controllers::ButtonHandler buttonHandler;
+Pinetime::Controllers::ButtonHandler buttonHandler {timerWheel};
 Pinetime::Controllers::BrightnessController brightnessController {};
 
 Pinetime::Applications::DisplayApp displayApp(lcd,
@@ -123,7 +125,8 @@ Pinetime::Applications::DisplayApp displayApp(lcd,
                                               alarmController,
                                               brightnessController,
                                               touchHandler,
-                                              fs);
+                                              fs,
+                                              timerWheel);
 
 Pinetime::System::SystemTask systemTask(spi,
                                         spiNorFlash,
@@ -144,7 +147,8 @@ Pinetime::System::SystemTask systemTask(spi,
                                         heartRateApp,
                                         fs,
                                         touchHandler,
-                                        buttonHandler);
+                                        buttonHandler,
+                                        timerWheel);
 int mallocFailedCount = 0;
 int stackOverflowCount = 0;
 extern "C" {
@@ -161,9 +165,10 @@ void vApplicationStackOverflowHook(TaskHandle_t /*xTask*/, char* /*pcTaskName*/)
 */
 extern uint32_t __start_noinit_data;
 extern uint32_t __stop_noinit_data;
-static constexpr uint32_t NoInit_MagicValue = 0xDEAD0000;
+static constexpr uint32_t NoInit_MagicValue = 0xDEAD0001;
 uint32_t NoInit_MagicWord __attribute__((section(".noinit")));
 std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> NoInit_BackUpTime __attribute__((section(".noinit")));
+Pinetime::System::SystemMonitor::Summary NoInit_SystemMonitorSummary __attribute__((section(".noinit")));
 
 void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action) {
   if (pin == Pinetime::PinMap::Cst816sIrq) {
@@ -311,6 +316,7 @@ void enable_dcdc_regulator() {
 int main() {
   enable_dcdc_regulator();
   logger.Init();
+  Pinetime::Logging::Trace::Init();
 
   nrf_drv_clock_init();
   nrf_drv_clock_lfclk_request(nullptr);
@@ -343,6 +349,7 @@ int main() {
 
   debounceTimer = xTimerCreate("debounceTimer", 10, pdFALSE, nullptr, DebounceTimerCallback);
   debounceChargeTimer = xTimerCreate("debounceTimerCharge", 200, pdFALSE, nullptr, DebounceTimerChargeCallback);
+  timerWheel.Init();
 
   // retrieve version stored by bootloader
   Pinetime::BootloaderVersion::SetVersion(NRF_TIMER2->CC[0]);
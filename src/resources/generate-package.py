@@ -3,6 +3,8 @@
 import io
 import sys
 import json
+import zlib
+import struct
 import shutil
 import typing
 import os.path
@@ -10,6 +12,34 @@ import argparse
 import subprocess
 from zipfile import ZipFile
 
+MANIFEST_FILENAME = 'resources.idx'
+MANIFEST_PATH = '/resources.idx'
+MANIFEST_MAGIC = b'RIDX'
+MANIFEST_VERSION = 1
+
+def path_hash(path):
+    # FNV-1a, must match ResourceIndex::Hash()
+    h = 0x811c9dc5
+    for b in path.encode():
+        h = ((h ^ b) * 0x01000193) & 0xffffffff
+    return h
+
+def write_manifest(filename, resources):
+    """Writes the index of the resources verified by the firmware (see src/components/fs/ResourceIndex.h)"""
+    hashes = {}
+    with open(filename, 'wb') as fd:
+        fd.write(struct.pack('<4sHH', MANIFEST_MAGIC, MANIFEST_VERSION, len(resources)))
+        for target_path, local_path in resources:
+            h = path_hash(target_path)
+            if h in hashes:
+                sys.exit(f'Error: the paths {hashes[h]} and {target_path} have the same hash.')
+            hashes[h] = target_path
+            with open(local_path, 'rb') as resource:
+                data = resource.read()
+            encoded_path = target_path.encode()
+            fd.write(struct.pack('<IIIB', h, len(data), zlib.crc32(data), len(encoded_path)))
+            fd.write(encoded_path)
+
 def main():
     ap = argparse.ArgumentParser(description='auto generate LVGL font files from fonts')
     ap.add_argument('--config', '-c', type=str, action='append', help='config file to use')
@@ -32,6 +62,7 @@ def main():
 
     zf = ZipFile(args.output, mode='w')
     resource_files = []
+    manifest = []
 
     for config_file in args.config:
         with open(config_file, 'r') as fd:
@@ -49,6 +80,15 @@ def main():
             if not os.path.exists(path):
                 path = os.path.join(os.path.dirname(sys.argv[0]), path)
             zf.write(path)
+            manifest.append((resource['target_path'] + name + '.bin', path))
+
+    # The manifest is the last resource: the firmware verifies the whole package when it is written
+    write_manifest(MANIFEST_FILENAME, manifest)
+    resource_files.append({
+        "filename": MANIFEST_FILENAME,
+        "path": MANIFEST_PATH
+    })
+    zf.write(MANIFEST_FILENAME)
 
     if args.obsolete:
         obsolete_file_path = os.path.join(os.path.dirname(sys.argv[0]), args.obsolete)
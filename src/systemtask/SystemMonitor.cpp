@@ -1,27 +1,93 @@
-#include "systemtask/SystemTask.h"
-#if configUSE_TRACE_FACILITY == 1
-  // FreeRtosMonitor
-  #include <FreeRTOS.h>
-  #include <task.h>
-  #include <nrf_log.h>
+#include "systemtask/SystemMonitor.h"
+#include <algorithm>
+#include <cstring>
+#include <nrf_log.h>
+#include "FreeRTOS/heap_stats.h"
+
+using namespace Pinetime::System;
+
+extern int mallocFailedCount;
+extern int stackOverflowCount;
+extern SystemMonitor::Summary NoInit_SystemMonitorSummary;
+
+void SystemMonitor::Init() {
+  previousRun = NoInit_SystemMonitorSummary;
+  NoInit_SystemMonitorSummary = {};
+  NoInit_SystemMonitorSummary.minFreeStack = UINT16_MAX;
+  Sample();
+}
+
+const SystemMonitor::Summary& SystemMonitor::CurrentRun() const {
+  return NoInit_SystemMonitorSummary;
+}
 
-void Pinetime::System::SystemMonitor::Process() {
+void SystemMonitor::Process() {
   if (xTaskGetTickCount() - lastTick > 10000) {
-    NRF_LOG_INFO("---------------------------------------\nFree heap : %d", xPortGetFreeHeapSize());
-    TaskStatus_t tasksStatus[10];
-    auto nb = uxTaskGetSystemState(tasksStatus, 10, nullptr);
-    for (uint32_t i = 0; i < nb; i++) {
-      NRF_LOG_INFO("Task [%s] - %d", tasksStatus[i].pcTaskName, tasksStatus[i].usStackHighWaterMark);
-      if (tasksStatus[i].usStackHighWaterMark < 20)
-        NRF_LOG_INFO("WARNING!!! Task %s task is nearly full, only %dB available",
-                     tasksStatus[i].pcTaskName,
-                     tasksStatus[i].usStackHighWaterMark * 4);
-    }
-    lastTick = xTaskGetTickCount();
+    Sample();
   }
 }
-#else
-// DummyMonitor
-void Pinetime::System::SystemMonitor::Process() {
-}
+
+void SystemMonitor::Sample() {
+  lastTick = xTaskGetTickCount();
+  freeHeap = xPortGetFreeHeapSize();
+  largestFreeBlock = xPortGetLargestFreeBlockSize();
+
+  auto& summary = NoInit_SystemMonitorSummary;
+  summary.minFreeHeap = xPortGetMinimumEverFreeHeapSize();
+  if (summary.minLargestFreeBlock == 0 || largestFreeBlock < summary.minLargestFreeBlock) {
+    summary.minLargestFreeBlock = largestFreeBlock;
+  }
+  summary.mallocFailures = mallocFailedCount;
+  summary.stackOverflows = stackOverflowCount;
+
+#if configUSE_TRACE_FACILITY == 1
+  TaskStatus_t tasksStatus[maxTasks];
+  uint32_t runTime = 0;
+  const size_t previousNbTasks = nbTasks;
+  nbTasks = uxTaskGetSystemState(tasksStatus, maxTasks, &runTime);
+  std::sort(tasksStatus, tasksStatus + nbTasks, [](const TaskStatus_t& lhs, const TaskStatus_t& rhs) {
+    return lhs.xTaskNumber < rhs.xTaskNumber;
+  });
+
+  // The load is computed on the difference between 2 samples, which is not affected by the wrap around of the counters
+  loadPeriod = runTime - lastRunTime;
+  lastRunTime = runTime;
+
+  NRF_LOG_INFO("---------------------------------------\nFree heap : %d", freeHeap);
+  for (size_t i = 0; i < nbTasks; i++) {
+    auto& task = tasks[i];
+    std::strncpy(task.name, tasksStatus[i].pcTaskName, sizeof(task.name));
+    task.name[sizeof(task.name) - 1] = '\0';
+    task.freeStack = tasksStatus[i].usStackHighWaterMark;
+    task.allocations = ulPortGetTaskAllocationCount(tasksStatus[i].xHandle);
+  #if configGENERATE_RUN_TIME_STATS == 1
+    // Tasks are sorted by number and new tasks get higher numbers: the previous sample of this task, if any, is at
+    // this index or after it
+    uint32_t previousRunTime = tasksStatus[i].ulRunTimeCounter;
+    for (size_t j = i; j < previousNbTasks; j++) {
+      if (tasks[j].number == tasksStatus[i].xTaskNumber) {
+        previousRunTime = tasks[j].runTime;
+        break;
+      }
+    }
+    task.number = tasksStatus[i].xTaskNumber;
+    task.runTime = tasksStatus[i].ulRunTimeCounter;
+    task.cpuLoad = (loadPeriod == 0) ? 0 : static_cast<uint64_t>(task.runTime - previousRunTime) * 1000 / loadPeriod;
+  #endif
+
+    if (task.freeStack < summary.minFreeStack) {
+      summary.minFreeStack = task.freeStack;
+      std::memcpy(summary.minFreeStackTask, task.name, sizeof(summary.minFreeStackTask));
+    }
+
+    NRF_LOG_INFO("Task [%s] - %d - %d allocations - %d/1000 CPU", task.name, task.freeStack, task.allocations, task.cpuLoad);
+    if (task.freeStack < 20) {
+      NRF_LOG_INFO("WARNING!!! Task %s task is nearly full, only %dB available", task.name, task.freeStack * 4);
+    }
+  }
 #endif
+
+#if configGENERATE_RUN_TIME_STATS == 1
+  vPortGetSleepHistogram(sleeps.counts, sleeps.ticks);
+#endif
+}
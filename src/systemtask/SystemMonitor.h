@@ -1,16 +1,90 @@
 #pragma once
 #include <FreeRTOS.h> // declares configUSE_TRACE_FACILITY
 #include <task.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "FreeRTOS/runtime_stats.h"
 
 namespace Pinetime {
   namespace System {
     class SystemMonitor {
     public:
+      static constexpr size_t maxTasks = 10;
+
+      struct TaskUsage {
+        char name[configMAX_TASK_NAME_LEN];
+        uint16_t freeStack; // Minimum amount of stack that remained free, in words
+        uint32_t allocations;
+        uint16_t cpuLoad; // Time spent running during the last sampling period, in per mille
+        uint32_t runTime; // Run time counter value at the last sample
+        UBaseType_t number;
+      };
+
+      struct SleepHistogram {
+        uint32_t counts[portSLEEP_HISTOGRAM_BINS];
+        uint32_t ticks[portSLEEP_HISTOGRAM_BINS];
+      };
+
+      // Worst values seen since boot. The summary of the current run is kept in the .noinit area so that it can
+      // still be read after a reset.
+      struct Summary {
+        uint32_t minFreeHeap;
+        uint32_t minLargestFreeBlock;
+        uint32_t mallocFailures;
+        uint32_t stackOverflows;
+        uint16_t minFreeStack;
+        char minFreeStackTask[configMAX_TASK_NAME_LEN];
+      };
+
+      void Init();
       void Process();
-#if configUSE_TRACE_FACILITY == 1
+
+      uint32_t FreeHeap() const {
+        return freeHeap;
+      }
+
+      uint32_t LargestFreeBlock() const {
+        return largestFreeBlock;
+      }
+
+      const std::array<TaskUsage, maxTasks>& Tasks() const {
+        return tasks;
+      }
+
+      size_t NbTasks() const {
+        return nbTasks;
+      }
+
+      // Length of the period the CPU load of the tasks is computed on, in ticks
+      uint32_t LoadPeriod() const {
+        return loadPeriod;
+      }
+
+      // Tickless idle sleeps since boot, by duration
+      const SleepHistogram& Sleeps() const {
+        return sleeps;
+      }
+
+      const Summary& CurrentRun() const;
+
+      // Summary of the run that ended with the last reset, all zeros if it is not available (power loss)
+      const Summary& PreviousRun() const {
+        return previousRun;
+      }
+
     private:
-      mutable TickType_t lastTick = 0;
-#endif
+      void Sample();
+
+      TickType_t lastTick = 0;
+      uint32_t freeHeap = 0;
+      uint32_t largestFreeBlock = 0;
+      std::array<TaskUsage, maxTasks> tasks {};
+      size_t nbTasks = 0;
+      uint32_t lastRunTime = 0;
+      uint32_t loadPeriod = 0;
+      SleepHistogram sleeps {};
+      Summary previousRun {};
     };
   }
 }
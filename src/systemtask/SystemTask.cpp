@@ -17,6 +17,8 @@
 #include "main.h"
 #include "BootErrors.h"
 
+#include <algorithm>
+#include <array>
 #include <memory>
 
 using namespace Pinetime::System;
@@ -27,8 +29,8 @@ namespace {
   }
 }
 
-void MeasureBatteryTimerCallback(TimerHandle_t xTimer) {
-  auto* sysTask = static_cast<SystemTask*>(pvTimerGetTimerID(xTimer));
+void SystemTask::OnMeasureBatteryTimer(void* context) {
+  auto* sysTask = static_cast<SystemTask*>(context);
   sysTask->PushMessage(Pinetime::System::Messages::MeasureBatteryTimerExpired);
 }
 
@@ -51,7 +53,8 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
                        Pinetime::Applications::HeartRateTask& heartRateApp,
                        Pinetime::Controllers::FS& fs,
                        Pinetime::Controllers::TouchHandler& touchHandler,
-                       Pinetime::Controllers::ButtonHandler& buttonHandler)
+                       Pinetime::Controllers::ButtonHandler& buttonHandler,
+                       Pinetime::Controllers::TimerWheel& timerWheel)
   : spi {spi},
     spiNorFlash {spiNorFlash},
     twiMaster {twiMaster},
@@ -72,6 +75,7 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
     fs {fs},
     touchHandler {touchHandler},
     buttonHandler {buttonHandler},
+    timerWheel {timerWheel},
     nimbleController(*this,
                      bleController,
                      dateTimeController,
@@ -80,7 +84,9 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
                      spiNorFlash,
                      heartRateController,
                      motionController,
-                     fs) {
+                     fs,
+                     timerWheel),
+    measureBatteryTimer {OnMeasureBatteryTimer, this, batteryMeasurementSlack} {
 }
 
 void SystemTask::Start() {
@@ -99,6 +105,8 @@ void SystemTask::Process(void* instance) {
 void SystemTask::Work() {
   BootErrors bootError = BootErrors::None;
 
+  monitor.Init();
+
   watchdog.Setup(7, Drivers::Watchdog::SleepBehaviour::Run, Drivers::Watchdog::HaltBehaviour::Pause);
   watchdog.Start();
   NRF_LOG_INFO("Last reset reason : %s", Pinetime::Drivers::ResetReasonToString(watchdog.GetResetReason()));
@@ -134,6 +142,7 @@ void SystemTask::Work() {
   motionSensor.Init();
   motionController.Init(motionSensor.DeviceType());
   settingsController.Init();
+  heartRateController.Init();
 
   displayApp.Register(this);
   displayApp.Register(&nimbleController.weather());
@@ -175,13 +184,13 @@ void SystemTask::Work() {
 
   batteryController.MeasureVoltage();
 
-  measureBatteryTimer = xTimerCreate("measureBattery", batteryMeasurementPeriod, pdTRUE, this, MeasureBatteryTimerCallback);
-  xTimerStart(measureBatteryTimer, portMAX_DELAY);
+  timerWheel.Start(measureBatteryTimer, batteryMeasurementPeriod, batteryMeasurementPeriod);
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "EndlessLoop"
   while (true) {
     UpdateMotion();
+    SaveHeartRate();
 
     Messages msg;
     if (xQueueReceive(systemTasksMsgQueue, &msg, 100) == pdTRUE) {
@@ -318,12 +327,11 @@ void SystemTask::Work() {
           HandleButtonAction(action);
         } break;
         case Messages::OnDisplayTaskSleeping:
-          if (BootloaderVersion::IsValid()) {
-            // First versions of the bootloader do not expose their version and cannot initialize the SPI NOR FLASH
-            // if it's in sleep mode. Avoid bricked device by disabling sleep mode on these versions.
-            spiNorFlash.Sleep();
+          // The display task does not use the file system anymore, maintain it before the flash sleeps
+          if (fs.MaintenanceDue()) {
+            fs.Maintain();
           }
-          spi.Sleep();
+          SleepFlash();
 
           // Double Tap needs the touch screen to be in normal mode
           if (!settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::DoubleTap)) {
@@ -351,6 +359,12 @@ void SystemTask::Work() {
               displayApp.PushMessage(Pinetime::Applications::Display::Messages::Chime);
             }
           }
+          // While the watch charges, the screen may stay off for hours: maintain the file system while it sleeps
+          if (state == SystemTaskState::Sleeping && batteryController.IsPowerPresent() && fs.MaintenanceDue()) {
+            AccessFlashWhileSleeping([this]() {
+              fs.Maintain();
+            });
+          }
           break;
         case Messages::OnNewHalfHour:
           using Pinetime::Controllers::AlarmController;
@@ -420,17 +434,82 @@ void SystemTask::Work() {
 #pragma clang diagnostic pop
 }
 
+void SystemTask::StreamMotion() {
+  if (!motionSensor.IsFifoEnabled()) {
+    motionSensor.EnableFifo(true);
+    return;
+  }
+
+  // The FIFO is read in small chunks because of the size of the stack. The last sample in the FIFO is taken now,
+  // the time of the others is deduced from the number of samples that follow them.
+  const TickType_t now = xTaskGetTickCount();
+  size_t remaining = motionSensor.FifoLength();
+  std::array<Drivers::Bma421::Sample, 16> samples;
+  while (remaining > 0) {
+    bool overflow;
+    const size_t nbSamples = motionSensor.ReadFifo(samples.data(), std::min(samples.size(), remaining), overflow);
+    if (nbSamples == 0) {
+      break;
+    }
+    remaining -= nbSamples;
+    const TickType_t lastSampleTime = now - remaining * configTICK_RATE_HZ / Drivers::Bma421::sampleRate;
+    motionController.GetService()->OnNewMotionSamples(samples.data(), nbSamples, overflow, lastSampleTime);
+  }
+}
+
+void SystemTask::SaveHeartRate() {
+  // The background measurements continue while the flash sleeps with the system task
+  if (state == SystemTaskState::Running) {
+    if (heartRateController.NbPending() > 0) {
+      heartRateController.Save();
+    }
+  } else if (state == SystemTaskState::Sleeping && heartRateController.NbPending() == Controllers::HeartRateController::maxPending) {
+    AccessFlashWhileSleeping([this]() {
+      heartRateController.Save();
+    });
+  }
+}
+
+void SystemTask::WakeUpFlash() {
+  // The always on display keeps the SPI awake, and the display task may be using it
+  if (!settingsController.GetAlwaysOnDisplay()) {
+    spi.Wakeup();
+  }
+  spiNorFlash.Wakeup();
+}
+
+void SystemTask::SleepFlash() {
+  if (BootloaderVersion::IsValid()) {
+    // First versions of the bootloader do not expose their version and cannot initialize the SPI NOR FLASH
+    // if it's in sleep mode. Avoid bricked device by disabling sleep mode on these versions.
+    spiNorFlash.Sleep();
+  }
+  // The always on display still refreshes the time on the screen every minute
+  if (!settingsController.GetAlwaysOnDisplay()) {
+    spi.Sleep();
+  }
+}
+
 void SystemTask::UpdateMotion() {
   if (state == SystemTaskState::GoingToSleep || state == SystemTaskState::WakingUp) {
     return;
   }
 
+  // In sleep mode, the motion is still polled for the actigraphy
   if (state == SystemTaskState::Sleeping && !(settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
                                               settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake) ||
-                                              motionController.GetService()->IsMotionNotificationSubscribed())) {
+                                              settingsController.GetNotificationStatus() == Controllers::Settings::Notification::Sleep ||
+                                              motionController.GetService()->IsMotionNotificationSubscribed() ||
+                                              motionController.GetService()->IsMotionStreamSubscribed())) {
     return;
   }
 
+  if (motionController.GetService()->IsMotionStreamSubscribed()) {
+    StreamMotion();
+  } else if (motionSensor.IsFifoEnabled()) {
+    motionSensor.EnableFifo(false);
+  }
+
   if (stepCounterMustBeReset) {
     motionSensor.ResetStepCounter();
     stepCounterMustBeReset = false;
@@ -439,6 +518,16 @@ void SystemTask::UpdateMotion() {
   auto motionValues = motionSensor.Process();
 
   motionController.Update(motionValues.x, motionValues.y, motionValues.z, motionValues.steps);
+  // The flash sleeps with the system task
+  auto& actigraphy = motionController.GetActigraphy();
+  if (state == SystemTaskState::Running) {
+    motionController.History().Save();
+    actigraphy.Save();
+  } else if (actigraphy.NbPending() == Controllers::Actigraphy::maxPending) {
+    AccessFlashWhileSleeping([&actigraphy]() {
+      actigraphy.Save();
+    });
+  }
 
   if (settingsController.GetNotificationStatus() != Controllers::Settings::Notification::Sleep) {
     if ((settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) &&
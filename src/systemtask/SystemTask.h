@@ -17,6 +17,7 @@
 #include "components/ble/NotificationManager.h"
 #include "components/alarm/AlarmController.h"
 #include "components/fs/FS.h"
+#include "components/timer/TimerWheel.h"
 #include "touchhandler/TouchHandler.h"
 #include "buttonhandler/ButtonHandler.h"
 #include "buttonhandler/ButtonActions.h"
@@ -72,7 +73,8 @@ namespace Pinetime {
                  Pinetime::Applications::HeartRateTask& heartRateApp,
                  Pinetime::Controllers::FS& fs,
                  Pinetime::Controllers::TouchHandler& touchHandler,
-                 Pinetime::Controllers::ButtonHandler& buttonHandler);
+                 Pinetime::Controllers::ButtonHandler& buttonHandler,
+                 Pinetime::Controllers::TimerWheel& timerWheel);
 
       void Start();
       void PushMessage(Messages msg);
@@ -90,6 +92,10 @@ namespace Pinetime {
         return nimbleController;
       };
 
+      const SystemMonitor& Monitor() const {
+        return monitor;
+      }
+
       bool IsSleeping() const {
         return state == SystemTaskState::Sleeping || state == SystemTaskState::WakingUp;
       }
@@ -120,13 +126,15 @@ namespace Pinetime {
       Pinetime::Controllers::FS& fs;
       Pinetime::Controllers::TouchHandler& touchHandler;
       Pinetime::Controllers::ButtonHandler& buttonHandler;
+      Pinetime::Controllers::TimerWheel& timerWheel;
       Pinetime::Controllers::NimbleController nimbleController;
 
       static void Process(void* instance);
       void Work();
       bool isBleDiscoveryTimerRunning = false;
       uint8_t bleDiscoveryTimer = 0;
-      TimerHandle_t measureBatteryTimer;
+      static void OnMeasureBatteryTimer(void* context);
+      Pinetime::Controllers::TimerWheel::Timer measureBatteryTimer;
       bool doNotGoToSleep = false;
       SystemTaskState state = SystemTaskState::Running;
 
@@ -135,8 +143,20 @@ namespace Pinetime {
 
       void GoToRunning();
       void UpdateMotion();
+      void StreamMotion();
+      void SaveHeartRate();
+      // Wakes the SPI and the flash up while the system task sleeps, calls access() and puts them back to sleep
+      template <typename Access>
+      void AccessFlashWhileSleeping(Access&& access) {
+        WakeUpFlash();
+        access();
+        SleepFlash();
+      }
+      void WakeUpFlash();
+      void SleepFlash();
       bool stepCounterMustBeReset = false;
       static constexpr TickType_t batteryMeasurementPeriod = pdMS_TO_TICKS(10 * 60 * 1000);
+      static constexpr TickType_t batteryMeasurementSlack = pdMS_TO_TICKS(30 * 1000);
 
       SystemMonitor monitor;
     };
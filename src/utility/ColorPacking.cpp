@@ -0,0 +1,33 @@
+#include "utility/ColorPacking.h"
+
+namespace {
+  // RRRRRGGG GGGBBBBB -> 0000RRRR GGGGBBBB
+  inline uint16_t ToRgb444(const uint8_t* pixel) {
+    const uint8_t high = pixel[0];
+    const uint8_t low = pixel[1];
+    return static_cast<uint16_t>(((high & 0xf0u) << 4u) | ((high & 0x07u) << 5u) | ((low & 0x80u) >> 3u) | ((low >> 1u) & 0x0fu));
+  }
+}
+
+size_t Pinetime::Utility::PackRgb444(const uint8_t* src, size_t count, uint8_t* dest) {
+  uint8_t* out = dest;
+  for (; count >= 2; count -= 2) {
+    const uint16_t first = ToRgb444(src);
+    const uint16_t second = ToRgb444(src + 2);
+    out[0] = static_cast<uint8_t>(first >> 4u);
+    out[1] = static_cast<uint8_t>(((first & 0x0fu) << 4u) | (second >> 8u));
+    out[2] = static_cast<uint8_t>(second & 0xffu);
+    src += 4;
+    out += 3;
+  }
+
+  if (count == 1) {
+    // The last nibble is ignored by the display controller when the RAMWR command ends
+    const uint16_t last = ToRgb444(src);
+    out[0] = static_cast<uint8_t>(last >> 4u);
+    out[1] = static_cast<uint8_t>((last & 0x0fu) << 4u);
+    out += 2;
+  }
+
+  return out - dest;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Utility {
+    // Number of bytes needed to send `count` pixels in the 12 bits/pixel format (2 pixels in 3 bytes)
+    constexpr size_t Rgb444Size(size_t count) {
+      return (count * 3 + 1) / 2;
+    }
+
+    // Converts `count` RGB565 pixels stored in big endian (LV_COLOR_16_SWAP) to packed RGB444 as expected by the
+    // ST7789 in 12 bits/pixel mode (COLMOD 0x53). `dest` must be at least Rgb444Size(count) bytes long.
+    // Returns the number of bytes written in `dest`.
+    size_t PackRgb444(const uint8_t* src, size_t count, uint8_t* dest);
+  }
+}
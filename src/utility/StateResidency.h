@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Utility {
+    // Accumulates the time spent in, and the number of entries into, each state of a state machine.
+    // State is an enum whose values are 0..N-1. Time is expressed in the unit of the timestamps given by the caller.
+    template <class State, size_t N>
+    class StateResidency {
+    public:
+      explicit StateResidency(State initialState) : current {initialState} {
+      }
+
+      void Enter(State state, uint32_t now) {
+        durations[Index(current)] += now - since;
+        since = now;
+        if (state != current) {
+          entries[Index(state)]++;
+          current = state;
+        }
+      }
+
+      State Current() const {
+        return current;
+      }
+
+      uint32_t TimeIn(State state, uint32_t now) const {
+        uint32_t duration = durations[Index(state)];
+        if (state == current) {
+          duration += now - since;
+        }
+        return duration;
+      }
+
+      uint32_t Entries(State state) const {
+        return entries[Index(state)];
+      }
+
+    private:
+      static constexpr size_t Index(State state) {
+        return static_cast<size_t>(state);
+      }
+
+      State current;
+      uint32_t since = 0;
+      std::array<uint32_t, N> durations {};
+      std::array<uint32_t, N> entries {};
+    };
+  }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace Pinetime {
+  namespace Utility {
+    /*
+     * String of at most N characters, stored inline and always null terminated: it never allocates memory, and can
+     * be copied and compared without using the heap. Longer strings are truncated.
+     */
+    template <size_t N>
+    class StaticString {
+    public:
+      StaticString() = default;
+
+      explicit StaticString(const char* str) {
+        Assign(str);
+      }
+
+      static constexpr size_t Capacity() {
+        return N;
+      }
+
+      size_t Size() const {
+        return size;
+      }
+
+      bool Empty() const {
+        return size == 0;
+      }
+
+      const char* Data() const {
+        return buffer.data();
+      }
+
+      // Can be written directly, up to Capacity() characters, followed by Resize()
+      char* Data() {
+        return buffer.data();
+      }
+
+      void Resize(size_t newSize) {
+        size = std::min(newSize, N);
+        buffer[size] = '\0';
+      }
+
+      void Assign(std::string_view str) {
+        const size_t length = std::min(str.size(), N);
+        std::memcpy(buffer.data(), str.data(), length);
+        Resize(length);
+      }
+
+      operator std::string_view() const {
+        return {buffer.data(), size};
+      }
+
+      bool operator==(const StaticString& other) const {
+        return std::string_view(*this) == std::string_view(other);
+      }
+
+      bool operator==(std::string_view other) const {
+        return std::string_view(*this) == other;
+      }
+
+    private:
+      std::array<char, N + 1> buffer {};
+      size_t size = 0;
+    };
+  }
+}
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+
+# Builds the host checks of tools/host-checks with the host compiler and runs them. Each check is compiled with the
+# firmware sources it tests; the FreeRTOS functions they call are replaced by the stubs of tools/host-checks/stubs.
+# A check whose sources include a submodule that is not checked out is skipped.
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+from collections import namedtuple
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), '..'))
+
+# sources and include directories are relative to the root of the repository
+Check = namedtuple('Check', 'name sources includes submodules flags', defaults=((), (), ()))
+
+FS_SOURCES = ['tools/host-checks/fs-latency.cpp', 'src/components/fs/FS.cpp', 'src/components/fs/ResourceIndex.cpp',
+              'src/libs/littlefs/lfs.c', 'src/libs/littlefs/lfs_util.c']
+# The first mount of the blank flash fails and is logged by littlefs
+FS_FLAGS = ['-DLFS_NO_DEBUG', '-DLFS_NO_WARN', '-DLFS_NO_ERROR']
+
+CHECKS = [
+    Check('color-packing', ['tools/host-checks/color-packing.cpp', 'src/utility/ColorPacking.cpp']),
+    Check('heap-replay',
+          ['tools/host-checks/heap-replay.cpp', 'src/FreeRTOS/heap_4_infinitime.c', 'src/FreeRTOS/heap_pools.c']),
+    Check('heap-replay-no-pools', ['tools/host-checks/heap-replay.cpp', 'src/FreeRTOS/heap_4_infinitime.c'],
+          flags=['-DconfigUSE_HEAP_POOLS=0']),
+    Check('timer-wheel', ['tools/host-checks/timer-wheel.cpp', 'src/components/timer/TimerWheel.cpp']),
+    # Ppg.cpp is included by the benchmark, which instantiates the configurations that the firmware does not use
+    Check('ppg-benchmark', ['tools/host-checks/ppg-benchmark.cpp'], submodules=['src/libs/arduinoFFT']),
+    Check('fs-latency', FS_SOURCES, ['src/libs'], ['src/libs/littlefs'], FS_FLAGS),
+    Check('fs-latency-lookahead-16', FS_SOURCES, ['src/libs'], ['src/libs/littlefs'],
+          FS_FLAGS + ['-DINFINITIME_FS_LOOKAHEAD_SIZE=16']),
+    Check('fs-latency-prog-256', FS_SOURCES, ['src/libs'], ['src/libs/littlefs'],
+          FS_FLAGS + ['-DINFINITIME_FS_PROG_SIZE=256']),
+]
+
+INCLUDES = ['tools/host-checks/stubs', 'src']
+# Built with every check
+STUBS = ['tools/host-checks/stubs/FreeRTOS.c']
+
+
+def checked_out(submodule):
+    path = os.path.join(ROOT, submodule)
+    return os.path.isdir(path) and len(os.listdir(path)) > 0
+
+
+def build(check, output, cc, cxx):
+    """Compiles the sources of the check, returns the path of the executable"""
+    includes = ['-I' + os.path.join(ROOT, path) for path in list(check.includes) + INCLUDES]
+    objects = []
+    for source in list(check.sources) + STUBS:
+        obj = os.path.join(output, check.name + '-' + os.path.basename(source) + '.o')
+        if source.endswith('.c'):
+            command = [cc, '-std=c11']
+        else:
+            command = [cxx, '-std=c++20']
+        command += ['-O2', '-g', '-Wall', '-c', os.path.join(ROOT, source), '-o', obj] + includes + list(check.flags)
+        subprocess.run(command, check=True)
+        objects.append(obj)
+    executable = os.path.join(output, check.name)
+    subprocess.run([cxx, '-o', executable] + objects + ['-lm'], check=True)
+    return executable
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Builds and runs the host checks')
+    parser.add_argument('checks', nargs='*', help='names of the checks to run (all by default)')
+    parser.add_argument('--list', action='store_true', help='lists the checks')
+    parser.add_argument('-o', '--output', help='directory of the executables (kept after the run)')
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--cxx', default=os.environ.get('CXX', 'c++'))
+    args = parser.parse_args()
+
+    if args.list:
+        for check in CHECKS:
+            print(check.name)
+        return
+
+    names = {check.name for check in CHECKS}
+    unknown = [name for name in args.checks if name not in names]
+    if unknown:
+        sys.exit('Unknown checks: ' + ', '.join(unknown))
+    selected = [check for check in CHECKS if not args.checks or check.name in args.checks]
+
+    with tempfile.TemporaryDirectory() as temporary:
+        output = args.output or temporary
+        os.makedirs(output, exist_ok=True)
+        failed = []
+        for check in selected:
+            missing = [submodule for submodule in check.submodules if not checked_out(submodule)]
+            if missing:
+                print(f'{check.name}: skipped, {", ".join(missing)} not checked out')
+                continue
+            print(f'{check.name}:', flush=True)
+            try:
+                executable = build(check, output, args.cc, args.cxx)
+                subprocess.run([executable], check=True, cwd=ROOT)
+            except subprocess.CalledProcessError:
+                failed.append(check.name)
+                print(f'{check.name}: FAILED')
+        if failed:
+            sys.exit('Failed: ' + ', '.join(failed))
+
+
+if __name__ == '__main__':
+    main()
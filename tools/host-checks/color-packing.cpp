@@ -0,0 +1,99 @@
+// Compares PackRgb444() (src/utility/ColorPacking.cpp) with a reference conversion for all the RGB565 values, as
+// first and second pixel of a pair and as the last pixel of an odd strip. Run with tools/host-checks.py.
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "utility/ColorPacking.h"
+
+using Pinetime::Utility::PackRgb444;
+using Pinetime::Utility::Rgb444Size;
+
+namespace {
+  int errors = 0;
+
+  // Keeps the 4 most significant bits of each component
+  uint16_t Reference(uint16_t rgb565) {
+    const uint16_t red = rgb565 >> 11;
+    const uint16_t green = (rgb565 >> 5) & 0x3f;
+    const uint16_t blue = rgb565 & 0x1f;
+    return static_cast<uint16_t>(((red >> 1) << 8) | ((green >> 2) << 4) | (blue >> 1));
+  }
+
+  // LVGL stores the pixels in big endian (LV_COLOR_16_SWAP)
+  void Store(uint8_t* dest, uint16_t rgb565) {
+    dest[0] = static_cast<uint8_t>(rgb565 >> 8);
+    dest[1] = static_cast<uint8_t>(rgb565 & 0xff);
+  }
+
+  // 2 pixels in 3 bytes, most significant nibble first: RRRRGGGG BBBBRRRR GGGGBBBB
+  uint16_t Unpack(const uint8_t* packed, size_t index) {
+    const uint8_t* pair = packed + (index / 2) * 3;
+    if (index % 2 == 0) {
+      return static_cast<uint16_t>((pair[0] << 4) | (pair[1] >> 4));
+    }
+    return static_cast<uint16_t>(((pair[1] & 0x0f) << 8) | pair[2]);
+  }
+
+  void Check(const std::vector<uint16_t>& pixels) {
+    std::vector<uint8_t> src(pixels.size() * 2);
+    for (size_t i = 0; i < pixels.size(); i++) {
+      Store(&src[i * 2], pixels[i]);
+    }
+    // The guard bytes detect writes past Rgb444Size()
+    std::vector<uint8_t> dest(Rgb444Size(pixels.size()) + 4, 0xa5);
+    const size_t size = PackRgb444(src.data(), pixels.size(), dest.data());
+    if (size != Rgb444Size(pixels.size())) {
+      std::printf("  %zu pixels: %zu bytes written, expected %zu\n", pixels.size(), size, Rgb444Size(pixels.size()));
+      errors++;
+      return;
+    }
+    for (size_t i = size; i < dest.size(); i++) {
+      if (dest[i] != 0xa5) {
+        std::printf("  %zu pixels: byte %zu written past the end\n", pixels.size(), i);
+        errors++;
+        return;
+      }
+    }
+    for (size_t i = 0; i < pixels.size(); i++) {
+      const uint16_t packed = Unpack(dest.data(), i);
+      if (packed != Reference(pixels[i])) {
+        if (errors++ < 10) {
+          std::printf("  pixel %zu/%zu: 0x%04x packed as 0x%03x, expected 0x%03x\n",
+                      i,
+                      pixels.size(),
+                      pixels[i],
+                      packed,
+                      Reference(pixels[i]));
+        }
+      }
+    }
+  }
+}
+
+int main() {
+  // Each value as first and second pixel of a pair, next to a value whose bits are all different
+  std::vector<uint16_t> pairs;
+  for (uint32_t value = 0; value <= 0xffff; value++) {
+    pairs.push_back(static_cast<uint16_t>(value));
+    pairs.push_back(static_cast<uint16_t>(~value));
+  }
+  Check(pairs);
+
+  // Each value as the last pixel of an odd strip
+  for (uint32_t value = 0; value <= 0xffff; value++) {
+    Check({static_cast<uint16_t>(~value), static_cast<uint16_t>(value), static_cast<uint16_t>(value)});
+  }
+
+  // Short strips
+  for (size_t count = 0; count < 8; count++) {
+    Check(std::vector<uint16_t>(count, 0xf81f));
+  }
+
+  if (errors > 0) {
+    std::printf("%d errors\n", errors);
+    return EXIT_FAILURE;
+  }
+  std::printf("65536 values OK\n");
+  return EXIT_SUCCESS;
+}
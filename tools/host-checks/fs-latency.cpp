@@ -0,0 +1,379 @@
+// Replays the file system workload of the watch on a simulated flash and reports the latency of the writes of the
+// applications, without and with the maintenance of the file system while the watch is idle (FS::Maintain()). Run
+// with tools/host-checks.py, which builds it with the default configuration of FS (fs-latency) and with other sizes
+// of the lookahead buffer and of the program operations (fs-latency-lookahead-16, fs-latency-prog-256). It needs the
+// littlefs submodule.
+//
+// The flash is simulated in RAM with the typical timings of the external flash: page programs of 0.7ms, sector
+// erases of 50ms, and the transfers at 8MHz. The simulated clock moves the tick count, so FS measures the duration
+// of its operations like on the watch. The simulator fails the check if a program sets bits that are not erased.
+//
+// The workload first installs resources on a third of the file system. Then, for 3 simulated days, the applications
+// append records to history files every minute, rotate them, save the settings and set attributes. The screen turns
+// off every 10 minutes: this is when the system task runs the maintenance if it is due. The content of all the
+// files is verified at the end.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "components/fs/FS.h"
+#include "task.h"
+
+using Pinetime::Controllers::FS;
+using Pinetime::Drivers::SpiNorFlash;
+
+namespace {
+  constexpr size_t flashSize = 4 * 1024 * 1024;
+  constexpr size_t flashPageSize = 256;
+  constexpr size_t flashSectorSize = 4096;
+  // Typical timings (us)
+  constexpr uint64_t pageProgramTime = 700;
+  constexpr uint64_t sectorEraseTime = 50000;
+  // Command and address
+  constexpr uint64_t commandTime = 4;
+
+  std::vector<uint8_t> flash(flashSize, 0xff);
+  uint64_t nowUs = 0;
+  int errors = 0;
+
+  void Error(const char* message) {
+    if (errors++ < 10) {
+      std::printf("  %s\n", message);
+    }
+  }
+
+  void Advance(uint64_t us) {
+    nowUs += us;
+    xStubTickCount = static_cast<TickType_t>(nowUs * configTICK_RATE_HZ / 1000000);
+  }
+
+  bool InFlash(uint32_t address, size_t size) {
+    if (address > flashSize || size > flashSize - address) {
+      Error("flash access out of range");
+      return false;
+    }
+    return true;
+  }
+}
+
+// The driver of the external flash, simulated in RAM: the transfers take 1us per byte (8MHz SPI)
+namespace Pinetime {
+  namespace Drivers {
+    class Spi {};
+  }
+}
+
+SpiNorFlash::SpiNorFlash(Pinetime::Drivers::Spi& spi) : spi {spi} {
+}
+
+void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
+  if (!InFlash(address, size)) {
+    return;
+  }
+  std::memcpy(buffer, &flash[address], size);
+  Advance(commandTime + size);
+}
+
+void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
+  if (!InFlash(address, size)) {
+    return;
+  }
+  // The driver programs each page separately and waits for the end of the program
+  while (size > 0) {
+    const size_t chunk = std::min(size, flashPageSize - (address % flashPageSize));
+    for (size_t i = 0; i < chunk; i++) {
+      if ((flash[address + i] & buffer[i]) != buffer[i]) {
+        Error("program of bits that are not erased");
+      }
+      flash[address + i] &= buffer[i];
+    }
+    Advance(commandTime + chunk + pageProgramTime);
+    address += chunk;
+    buffer += chunk;
+    size -= chunk;
+  }
+}
+
+void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
+  if (sectorAddress % flashSectorSize != 0) {
+    Error("erase of an unaligned sector");
+    return;
+  }
+  if (!InFlash(sectorAddress, flashSectorSize)) {
+    return;
+  }
+  std::fill_n(&flash[sectorAddress], flashSectorSize, 0xff);
+  Advance(commandTime + sectorEraseTime);
+}
+
+bool SpiNorFlash::ProgramFailed() {
+  return false;
+}
+
+bool SpiNorFlash::EraseFailed() {
+  return false;
+}
+
+namespace {
+  constexpr uint32_t minutes = 3 * 24 * 60;
+  constexpr size_t nbResources = 40;
+  constexpr size_t historyMaxSize = 32 * 1024;
+  constexpr size_t settingsSize = 256;
+
+  // The content of the files is generated from their name and the offset, so that it can be verified
+  uint8_t Pattern(const std::string& path, size_t offset) {
+    uint32_t hash = 2166136261u;
+    for (const char c : path) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return static_cast<uint8_t>(hash + offset * 7 + (offset >> 8));
+  }
+
+  struct History {
+    std::string path;
+    std::string oldPath;
+    size_t recordSize;
+    // Size of the current file, bytes written since the creation of the history (the pattern continues across the
+    // rotations)
+    size_t size = 0;
+    size_t written = 0;
+    size_t oldSize = 0;
+    size_t oldWritten = 0;
+  };
+
+  class Workload {
+  public:
+    Workload(FS& fs, bool maintain) : fs {fs}, maintain {maintain} {
+    }
+
+    void Run();
+
+  private:
+    FS& fs;
+    const bool maintain;
+    std::mt19937 random {1};
+    std::vector<size_t> resourceSizes;
+    std::vector<History> histories {{"/hr.dat", "/hr.old", 8}, {"/act.dat", "/act.old", 16}};
+    uint32_t settingsVersion = 0;
+    // Duration of the operations of the applications (us)
+    std::vector<uint64_t> latencies;
+    std::vector<uint64_t> maintenances;
+
+    bool Write(const std::string& path, int flags, size_t patternOffset, size_t size);
+    void Append(History& history);
+    void SaveSettings();
+    void SetAttribute();
+    template <typename Operation>
+    void Measure(Operation&& operation);
+    void Verify(const std::string& path, const std::string& patternName, size_t patternOffset, size_t size);
+    void Report() const;
+  };
+
+  bool Workload::Write(const std::string& path, int flags, size_t patternOffset, size_t size) {
+    lfs_file_t file;
+    if (fs.FileOpen(&file, path.c_str(), flags) != LFS_ERR_OK) {
+      Error(("cannot open " + path).c_str());
+      return false;
+    }
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+      data[i] = Pattern(path, patternOffset + i);
+    }
+    // The resources are written in chunks, like the BLE FS API does
+    bool result = true;
+    for (size_t offset = 0; offset < size && result; offset += 512) {
+      const auto chunk = static_cast<uint32_t>(std::min<size_t>(512, size - offset));
+      result = fs.FileWrite(&file, &data[offset], chunk) == static_cast<int>(chunk);
+    }
+    if (fs.FileClose(&file) != LFS_ERR_OK || !result) {
+      Error(("cannot write " + path).c_str());
+      return false;
+    }
+    return true;
+  }
+
+  template <typename Operation>
+  void Workload::Measure(Operation&& operation) {
+    const uint64_t start = nowUs;
+    operation();
+    latencies.push_back(nowUs - start);
+  }
+
+  void Workload::Append(History& history) {
+    if (history.size + history.recordSize > historyMaxSize) {
+      // The oldest records are dropped
+      Measure([this, &history]() {
+        if (history.oldSize > 0 && fs.FileDelete(history.oldPath.c_str()) != LFS_ERR_OK) {
+          Error(("cannot delete " + history.oldPath).c_str());
+        }
+        if (fs.Rename(history.path.c_str(), history.oldPath.c_str()) != LFS_ERR_OK) {
+          Error(("cannot rename " + history.path).c_str());
+        }
+      });
+      history.oldSize = history.size;
+      history.oldWritten = history.written - history.size;
+      history.size = 0;
+    }
+    Measure([this, &history]() {
+      Write(history.path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND, history.written, history.recordSize);
+    });
+    history.size += history.recordSize;
+    history.written += history.recordSize;
+  }
+
+  void Workload::SaveSettings() {
+    settingsVersion++;
+    Measure([this]() {
+      Write("/settings.dat", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, settingsVersion, settingsSize);
+    });
+  }
+
+  void Workload::SetAttribute() {
+    Measure([this]() {
+      if (fs.SetAttribute("/settings.dat", 1, &settingsVersion, sizeof(settingsVersion)) != LFS_ERR_OK) {
+        Error("cannot set the attribute");
+      }
+    });
+  }
+
+  // The content of a renamed file keeps the pattern of its original name
+  void Workload::Verify(const std::string& path, const std::string& patternName, size_t patternOffset, size_t size) {
+    lfs_info info;
+    if (fs.Stat(path.c_str(), &info) != LFS_ERR_OK || info.size != size) {
+      Error(("wrong size of " + path).c_str());
+      return;
+    }
+    lfs_file_t file;
+    if (fs.FileOpen(&file, path.c_str(), LFS_O_RDONLY) != LFS_ERR_OK) {
+      Error(("cannot open " + path).c_str());
+      return;
+    }
+    std::vector<uint8_t> data(size);
+    if (fs.FileRead(&file, data.data(), static_cast<uint32_t>(size)) != static_cast<int>(size)) {
+      Error(("cannot read " + path).c_str());
+    } else {
+      for (size_t i = 0; i < size; i++) {
+        if (data[i] != Pattern(patternName, patternOffset + i)) {
+          Error(("wrong content of " + path).c_str());
+          break;
+        }
+      }
+    }
+    fs.FileClose(&file);
+  }
+
+  void Workload::Run() {
+    fs.Init();
+    if (fs.DirCreate("/res") != LFS_ERR_OK) {
+      Error("cannot create /res");
+    }
+    for (size_t i = 0; i < nbResources; i++) {
+      resourceSizes.push_back(std::uniform_int_distribution<size_t>(20 * 1024, 60 * 1024)(random));
+      Write("/res/" + std::to_string(i) + ".bin", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, 0, resourceSizes.back());
+    }
+    SaveSettings();
+    latencies.clear();
+    fs.ResetStatistics();
+
+    for (uint32_t minute = 0; minute < minutes && errors == 0; minute++) {
+      for (auto& history : histories) {
+        Append(history);
+      }
+      if (std::uniform_int_distribution<int>(0, 99)(random) < 20) {
+        SaveSettings();
+      }
+      if (minute % 30 == 0) {
+        SetAttribute();
+      }
+      // The screen turns off
+      if (minute % 10 == 9 && maintain && fs.MaintenanceDue()) {
+        const uint64_t start = nowUs;
+        fs.Maintain();
+        maintenances.push_back(nowUs - start);
+        if (fs.GetStatistics().lastMaintenanceResult != LFS_ERR_OK) {
+          Error("the maintenance failed");
+        }
+      }
+      Advance(60 * 1000000 - (nowUs % (60 * 1000000)));
+    }
+
+    for (size_t i = 0; i < nbResources; i++) {
+      const std::string path = "/res/" + std::to_string(i) + ".bin";
+      Verify(path, path, 0, resourceSizes[i]);
+    }
+    for (const auto& history : histories) {
+      Verify(history.path, history.path, history.written - history.size, history.size);
+      if (history.oldSize > 0) {
+        Verify(history.oldPath, history.path, history.oldWritten, history.oldSize);
+      }
+    }
+    Verify("/settings.dat", "/settings.dat", settingsVersion, settingsSize);
+    Report();
+  }
+
+  // In ms
+  double Percentile(const std::vector<uint64_t>& sorted, unsigned perMille) {
+    if (sorted.empty()) {
+      return 0.0;
+    }
+    return static_cast<double>(sorted[std::min(sorted.size() - 1, sorted.size() * perMille / 1000)]) / 1000.0;
+  }
+
+  void Workload::Report() const {
+    std::vector<uint64_t> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end());
+    const auto& statistics = fs.GetStatistics();
+    std::printf("  %s maintenance: %zu operations, latency p50 %.1fms, p90 %.1fms, p99 %.1fms, p99.9 %.1fms, max %.1fms\n",
+                maintain ? "with" : "without",
+                sorted.size(),
+                Percentile(sorted, 500),
+                Percentile(sorted, 900),
+                Percentile(sorted, 990),
+                Percentile(sorted, 999),
+                Percentile(sorted, 1000));
+    std::printf("    %lu programs, %lu erases, %lu FS writes (max %lums)\n",
+                static_cast<unsigned long>(statistics.programs),
+                static_cast<unsigned long>(statistics.erases),
+                static_cast<unsigned long>(statistics.writes),
+                static_cast<unsigned long>(statistics.maxWriteLatency));
+    if (!maintenances.empty()) {
+      uint64_t total = 0;
+      for (const auto duration : maintenances) {
+        total += duration;
+      }
+      std::printf("    %zu maintenances, %.1fms on average, max %.1fms\n",
+                  maintenances.size(),
+                  total / 1000.0 / maintenances.size(),
+                  *std::max_element(maintenances.begin(), maintenances.end()) / 1000.0);
+    }
+  }
+}
+
+int main() {
+  std::printf("  lookahead %zu bytes, prog size %zu bytes, littlefs %x.%x\n",
+              FS::lookaheadSize,
+              FS::progSize,
+              LFS_VERSION_MAJOR,
+              LFS_VERSION_MINOR);
+  Pinetime::Drivers::Spi spi;
+  SpiNorFlash flashDriver {spi};
+  for (const bool maintain : {false, true}) {
+    std::fill(flash.begin(), flash.end(), 0xff);
+    nowUs = 0;
+    Advance(0);
+    auto fs = std::make_unique<FS>(flashDriver);
+    Workload workload {*fs, maintain};
+    workload.Run();
+  }
+
+  if (errors > 0) {
+    std::printf("  %d errors\n", errors);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,241 @@
+// Replays an allocation trace on the heap of the firmware (src/FreeRTOS/heap_4_infinitime.c and heap_pools.c), checks
+// the blocks it returns, and reports the fragmentation of the first-fit heap. Run with tools/host-checks.py, which
+// builds it with and without the pools (heap-replay and heap-replay-no-pools).
+//
+// The trace is a text file, one operation per line:
+//   + <id> <size>   allocation
+//   - <id>          release
+//   =               an app was closed: the fragmentation is sampled
+// Lines starting with # are ignored. Without a trace, a deterministic workload that opens and closes apps is generated:
+// most objects are small and released when their app is closed, some of them outlive it (notifications, caches).
+//
+// The blocks of the first-fit heap have a 16 bytes header on a 64-bit host instead of 8 bytes on the watch, so the
+// heap fills up a bit faster than on the watch.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "FreeRTOS/heap_stats.h"
+#if configUSE_HEAP_POOLS == 1
+  #include "FreeRTOS/heap_pools.h"
+#endif
+
+extern "C" {
+void* pvPortMalloc(size_t xWantedSize);
+void vPortFree(void* pv);
+size_t xPortGetFreeHeapSize(void);
+size_t xPortGetMinimumEverFreeHeapSize(void);
+}
+
+namespace {
+  struct Operation {
+    enum class Type { Allocate, Release, AppClosed } type;
+    uint32_t id;
+    size_t size;
+  };
+
+  struct Block {
+    uint8_t* address;
+    size_t size;
+  };
+
+  std::vector<Operation> ReadTrace(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+      std::fprintf(stderr, "Cannot open %s\n", path);
+      std::exit(EXIT_FAILURE);
+    }
+    std::vector<Operation> operations;
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++) {
+      std::istringstream fields(line);
+      std::string type;
+      Operation operation {};
+      if (!(fields >> type) || type[0] == '#') {
+        continue;
+      }
+      if (type == "+" && (fields >> operation.id >> operation.size)) {
+        operation.type = Operation::Type::Allocate;
+      } else if (type == "-" && (fields >> operation.id)) {
+        operation.type = Operation::Type::Release;
+      } else if (type == "=") {
+        operation.type = Operation::Type::AppClosed;
+      } else {
+        std::fprintf(stderr, "%s:%d: invalid operation\n", path, number);
+        std::exit(EXIT_FAILURE);
+      }
+      operations.push_back(operation);
+    }
+    return operations;
+  }
+
+  std::vector<Operation> GenerateTrace() {
+    std::mt19937 random(1);
+    auto uniform = [&random](size_t min, size_t max) {
+      return std::uniform_int_distribution<size_t>(min, max)(random);
+    };
+
+    std::vector<Operation> operations;
+    uint32_t nextId = 0;
+    // Objects that outlive their app, and the app after which they are released
+    std::multimap<int, uint32_t> longLived;
+    for (int app = 0; app < 500; app++) {
+      std::vector<uint32_t> objects;
+      const size_t nbObjects = uniform(40, 160);
+      for (size_t i = 0; i < nbObjects; i++) {
+        const size_t kind = uniform(0, 99);
+        size_t size;
+        if (kind < 70) {
+          size = uniform(8, 64); // objects, styles, small strings
+        } else if (kind < 95) {
+          size = uniform(65, 400); // texts, tables
+        } else {
+          size = uniform(401, 2500); // buffers
+        }
+        operations.push_back({Operation::Type::Allocate, nextId, size});
+        if (uniform(0, 99) < 5) {
+          longLived.emplace(app + static_cast<int>(uniform(1, 5)), nextId);
+        } else {
+          objects.push_back(nextId);
+        }
+        nextId++;
+      }
+
+      // The objects are mostly deleted in the order they were created (children after their parent)
+      for (size_t i = 0; i + 1 < objects.size(); i++) {
+        if (uniform(0, 99) < 20) {
+          std::swap(objects[i], objects[i + 1]);
+        }
+      }
+      for (const auto id : objects) {
+        operations.push_back({Operation::Type::Release, id, 0});
+      }
+      for (auto it = longLived.begin(); it != longLived.end() && it->first <= app;) {
+        operations.push_back({Operation::Type::Release, it->second, 0});
+        it = longLived.erase(it);
+      }
+      operations.push_back({Operation::Type::AppClosed, 0, 0});
+    }
+    for (const auto& object : longLived) {
+      operations.push_back({Operation::Type::Release, object.second, 0});
+    }
+    return operations;
+  }
+
+  uint8_t Pattern(uint32_t id, size_t offset) {
+    return static_cast<uint8_t>(id * 31 + offset);
+  }
+}
+
+int main(int argc, char** argv) {
+  const auto operations = (argc > 1) ? ReadTrace(argv[1]) : GenerateTrace();
+
+  // The heap is initialized by the first allocation
+  vPortFree(pvPortMalloc(1));
+  const size_t initialFree = xPortGetFreeHeapSize();
+
+  std::map<uint32_t, Block> live;
+  std::map<uint8_t*, size_t> ranges;
+  size_t errors = 0;
+  size_t allocations = 0;
+  size_t failures = 0;
+  size_t apps = 0;
+  size_t minLargestBlock = SIZE_MAX;
+  size_t maxFreeBlocks = 0;
+
+  for (const auto& operation : operations) {
+    switch (operation.type) {
+      case Operation::Type::Allocate: {
+        if (live.count(operation.id) != 0) {
+          std::fprintf(stderr, "Block %u allocated twice\n", operation.id);
+          return EXIT_FAILURE;
+        }
+        auto* address = static_cast<uint8_t*>(pvPortMalloc(operation.size));
+        allocations++;
+        if (address == nullptr) {
+          failures++;
+          break;
+        }
+        if ((reinterpret_cast<uintptr_t>(address) & portBYTE_ALIGNMENT_MASK) != 0) {
+          std::fprintf(stderr, "Block %u is not aligned\n", operation.id);
+          errors++;
+        }
+        // The block must not overlap the neighbouring live blocks
+        auto next = ranges.lower_bound(address);
+        if ((next != ranges.end() && next->first < address + operation.size) ||
+            (next != ranges.begin() && std::prev(next)->first + std::prev(next)->second > address)) {
+          std::fprintf(stderr, "Block %u overlaps another block\n", operation.id);
+          errors++;
+        }
+        for (size_t i = 0; i < operation.size; i++) {
+          address[i] = Pattern(operation.id, i);
+        }
+        live[operation.id] = {address, operation.size};
+        ranges[address] = operation.size;
+      } break;
+
+      case Operation::Type::Release: {
+        auto block = live.find(operation.id);
+        if (block == live.end()) {
+          // Its allocation failed
+          break;
+        }
+        for (size_t i = 0; i < block->second.size; i++) {
+          if (block->second.address[i] != Pattern(operation.id, i)) {
+            std::fprintf(stderr, "Block %u was overwritten\n", operation.id);
+            errors++;
+            break;
+          }
+        }
+        ranges.erase(block->second.address);
+        vPortFree(block->second.address);
+        live.erase(block);
+      } break;
+
+      case Operation::Type::AppClosed:
+        apps++;
+        minLargestBlock = std::min(minLargestBlock, xPortGetLargestFreeBlockSize());
+        maxFreeBlocks = std::max(maxFreeBlocks, xPortGetNumberOfFreeBlocks());
+        break;
+    }
+  }
+
+  for (const auto& block : live) {
+    vPortFree(block.second.address);
+  }
+  if (xPortGetFreeHeapSize() != initialFree) {
+    std::fprintf(stderr, "%zu bytes free at the end, %zu at the beginning\n", xPortGetFreeHeapSize(), initialFree);
+    errors++;
+  }
+
+  std::printf("  %zu allocations, %zu failed, %zu apps closed\n", allocations, failures, apps);
+  std::printf("  free heap: %zu bytes, minimum %zu\n", initialFree, xPortGetMinimumEverFreeHeapSize());
+  if (apps > 0) {
+    std::printf("  after closing an app: largest free block >= %zu bytes, free blocks <= %zu\n", minLargestBlock, maxFreeBlocks);
+  }
+#if configUSE_HEAP_POOLS == 1
+  HeapPoolStats_t pools[heapPOOLS_CLASS_COUNT];
+  vHeapPoolsGetStats(pools);
+  for (const auto& pool : pools) {
+    std::printf("  pool %2u: %5lu allocations, peak %2u/%-2u, %lu overflows\n",
+                pool.usBlockSize,
+                static_cast<unsigned long>(pool.ulAllocations),
+                pool.usPeak,
+                pool.usBlockCount,
+                static_cast<unsigned long>(pool.ulOverflows));
+  }
+#endif
+
+  if (errors > 0 || failures > 0) {
+    std::printf("  %zu errors\n", errors + failures);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,241 @@
+// Measures the accuracy and the CPU time of the heart rate estimation (src/components/heartrate/Ppg.cpp) for several
+// configurations of Ppg<SampleRate, Length>, on synthetic PPG signals or on a recorded trace. Run with
+// tools/host-checks.py, it needs the arduinoFFT submodule.
+//
+// The samples are given to the estimators like HeartRateTask does: read at 20Hz on the 1024Hz tick (51 ticks, the
+// actual rate is 20.08Hz), decimated by Decimator when the analysis rate is 10Hz. The synthetic signals are a pulse
+// wave with a slowly varying rate, a respiration baseline, a drift and white noise. Ppg rejects the spectra whose
+// DC component exceeds an absolute threshold: how often a heart rate is found depends on the amplitude of the
+// signal, not only on its quality. The firmware configuration must report the heart rate of the signals with low
+// noise between 60 and 150 BPM within 5 BPM on average, the other results are only reported.
+//
+// A recorded trace is given as argument with its reference heart rate (BPM), one sample per line, read at 20Hz:
+//   <time (ms)> <hrs> <als>
+// The CPU time is measured on the host: it only compares the configurations with each other.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "components/heartrate/Decimator.h"
+// The templates are instantiated here for the configurations that the firmware does not use
+#include "components/heartrate/Ppg.cpp"
+
+using Pinetime::Controllers::Decimator;
+using Pinetime::Controllers::Ppg;
+
+namespace {
+  constexpr uint32_t acquisitionRate = 20;
+  // pdMS_TO_TICKS(1000 / acquisitionRate) at 1024Hz
+  constexpr uint32_t samplingPeriodTicks = 51;
+  constexpr float twoPi = 6.28318530718f;
+
+  struct Sample {
+    uint32_t timestampMs;
+    uint32_t hrs;
+    uint32_t als;
+  };
+
+  struct Signal {
+    std::string name;
+    float bpm;
+    // The firmware configuration must measure it
+    bool required;
+    std::vector<Sample> samples;
+  };
+
+  struct Result {
+    // Seconds until the first heart rate
+    float latency = -1.0f;
+    // Analysed samples since the first heart rate, and those for which a heart rate was reported
+    size_t estimates = 0;
+    size_t valid = 0;
+    float absoluteError = 0.0f;
+    float maxError = 0.0f;
+    // Host CPU time per second of signal
+    float cpuUs = 0.0f;
+
+    float MeanError() const {
+      return (valid > 0) ? absoluteError / static_cast<float>(valid) : 0.0f;
+    }
+
+    float ValidRatio() const {
+      return (estimates > 0) ? static_cast<float>(valid) / static_cast<float>(estimates) : 0.0f;
+    }
+  };
+
+  Signal Synthetic(float bpm, float noise, bool required, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::normal_distribution<float> gaussian(0.0f, 1.0f);
+    std::uniform_real_distribution<float> uniform(0.0f, twoPi);
+
+    Signal signal {"synthetic " + std::to_string(static_cast<int>(bpm)) + " BPM, noise " +
+                     std::to_string(static_cast<int>(noise)),
+                   bpm,
+                   required,
+                   {}};
+    const float variabilityPhase = uniform(random);
+    const float respirationPhase = uniform(random);
+    float phase = uniform(random);
+    float previousTime = 0.0f;
+    // 60s of signal
+    for (uint32_t tick = 0; tick < 60 * 1024; tick += samplingPeriodTicks) {
+      const float time = static_cast<float>(tick) / 1024.0f;
+      // The heart rate varies by +-2% around its mean
+      const float rate = bpm / 60.0f * (1.0f + 0.02f * std::sin(0.1f * time + variabilityPhase));
+      phase += twoPi * rate * (time - previousTime);
+      previousTime = time;
+      const float pulse = 20.0f * (std::sin(phase) + 0.4f * std::sin(2.0f * phase + 0.5f));
+      const float respiration = 30.0f * std::sin(twoPi * 0.25f * time + respirationPhase);
+      const float drift = 1.0f * time;
+      const float value = 8000.0f + pulse + respiration + drift + noise * gaussian(random);
+      signal.samples.push_back({static_cast<uint32_t>(static_cast<uint64_t>(tick) * 1000 / 1024),
+                                static_cast<uint32_t>(std::max(value, 0.0f)),
+                                100});
+    }
+    return signal;
+  }
+
+  Signal ReadTrace(const char* path, float bpm) {
+    std::ifstream file(path);
+    if (!file) {
+      std::fprintf(stderr, "Cannot open %s\n", path);
+      std::exit(EXIT_FAILURE);
+    }
+    Signal signal {path, bpm, false, {}};
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++) {
+      std::istringstream fields(line);
+      Sample sample {};
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      if (!(fields >> sample.timestampMs >> sample.hrs >> sample.als)) {
+        std::fprintf(stderr, "%s:%d: invalid sample\n", path, number);
+        std::exit(EXIT_FAILURE);
+      }
+      signal.samples.push_back(sample);
+    }
+    return signal;
+  }
+
+  // Same processing as HeartRateTask::Analyze()
+  template <uint8_t SampleRate, uint16_t Length>
+  Result Run(const Signal& signal) {
+    static_assert(acquisitionRate % SampleRate == 0, "The analysis rate must divide the acquisition rate");
+    constexpr uint8_t factor = acquisitionRate / SampleRate;
+    Ppg<SampleRate, Length> ppg;
+    Decimator<factor> hrsDecimator;
+    Decimator<factor> alsDecimator;
+    Result result;
+
+    // The heart rate reported by HeartRateTask: 0 if it is not known
+    int reported = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& sample : signal.samples) {
+      uint32_t hrs;
+      uint32_t als;
+      const bool hrsReady = hrsDecimator.Push(sample.hrs, hrs);
+      const bool alsReady = alsDecimator.Push(sample.als, als);
+      if (!hrsReady || !alsReady) {
+        continue;
+      }
+      const int8_t ambient = ppg.Preprocess(hrs, als, sample.timestampMs);
+      const int bpm = ppg.HeartRate();
+      if (ambient > 0) {
+        ppg.Reset(true);
+        reported = 0;
+      } else if (bpm < 0) {
+        ppg.Reset(false);
+        reported = 0;
+      } else if (bpm > 0) {
+        reported = bpm;
+      }
+
+      // The window must be full before the first estimate
+      if (result.latency < 0.0f && reported > 0) {
+        result.latency = static_cast<float>(sample.timestampMs - signal.samples.front().timestampMs) / 1000.0f;
+      }
+      if (result.latency >= 0.0f) {
+        result.estimates++;
+        if (reported > 0) {
+          const float error = std::abs(static_cast<float>(reported) - signal.bpm);
+          result.valid++;
+          result.absoluteError += error;
+          result.maxError = std::max(result.maxError, error);
+        }
+      }
+    }
+    const auto duration = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start);
+    const float seconds =
+      static_cast<float>(signal.samples.back().timestampMs - signal.samples.front().timestampMs) / 1000.0f;
+    result.cpuUs = duration.count() / seconds;
+    return result;
+  }
+
+  struct Configuration {
+    const char* name;
+    Result (*run)(const Signal&);
+    // The configuration of HeartRateTask
+    bool firmware;
+  };
+
+  const Configuration configurations[] = {
+    {"Ppg<10, 64>", Run<10, 64>, true},
+    {"Ppg<10, 128>", Run<10, 128>, false},
+    {"Ppg<20, 128>", Run<20, 128>, false},
+    {"Ppg<20, 256>", Run<20, 256>, false},
+  };
+}
+
+int main(int argc, char** argv) {
+  std::vector<Signal> signals;
+  if (argc > 2) {
+    signals.push_back(ReadTrace(argv[1], std::strtof(argv[2], nullptr)));
+  } else if (argc > 1) {
+    std::fprintf(stderr, "Usage: %s [<trace> <reference BPM>]\n", argv[0]);
+    return EXIT_FAILURE;
+  } else {
+    uint32_t seed = 1;
+    for (const float bpm : {45.0f, 60.0f, 75.0f, 90.0f, 120.0f, 150.0f, 180.0f}) {
+      signals.push_back(Synthetic(bpm, 2.0f, bpm >= 60.0f && bpm <= 150.0f, seed++));
+      signals.push_back(Synthetic(bpm, 15.0f, false, seed++));
+    }
+  }
+
+  int errors = 0;
+  for (const auto& signal : signals) {
+    std::printf("  %s:\n", signal.name.c_str());
+    for (const auto& configuration : configurations) {
+      const Result result = configuration.run(signal);
+      if (result.latency < 0.0f) {
+        std::printf("    %-12s: no heart rate, %6.0f us/s\n", configuration.name, result.cpuUs);
+      } else {
+        std::printf("    %-12s: first after %4.1fs, %3.0f%% valid, error %4.1f BPM (max %4.1f), %6.0f us/s\n",
+                    configuration.name,
+                    result.latency,
+                    result.ValidRatio() * 100.0f,
+                    result.MeanError(),
+                    result.maxError,
+                    result.cpuUs);
+      }
+      if (configuration.firmware && signal.required &&
+          (result.latency < 0.0f || result.MeanError() > 5.0f)) {
+        std::printf("    the heart rate of the firmware configuration is wrong\n");
+        errors++;
+      }
+    }
+  }
+
+  if (errors > 0) {
+    std::printf("  %d errors\n", errors);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,5 @@
+#include "FreeRTOS.h"
+#include "task.h"
+
+TickType_t xStubTickCount = 0;
+TaskHandle_t xStubCurrentTask = NULL;
@@ -0,0 +1,47 @@
+#pragma once
+
+/*
+ * Host replacement of the FreeRTOS headers for tools/host-checks: the configuration of src/FreeRTOSConfig.h that the
+ * checked modules use. The checks run in a single thread: nothing is preempted, the checks that need the time or
+ * several tasks simulate them.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef configTOTAL_HEAP_SIZE
+  #define configTOTAL_HEAP_SIZE (1024 * 40)
+#endif
+#ifndef configUSE_HEAP_POOLS
+  #define configUSE_HEAP_POOLS 1
+#endif
+#ifndef configUSE_HEAP_ARENA
+  #define configUSE_HEAP_ARENA 0
+#endif
+#define configSUPPORT_DYNAMIC_ALLOCATION  1
+#define configAPPLICATION_ALLOCATED_HEAP  0
+#define configUSE_MALLOC_FAILED_HOOK      0
+#define configASSERT(x)                   assert(x)
+#define configTICK_RATE_HZ                1024
+
+#define portBYTE_ALIGNMENT      8
+#define portBYTE_ALIGNMENT_MASK 0x0007
+
+#define mtCOVERAGE_TEST_MARKER()
+#define traceMALLOC(pvAddress, uiSize)
+#define traceFREE(pvAddress, uiSize)
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t) 0)
+#define pdTRUE  ((BaseType_t) 1)
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+
+#define portMAX_DELAY ((TickType_t) 0xffffffffUL)
+
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t) (((TickType_t) (xTimeInMs) * (TickType_t) configTICK_RATE_HZ) / (TickType_t) 1000))
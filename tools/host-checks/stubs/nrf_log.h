@@ -0,0 +1,8 @@
+#pragma once
+
+/* Host replacement of the logs of the nRF5 SDK: the logs are dropped */
+
+#define NRF_LOG_ERROR(...)
+#define NRF_LOG_WARNING(...)
+#define NRF_LOG_INFO(...)
+#define NRF_LOG_DEBUG(...)
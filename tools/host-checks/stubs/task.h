@@ -0,0 +1,39 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void* TaskHandle_t;
+
+#define taskSCHEDULER_NOT_STARTED ((BaseType_t) 1)
+#define taskSCHEDULER_RUNNING     ((BaseType_t) 2)
+
+/* The checks that simulate the time and several tasks set these variables (see FreeRTOS.c) */
+extern TickType_t xStubTickCount;
+extern TaskHandle_t xStubCurrentTask;
+
+static inline void vTaskSuspendAll(void) {
+}
+
+static inline BaseType_t xTaskResumeAll(void) {
+  return pdFALSE;
+}
+
+static inline BaseType_t xTaskGetSchedulerState(void) {
+  return (xStubCurrentTask != NULL) ? taskSCHEDULER_RUNNING : taskSCHEDULER_NOT_STARTED;
+}
+
+static inline TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return xStubCurrentTask;
+}
+
+static inline TickType_t xTaskGetTickCount(void) {
+  return xStubTickCount;
+}
+
+#ifdef __cplusplus
+}
+#endif
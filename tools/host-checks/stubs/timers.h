@@ -0,0 +1,26 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Implemented by the checks that use software timers */
+typedef struct tmrTimerControl* TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t xTimer);
+
+TimerHandle_t xTimerCreate(const char* pcTimerName,
+                           TickType_t xTimerPeriodInTicks,
+                           UBaseType_t uxAutoReload,
+                           void* pvTimerID,
+                           TimerCallbackFunction_t pxCallbackFunction);
+BaseType_t xTimerStop(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t xTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait);
+void* pvTimerGetTimerID(TimerHandle_t xTimer);
+TaskHandle_t xTimerGetTimerDaemonTaskHandle(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,483 @@
+// Checks the timer wheel (src/components/timer/TimerWheel.cpp) against a brute-force model, with a simulated clock.
+// Run with tools/host-checks.py.
+//
+// - The wheel alone: random timers are inserted and removed while the time moves forward by random steps (beyond the
+//   range of the last level, and across the wrap-around of the tick counter). After each step, the expired timers
+//   must be exactly the ones whose deadline is reached, and NextDeadline() must return the earliest deadline.
+// - The wheel on a simulated FreeRTOS timer and timer task: the timers are started and stopped by a task and by the
+//   callbacks, each callback must be called at the deadline of its timer.
+// - The same with a crowded queue of the timer task: the commands sent without waiting fail at random. The callbacks
+//   can be late but must not be early or lost, and the timer task must never wait for its own queue.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+#include "components/timer/TimerWheel.h"
+
+using Pinetime::Controllers::TimerWheel;
+
+namespace {
+  std::mt19937 random(1);
+  int errors = 0;
+
+  void Error(const char* message, TickType_t now) {
+    if (errors++ < 10) {
+      std::printf("  %u: %s\n", now, message);
+    }
+  }
+
+  uint32_t Uniform(uint32_t min, uint32_t max) {
+    return std::uniform_int_distribution<uint32_t>(min, max)(random);
+  }
+
+  bool Chance(uint32_t percent) {
+    return Uniform(0, 99) < percent;
+  }
+
+  // Mostly short delays, some beyond the range of the last level of the wheel (65536 ticks)
+  TickType_t RandomDelay() {
+    const uint32_t kind = Uniform(0, 99);
+    if (kind < 60) {
+      return Uniform(0, 40);
+    }
+    if (kind < 95) {
+      return Uniform(41, 5000);
+    }
+    return Uniform(5001, 300000);
+  }
+
+  bool Before(TickType_t a, TickType_t b) {
+    return static_cast<int32_t>(a - b) < 0;
+  }
+
+  // Specification of the slack: the deadline is the expiry rounded up to a multiple of the largest power of 2 that
+  // does not delay it by more than slack ticks
+  TickType_t Deadline(TickType_t expiry, TickType_t slack) {
+    TickType_t alignment = 1;
+    while (alignment * 2 <= slack + 1) {
+      alignment *= 2;
+    }
+    return (expiry + alignment - 1) / alignment * alignment;
+  }
+
+  constexpr TickType_t slacks[] = {0, 0, 1, 3, 15, 100, 1023, 5000};
+  constexpr size_t nbTimers = 64;
+
+  struct Entry {
+    Entry(TimerWheel::Callback callback, TickType_t slack) : timer {callback, this, slack}, slack {slack} {
+    }
+
+    void Start(TickType_t now, TickType_t delay, TickType_t timerPeriod) {
+      active = true;
+      period = timerPeriod;
+      expiry = now + std::max<TickType_t>(delay, 1);
+      deadline = Deadline(expiry, slack);
+    }
+
+    // The timer expired at now
+    void Expire(TickType_t now) {
+      if (period == 0) {
+        active = false;
+        return;
+      }
+      // The periods missed are skipped
+      expiry += period;
+      if (!Before(now, expiry)) {
+        expiry = now + period;
+      }
+      deadline = Deadline(expiry, slack);
+    }
+
+    TimerWheel::Timer timer;
+    const TickType_t slack;
+    bool active = false;
+    TickType_t expiry = 0;
+    TickType_t deadline = 0;
+    TickType_t period = 0;
+  };
+
+  std::vector<std::unique_ptr<Entry>> CreateEntries(TimerWheel::Callback callback) {
+    std::vector<std::unique_ptr<Entry>> entries;
+    for (size_t i = 0; i < nbTimers; i++) {
+      entries.push_back(std::make_unique<Entry>(callback, slacks[i % (sizeof(slacks) / sizeof(slacks[0]))]));
+    }
+    return entries;
+  }
+
+  void CheckWheel(TickType_t start) {
+    TimerWheel wheel;
+    auto entries = CreateEntries(nullptr);
+    std::map<const TimerWheel::Timer*, Entry*> entryOf;
+    for (auto& entry : entries) {
+      entryOf[&entry->timer] = entry.get();
+    }
+
+    TickType_t now = start;
+    size_t expirations = 0;
+    for (size_t step = 0; step < 200000 && errors == 0; step++) {
+      now += Chance(98) ? Uniform(0, 20) : Uniform(21, 200000);
+
+      for (uint32_t i = Uniform(0, 3); i > 0; i--) {
+        auto& entry = *entries[Uniform(0, nbTimers - 1)];
+        if (Chance(75)) {
+          const TickType_t delay = RandomDelay();
+          const TickType_t period = Chance(30) ? RandomDelay() + 1 : 0;
+          wheel.Insert(entry.timer, now, delay, period);
+          entry.Start(now, delay, period);
+        } else {
+          wheel.Remove(entry.timer);
+          entry.active = false;
+        }
+      }
+
+      wheel.Advance(now);
+      std::set<Entry*> expired;
+      while (auto* timer = wheel.PopExpired()) {
+        auto* entry = entryOf[timer];
+        if (!expired.insert(entry).second) {
+          Error("timer expired twice", now);
+        }
+      }
+      for (auto& entry : entries) {
+        const bool due = entry->active && !Before(now, entry->deadline);
+        if (due != (expired.count(entry.get()) != 0)) {
+          Error(due ? "timer not expired at its deadline" : "timer expired before its deadline", now);
+        }
+        if (due) {
+          entry->Expire(now);
+          expirations++;
+        }
+        if (wheel.IsActive(entry->timer) != entry->active) {
+          Error("wrong state", now);
+        }
+      }
+
+      bool found = false;
+      TickType_t earliest = 0;
+      for (const auto& entry : entries) {
+        if (entry->active && (!found || Before(entry->deadline, earliest))) {
+          earliest = entry->deadline;
+          found = true;
+        }
+      }
+      TickType_t deadline = 0;
+      if (wheel.NextDeadline(deadline) != found || (found && deadline != earliest)) {
+        Error("wrong next deadline", now);
+      }
+    }
+    std::printf("  wheel from tick %u: %zu expirations\n", start, expirations);
+  }
+
+  // Simulation of the FreeRTOS timer and of the timer task
+
+  struct Command {
+    bool stop;
+    TickType_t period;
+    bool other; // Command of another timer
+  };
+
+  int timerTask;
+  int applicationTask;
+  TaskHandle_t timerTaskHandle = &timerTask;
+  TaskHandle_t applicationTaskHandle = &applicationTask;
+
+  struct Simulation {
+    tmrTimerControl* timer = nullptr;
+    std::deque<Command> queue;
+    size_t queueLength = 10;
+    size_t failedCommands = 0;
+
+    void ProcessCommands();
+    bool Send(const Command& command, TickType_t ticksToWait);
+    void RunDaemon();
+  } simulation;
+}
+
+struct tmrTimerControl {
+  TickType_t period;
+  bool autoReload;
+  bool active;
+  TickType_t expiry;
+  void* id;
+  TimerCallbackFunction_t callback;
+};
+
+namespace {
+  void Simulation::ProcessCommands() {
+    while (!queue.empty()) {
+      const Command command = queue.front();
+      queue.pop_front();
+      if (command.other) {
+        continue;
+      }
+      if (command.stop) {
+        timer->active = false;
+      } else {
+        timer->period = command.period;
+        timer->active = true;
+        timer->expiry = xStubTickCount + command.period;
+      }
+    }
+  }
+
+  bool Simulation::Send(const Command& command, TickType_t ticksToWait) {
+    if (xStubCurrentTask == timerTaskHandle && ticksToWait != 0) {
+      Error("the timer task waits for its own queue", xStubTickCount);
+    }
+    if (queue.size() >= queueLength) {
+      if (ticksToWait == 0 || xStubCurrentTask == timerTaskHandle) {
+        failedCommands++;
+        return false;
+      }
+      // The task waits, the timer task runs and empties its queue
+      const TaskHandle_t task = xStubCurrentTask;
+      xStubCurrentTask = timerTaskHandle;
+      ProcessCommands();
+      xStubCurrentTask = task;
+    }
+    queue.push_back(command);
+    return true;
+  }
+
+  // The timer task calls the callback of the expired timer and processes its queue
+  void Simulation::RunDaemon() {
+    const TaskHandle_t task = xStubCurrentTask;
+    xStubCurrentTask = timerTaskHandle;
+    ProcessCommands();
+    while (timer->active && !Before(xStubTickCount, timer->expiry)) {
+      if (timer->autoReload) {
+        timer->expiry += timer->period;
+      } else {
+        timer->active = false;
+      }
+      timer->callback(timer);
+      ProcessCommands();
+    }
+    xStubCurrentTask = task;
+  }
+}
+
+extern "C" {
+TimerHandle_t xTimerCreate(const char*, TickType_t period, UBaseType_t autoReload, void* id, TimerCallbackFunction_t callback) {
+  simulation.timer = new tmrTimerControl {period, autoReload == pdTRUE, false, 0, id, callback};
+  return simulation.timer;
+}
+
+BaseType_t xTimerStop(TimerHandle_t, TickType_t ticksToWait) {
+  return simulation.Send({true, 0, false}, ticksToWait) ? pdPASS : pdFAIL;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t, TickType_t period, TickType_t ticksToWait) {
+  return simulation.Send({false, period, false}, ticksToWait) ? pdPASS : pdFAIL;
+}
+
+void* pvTimerGetTimerID(TimerHandle_t timer) {
+  return timer->id;
+}
+
+TaskHandle_t xTimerGetTimerDaemonTaskHandle() {
+  return timerTaskHandle;
+}
+}
+
+namespace {
+  TimerWheel wheel;
+  std::vector<std::unique_ptr<Entry>> entries;
+  // Other timers fill the queue of the timer task
+  bool crowded = false;
+  // The callbacks can be late
+  bool lateAllowed = false;
+  size_t callbacks = 0;
+  TickType_t maxLateness = 0;
+
+  void FillQueue() {
+    while (simulation.queue.size() < simulation.queueLength) {
+      simulation.queue.push_back({false, 0, true});
+    }
+  }
+
+  // Starts or stops a random timer
+  void RandomAction() {
+    auto& entry = *entries[Uniform(0, nbTimers - 1)];
+    if (Chance(75)) {
+      const TickType_t delay = RandomDelay();
+      const TickType_t period = Chance(30) ? RandomDelay() + 1 : 0;
+      wheel.Start(entry.timer, delay, period);
+      entry.Start(xStubTickCount, delay, period);
+    } else {
+      wheel.Stop(entry.timer);
+      entry.active = false;
+    }
+  }
+
+  void OnExpired(void* context) {
+    auto& entry = *static_cast<Entry*>(context);
+    const TickType_t now = xStubTickCount;
+    callbacks++;
+    if (!entry.active) {
+      Error("callback of a stopped timer", now);
+      return;
+    }
+    if (Before(now, entry.expiry)) {
+      Error("callback before the expiry", now);
+    } else if (now != entry.deadline) {
+      if (!lateAllowed) {
+        Error("callback after the deadline", now);
+      }
+      maxLateness = std::max<TickType_t>(maxLateness, now - entry.deadline);
+    }
+    entry.Expire(now);
+
+    // The callbacks start and stop timers, and other timers fill the queue while the timer task runs
+    if (Chance(20)) {
+      RandomAction();
+    }
+    if (crowded && Chance(30)) {
+      FillQueue();
+    }
+  }
+
+  // The timer task calls the callbacks until the given tick
+  void RunUntil(TickType_t end) {
+    simulation.RunDaemon();
+    while (simulation.timer->active && Before(simulation.timer->expiry, end)) {
+      xStubTickCount = simulation.timer->expiry;
+      simulation.RunDaemon();
+    }
+    xStubTickCount = end;
+    simulation.RunDaemon();
+  }
+
+  // Checks that the callbacks due at the current tick were called
+  void CheckCalled() {
+    if (lateAllowed) {
+      return;
+    }
+    for (const auto& entry : entries) {
+      if (entry->active && !Before(xStubTickCount, entry->deadline)) {
+        Error("callback not called at the deadline", xStubTickCount);
+      }
+    }
+  }
+
+  void CheckTimerTask(TickType_t start, bool crowdedQueue) {
+    xStubTickCount = start;
+    xStubCurrentTask = applicationTaskHandle;
+    crowded = crowdedQueue;
+    lateAllowed = crowdedQueue;
+    callbacks = 0;
+    maxLateness = 0;
+    simulation.failedCommands = 0;
+    const uint32_t wakeups = wheel.Wakeups();
+
+    TickType_t nextAction = xStubTickCount;
+    for (size_t step = 0; step < 20000 && errors == 0;) {
+      // Jump to the next action or expiry of the FreeRTOS timer
+      TickType_t next = nextAction;
+      if (simulation.timer->active && Before(simulation.timer->expiry, next)) {
+        next = simulation.timer->expiry;
+      }
+      xStubTickCount = next;
+      simulation.RunDaemon();
+      CheckCalled();
+
+      if (xStubTickCount == nextAction) {
+        if (crowded && Chance(10)) {
+          FillQueue();
+        }
+        RandomAction();
+        // The timer task runs when the task waits
+        simulation.RunDaemon();
+        CheckCalled();
+        nextAction = xStubTickCount + (Chance(90) ? Uniform(1, 50) : Uniform(51, 5000));
+        step++;
+      }
+    }
+
+    // Once the queue is not crowded anymore, the late timers must catch up (beyond the longest delay and slack)
+    crowded = false;
+    RunUntil(xStubTickCount + 310000);
+    for (const auto& entry : entries) {
+      if (entry->active && !Before(xStubTickCount, entry->deadline)) {
+        Error("timer lost", xStubTickCount);
+      }
+    }
+
+    std::printf("  timer task from tick %u%s: %zu callbacks, %u wakeups, %zu failed commands, lateness <= %u ticks\n",
+                start,
+                crowdedQueue ? ", crowded queue" : "",
+                callbacks,
+                wheel.Wakeups() - wakeups,
+                simulation.failedCommands,
+                maxLateness);
+
+    for (auto& entry : entries) {
+      wheel.Stop(entry->timer);
+      entry->active = false;
+    }
+    simulation.RunDaemon();
+  }
+
+  Entry* started;
+
+  void OnStarted(void* context) {
+    static_cast<Entry*>(context)->Expire(xStubTickCount);
+  }
+
+  void OnStarting(void* context) {
+    static_cast<Entry*>(context)->Expire(xStubTickCount);
+    // Other timers fill the queue while the timer task runs: it cannot reprogram the FreeRTOS timer
+    FillQueue();
+    wheel.Start(started->timer, 10);
+    started->Start(xStubTickCount, 10, 0);
+  }
+
+  // A command that cannot be queued is retried: by the task that started the timer, or by the timer task
+  void CheckRetries() {
+    Entry starting {OnStarting, 0};
+    Entry timer {OnStarted, 0};
+    started = &timer;
+    lateAllowed = true;
+    simulation.failedCommands = 0;
+
+    FillQueue();
+    wheel.Start(timer.timer, 10);
+    timer.Start(xStubTickCount, 10, 0);
+    RunUntil(xStubTickCount + 1000);
+    if (timer.active) {
+      Error("timer started with a full queue lost", xStubTickCount);
+    }
+
+    wheel.Start(starting.timer, 100);
+    starting.Start(xStubTickCount, 100, 0);
+    RunUntil(xStubTickCount + 1000);
+    if (timer.active) {
+      Error("timer started by a callback with a full queue lost", xStubTickCount);
+    }
+    std::printf("  retries: %zu failed commands\n", simulation.failedCommands);
+  }
+}
+
+int main() {
+  CheckWheel(0);
+  CheckWheel(0xfff00000);
+
+  wheel.Init();
+  entries = CreateEntries(OnExpired);
+  CheckTimerTask(0, false);
+  CheckTimerTask(0xfff00000, false);
+  CheckTimerTask(0, true);
+  CheckRetries();
+
+  if (errors > 0) {
+    std::printf("  %d errors\n", errors);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
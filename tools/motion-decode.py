@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+
+# Decodes the notifications of the motion stream characteristic (see src/components/ble/MotionService.h and
+# doc/MotionService.md) into timestamped samples, and reports the lost notifications and samples.
+# The input contains one notification per line, in hexadecimal (spaces, ':' and '-' are ignored), as logged by most
+# BLE tools. --self-test checks the decoder with generated notifications.
+
+import argparse
+import csv
+import re
+import struct
+import sys
+
+HEADER = struct.Struct('<HIHBB')
+SAMPLE = struct.Struct('<hhh')
+FLAG_SAMPLES_LOST = 0x01
+TICK_RATE = 1024
+TIME_WRAP = 1 << 32
+SEQUENCE_WRAP = 1 << 16
+ONE_G = 1024
+
+
+def parse_notification(data):
+    """Returns (sequence, time in ticks, sample rate, samples lost before, [(x, y, z)])"""
+    sequence, time, rate, count, flags = HEADER.unpack_from(data)
+    if len(data) != HEADER.size + count * SAMPLE.size or rate == 0:
+        raise ValueError(f'invalid notification of {len(data)} bytes')
+    samples = [SAMPLE.unpack_from(data, HEADER.size + i * SAMPLE.size) for i in range(count)]
+    return sequence, time, rate, bool(flags & FLAG_SAMPLES_LOST), samples
+
+
+def decode(notifications):
+    """Returns the samples [(time in s, x, y, z)] and the statistics of the stream"""
+    samples = []
+    stats = {'notifications': 0, 'lost_notifications': 0, 'overflows': 0, 'invalid': 0}
+    previous_sequence = None
+    wraps = 0
+    previous_time = None
+    for data in notifications:
+        try:
+            sequence, time, rate, lost, values = parse_notification(data)
+        except (ValueError, struct.error):
+            stats['invalid'] += 1
+            continue
+        stats['notifications'] += 1
+        if previous_sequence is not None and sequence != 0:
+            stats['lost_notifications'] += (sequence - previous_sequence - 1) % SEQUENCE_WRAP
+        previous_sequence = sequence
+        if lost:
+            stats['overflows'] += 1
+        # The time wraps around after ~48 days
+        if previous_time is not None and time < previous_time and previous_time - time > TIME_WRAP // 2:
+            wraps += 1
+        previous_time = time
+        start = (time + wraps * TIME_WRAP) / TICK_RATE
+        samples.extend((start + i / rate, *value) for i, value in enumerate(values))
+    stats['samples'] = len(samples)
+    return samples, stats
+
+
+def read_notifications(path):
+    with open(path) as f:
+        for line in f:
+            digits = re.sub(r'[\s:\-]', '', line)
+            if digits:
+                yield bytes.fromhex(digits)
+
+
+def encode(sequence, time, rate, lost, values):
+    header = HEADER.pack(sequence, time, rate, len(values), FLAG_SAMPLES_LOST if lost else 0)
+    return header + b''.join(SAMPLE.pack(*value) for value in values)
+
+
+def self_test():
+    rate = 100
+    values = [(i, -i, ONE_G) for i in range(120)]
+    notifications = [
+        encode(0, 1000, rate, False, values[0:40]),
+        encode(1, 1000 + 40 * TICK_RATE // rate, rate, False, values[40:80]),
+        # The notification 2 is lost, then the FIFO of the accelerometer overflows
+        encode(3, 5000, rate, True, values[80:120]),
+        b'\x00\x01',
+    ]
+    samples, stats = decode(notifications)
+    assert stats == {'notifications': 3, 'lost_notifications': 1, 'overflows': 1, 'invalid': 1, 'samples': 120}, stats
+    assert [sample[1:] for sample in samples] == values
+    assert abs(samples[0][0] - 1000 / TICK_RATE) < 1e-9
+    assert abs(samples[39][0] - samples[0][0] - 39 / rate) < 1e-9
+    assert abs(samples[40][0] - samples[39][0] - 1 / rate) < 0.001
+    assert abs(samples[80][0] - 5000 / TICK_RATE) < 1e-9
+
+    # Sequence and time wrap around
+    samples, stats = decode([encode(0xffff, 0xffffff00, rate, False, values[:1]), encode(0, 0x10, rate, False, values[:1])])
+    assert stats['lost_notifications'] == 0
+    assert samples[1][0] > samples[0][0]
+    print('Self-test passed')
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Decode the motion stream of InfiniTime')
+    ap.add_argument('input', nargs='?', help='notifications, one per line in hexadecimal')
+    ap.add_argument('--csv', help='write the samples (time in s, X, Y, Z in g) to this file')
+    ap.add_argument('--self-test', action='store_true', help='check the decoder with generated notifications')
+    args = ap.parse_args()
+
+    if args.self_test:
+        self_test()
+        return
+    if args.input is None:
+        ap.error('input is required')
+
+    samples, stats = decode(read_notifications(args.input))
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(['time', 'x', 'y', 'z'])
+            for time, x, y, z in samples:
+                writer.writerow([f'{time:.4f}', x / ONE_G, y / ONE_G, z / ONE_G])
+
+    print(f'{stats["notifications"]} notifications, {stats["samples"]} samples')
+    if samples:
+        duration = samples[-1][0] - samples[0][0]
+        if duration > 0:
+            print(f'Duration: {duration:.2f}s, {(len(samples) - 1) / duration:.1f} samples/s')
+    print(f'Lost notifications: {stats["lost_notifications"]}')
+    print(f'FIFO overflows: {stats["overflows"]}')
+    if stats['invalid']:
+        print(f'Invalid notifications: {stats["invalid"]}', file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+# Plans the delta update of the resources installed on the watch (see src/components/fs/ResourceIndex.h and
+# doc/BLEFS.md), and estimates the number of bytes transferred over BLE compared to the upload of the whole package.
+# The resources installed on the watch are simulated by a previous resource package.
+
+import argparse
+import json
+import math
+import struct
+import sys
+import zlib
+from zipfile import ZipFile
+
+MANIFEST_HEADER = struct.Struct('<4sHH')
+MANIFEST_RECORD = struct.Struct('<IIIB')
+STAGED_SUFFIX = '.new'
+
+# BLE FS protocol overhead
+ATT_HEADER = 3
+WRITE_HEADER = 20
+WRITE_DATA_HEADER = 12
+LIST_RESOURCES_HEADER = 5
+RESOURCE_ENTRY = 13
+
+
+def read_manifest(data):
+    """Returns {path hash: (path, size, crc)}"""
+    magic, version, count = MANIFEST_HEADER.unpack_from(data)
+    if magic != b'RIDX' or version != 1:
+        sys.exit('Unsupported resource manifest')
+    records = {}
+    offset = MANIFEST_HEADER.size
+    for _ in range(count):
+        path_hash, size, crc, path_length = MANIFEST_RECORD.unpack_from(data, offset)
+        offset += MANIFEST_RECORD.size
+        records[path_hash] = (data[offset:offset + path_length].decode(), size, crc)
+        offset += path_length
+    return records
+
+
+def read_package(path):
+    """Returns the manifest and the content of the resources of a package, indexed by their path on the watch"""
+    with ZipFile(path) as zf:
+        names = {name.split('/')[-1]: name for name in zf.namelist()}
+        description = json.loads(zf.read(names['resources.json']))
+        files = {resource['path']: zf.read(names[resource['filename']]) for resource in description['resources']}
+    if '/resources.idx' not in files:
+        sys.exit(f'{path} does not contain a resource manifest')
+    return files.pop('/resources.idx'), files
+
+
+def write_cost(path, size, mtu):
+    chunk = mtu - ATT_HEADER - WRITE_DATA_HEADER
+    return WRITE_HEADER + len(path) + size + max(1, math.ceil(size / chunk)) * WRITE_DATA_HEADER
+
+
+def list_cost(count, mtu):
+    per_notification = max(1, (mtu - ATT_HEADER - LIST_RESOURCES_HEADER) // RESOURCE_ENTRY)
+    return 1 + max(1, math.ceil(count / per_notification)) * LIST_RESOURCES_HEADER + count * RESOURCE_ENTRY
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Plan the delta update of the resources of the watch')
+    ap.add_argument('package', help='new resource package (infinitime-resources-x.y.z.zip)')
+    ap.add_argument('--installed', help='resource package installed on the watch (nothing if not specified)')
+    ap.add_argument('--mtu', type=int, default=247, help='ATT MTU of the connection')
+    args = ap.parse_args()
+
+    manifest, files = read_package(args.package)
+    new = read_manifest(manifest)
+    installed = {}
+    if args.installed:
+        installed = read_manifest(read_package(args.installed)[0])
+
+    full = sum(write_cost(path, len(data), args.mtu) for path, data in files.items())
+    full += write_cost('/resources.idx', len(manifest), args.mtu)
+
+    delta = list_cost(len(installed), args.mtu)
+    for path_hash, (path, size, crc) in sorted(new.items(), key=lambda item: item[1][0]):
+        if zlib.crc32(files[path]) != crc:
+            sys.exit(f'{path} does not match the manifest')
+        if installed.get(path_hash) == (path, size, crc):
+            print(f'  keep    {path}')
+        else:
+            print(f'  upload  {path + STAGED_SUFFIX} ({size} bytes)')
+            delta += write_cost(path + STAGED_SUFFIX, size, args.mtu)
+    for path_hash, (path, _, _) in sorted(installed.items(), key=lambda item: item[1][0]):
+        if path_hash not in new:
+            print(f'  delete  {path} (on commit)')
+    delta += write_cost('/resources.idx' + STAGED_SUFFIX, len(manifest), args.mtu) + 1
+
+    print(f'Full upload:  {full} bytes')
+    print(f'Delta update: {delta} bytes ({100 * delta / full:.1f}%)')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+
+# Decodes the trace files written by InfiniTime (see src/logging/Trace.h and doc/TelemetryService.md)
+# and prints them as a timeline, or converts them to the Chrome trace format (chrome://tracing, ui.perfetto.dev).
+
+import argparse
+import json
+import os.path
+import re
+import struct
+import sys
+
+HEADER = struct.Struct('<4sBBHIII')
+RECORD = struct.Struct('<IIHHI')
+TICK_WRAP = 1 << 24
+CYCLES_WRAP = 1 << 32
+
+DEFAULT_EVENTS = os.path.join(os.path.dirname(__file__), '..', 'src', 'logging', 'Trace.h')
+
+
+def read_event_names(path):
+    """Reads the names of the events from the TraceEvents enum"""
+    with open(path) as f:
+        source = f.read()
+    enum = re.search(r'enum class TraceEvents[^{]*{(.*?)}', source, re.S)
+    if enum is None:
+        sys.exit('TraceEvents not found in ' + path)
+    return {int(value, 0): name for name, value in re.findall(r'(\w+)\s*=\s*(\w+)', enum.group(1))}
+
+
+def read_trace(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic, version, record_size, count, total, cycle_freq, tick_freq = HEADER.unpack_from(data)
+    if magic != b'ITRC' or version != 1 or record_size != RECORD.size:
+        sys.exit('Unsupported trace file ' + path)
+    records = [RECORD.unpack_from(data, HEADER.size + i * RECORD.size) for i in range(count)]
+    return records, total - count, cycle_freq, tick_freq
+
+
+def timestamps(records, cycle_freq, tick_freq):
+    """Returns the time of the records in seconds, relative to the first one.
+
+    The RTC tick gives the time with a resolution of ~1ms. The cycle counter is much more precise but stops while the
+    CPU sleeps: it is used only when it agrees with the tick, i.e. when the CPU did not sleep between 2 events.
+    """
+    times = []
+    ticks = 0
+    for i, (tick, cycles, _, _, _) in enumerate(records):
+        if i == 0:
+            times.append(0.0)
+            continue
+        prev_tick, prev_cycles = records[i - 1][0], records[i - 1][1]
+        ticks += (tick - prev_tick) % TICK_WRAP
+        coarse = ticks / tick_freq
+        fine = times[-1] + ((cycles - prev_cycles) % CYCLES_WRAP) / cycle_freq
+        times.append(fine if abs(fine - coarse) <= 2 / tick_freq else coarse)
+    return times
+
+
+def print_timeline(records, times, names):
+    previous = 0.0
+    for (_, _, event, arg0, arg1), time in zip(records, times):
+        name = names.get(event, 'Unknown({})'.format(event))
+        print('{:12.6f} s  {:+10.6f}  {:<20} {:6} {:10}'.format(time, time - previous, name, arg0, arg1))
+        previous = time
+
+
+def chrome_trace(records, times, names):
+    """Events named xxxStart/xxxEnd become durations, the other ones instants"""
+    events = []
+    for (_, _, event, arg0, arg1), time in zip(records, times):
+        name = names.get(event, 'Unknown({})'.format(event))
+        entry = {'ts': time * 1e6, 'pid': 0, 'tid': 0, 'args': {'arg0': arg0, 'arg1': arg1}}
+        if name.endswith('Start'):
+            entry.update(name=name[:-len('Start')], ph='B')
+        elif name.endswith('End'):
+            entry.update(name=name[:-len('End')], ph='E')
+        else:
+            entry.update(name=name, ph='i', s='t')
+        events.append(entry)
+    return {'traceEvents': events, 'displayTimeUnit': 'ms'}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode an InfiniTime trace file')
+    parser.add_argument('trace', help='trace file downloaded from the watch (/trace.bin)')
+    parser.add_argument('--events', default=DEFAULT_EVENTS, help='header that defines the TraceEvents enum')
+    parser.add_argument('--chrome', metavar='JSON', help='write the trace in the Chrome trace format')
+    args = parser.parse_args()
+
+    names = read_event_names(args.events)
+    records, dropped, cycle_freq, tick_freq = read_trace(args.trace)
+    times = timestamps(records, cycle_freq, tick_freq)
+
+    if args.chrome:
+        with open(args.chrome, 'w') as f:
+            json.dump(chrome_trace(records, times, names), f)
+    else:
+        print('{} records, {} older records overwritten'.format(len(records), dropped))
+        print_timeline(records, times, names)
+
+
+if __name__ == '__main__':
+    main()